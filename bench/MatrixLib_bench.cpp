@@ -0,0 +1,375 @@
+/**
+ * @file MatrixLib_bench.cpp
+ * @brief Self-contained benchmark suite for Matrix and Square_Matrix operations.
+ *
+ * Sweeps sizes and element types over multiplyByMatrix, multiplyAdd, taskGraph, transpose, gram, the
+ * element-wise operations, the reductions, determinant, multiplyStrassen, inverse and the packed
+ * symmetric and banded solves. Every case reports time per call, GFLOP/s, bytes moved (GB/s) and
+ * heap allocations per call, and all results are written as JSON so runs of successive versions
+ * can be diffed for regressions.
+ *
+ * Usage: MatrixLib_bench [--sizes 64,256,1024] [--types float,double] [--filter name]
+ *                        [--min-time seconds] [--out results.json]
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "MatrixLib.hpp"
+
+//Allocation counting: every global operator new in the process goes through these counters
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+namespace {
+std::atomic<long long> g_allocations{0};
+std::atomic<long long> g_allocated_bytes{0};
+}
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+struct Options {
+    std::vector<int> sizes = {64, 128, 256, 512, 1024};
+    std::vector<std::string> types = {"float", "double"};
+    std::string filter;
+    double min_time = 0.25;
+    std::string out = "MatrixLib_bench.json";
+};
+
+struct Result {
+    std::string op;
+    std::string type;
+    int n;
+    long long calls;
+    double seconds_per_call;
+    double flops_per_call;
+    double bytes_per_call;
+    double allocations_per_call;
+    double allocated_bytes_per_call;
+};
+
+volatile double g_sink = 0; //Keeps results observable so calls are not optimized away
+
+template <typename T>
+Matrix<T> randomMatrix(int rows, int cols, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    Matrix<T> mat(rows, cols);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            mat(r, c) = static_cast<T>(dist(rng));
+        }
+    }
+    return mat;
+}
+
+/**
+ * @brief Times fn after one warm-up call, repeating until min_time has elapsed.
+ */
+Result measure(const std::string& op, const std::string& type, int n, double flops, double bytes,
+               double min_time, const std::function<void()>& fn) {
+    using clock = std::chrono::steady_clock;
+    fn();
+    const long long alloc_before = g_allocations.load();
+    const long long bytes_before = g_allocated_bytes.load();
+    long long calls = 0;
+    const auto start = clock::now();
+    double elapsed = 0;
+    do {
+        fn();
+        calls++;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < min_time);
+    const double allocations = static_cast<double>(g_allocations.load() - alloc_before) / calls;
+    const double allocated = static_cast<double>(g_allocated_bytes.load() - bytes_before) / calls;
+    return {op, type, n, calls, elapsed / calls, flops, bytes, allocations, allocated};
+}
+
+template <typename T>
+void runType(const std::string& type, const Options& options, std::vector<Result>& results) {
+    auto wanted = [&](const std::string& op) {
+        return options.filter.empty() || op.find(options.filter) != std::string::npos;
+    };
+    auto report = [&](const Result& r) {
+        const double gflops = r.flops_per_call / r.seconds_per_call * 1e-9;
+        const double gbps = r.bytes_per_call / r.seconds_per_call * 1e-9;
+        std::printf("%-20s %-7s %6d %12.3f us %9.2f GFLOP/s %8.2f GB/s %8.1f allocs/call\n",
+                    r.op.c_str(), r.type.c_str(), r.n, r.seconds_per_call * 1e6, gflops, gbps, r.allocations_per_call);
+        std::fflush(stdout);
+        results.push_back(r);
+    };
+
+    for (int n : options.sizes) {
+        const double nn = static_cast<double>(n) * n;
+        const double elem = sizeof(T);
+        Matrix<T> a = randomMatrix<T>(n, n, 1);
+        Matrix<T> b = randomMatrix<T>(n, n, 2);
+
+        if (wanted("multiplyByMatrix")) {
+            report(measure("multiplyByMatrix", type, n, 2 * nn * n, 3 * nn * elem, options.min_time, [&] {
+                Matrix<T> c = a.multiplyByMatrix(b);
+                g_sink = g_sink + c(0, 0);
+            }));
+        }
+        if (wanted("multiplyAdd")) {
+            Matrix<T> c(n, n);
+            report(measure("multiplyAdd", type, n, 2 * nn * n, 3 * nn * elem, options.min_time, [&] {
+                c.multiplyAdd(static_cast<T>(1), a, matrixlib::Op::NoTrans, b, matrixlib::Op::NoTrans, static_cast<T>(0));
+                g_sink = g_sink + c(0, 0);
+            }));
+        }
+        if (wanted("taskGraph")) {
+            //Two independent products, one fused into an accumulating GEMM, joined by a fused chain
+            report(measure("taskGraph", type, n, 4 * nn * n + 3 * nn, 4 * nn * elem, options.min_time, [&] {
+                TaskGraph<T> graph;
+                auto ga = graph.input(a), gb = graph.input(b);
+                auto left = graph.add(graph.multiply(ga, gb), gb);
+                auto result = graph.output(graph.subtract(left, graph.scale(graph.multiply(gb, ga), static_cast<T>(0.5))));
+                graph.run();
+                g_sink = g_sink + result.get()(0, 0);
+            }));
+        }
+        if (wanted("transpose")) {
+            Matrix<T> t = a;
+            report(measure("transpose", type, n, 0, 2 * nn * elem, options.min_time, [&] {
+                t.transpose();
+                g_sink = g_sink + t(0, n - 1);
+            }));
+        }
+        if (wanted("gram")) {
+            report(measure("gram", type, n, nn * n, 2 * nn * elem, options.min_time, [&] {
+                Matrix<T> g = a.gram();
+                g_sink = g_sink + g(0, 0);
+            }));
+        }
+        if (wanted("addMatrix")) {
+            Matrix<T> c = a;
+            report(measure("addMatrix", type, n, nn, 3 * nn * elem, options.min_time, [&] {
+                c.addMatrix(b);
+                g_sink = g_sink + c(0, 0);
+            }));
+        }
+        if (wanted("subtractMatrix")) {
+            Matrix<T> c = a;
+            report(measure("subtractMatrix", type, n, nn, 3 * nn * elem, options.min_time, [&] {
+                c.subtractMatrix(b);
+                g_sink = g_sink + c(0, 0);
+            }));
+        }
+        if (wanted("addScaled")) {
+            Matrix<T> c = a;
+            report(measure("addScaled", type, n, 2 * nn, 3 * nn * elem, options.min_time, [&] {
+                c.addScaled(static_cast<T>(0), b);
+                g_sink = g_sink + c(0, 0);
+            }));
+        }
+        if (wanted("multiplyByConstant")) {
+            Matrix<T> c = a;
+            report(measure("multiplyByConstant", type, n, nn, 2 * nn * elem, options.min_time, [&] {
+                c.multiplyByConstant(static_cast<T>(1));
+                g_sink = g_sink + c(0, 0);
+            }));
+        }
+        if (wanted("divideByConstant")) {
+            Matrix<T> c = a;
+            report(measure("divideByConstant", type, n, nn, 2 * nn * elem, options.min_time, [&] {
+                c.divideByConstant(static_cast<T>(1));
+                g_sink = g_sink + c(0, 0);
+            }));
+        }
+        if (wanted("sum")) {
+            report(measure("sum", type, n, nn, nn * elem, options.min_time, [&] {
+                g_sink = g_sink + a.sum();
+            }));
+        }
+        if (wanted("frobeniusNorm")) {
+            report(measure("frobeniusNorm", type, n, 2 * nn, nn * elem, options.min_time, [&] {
+                g_sink = g_sink + a.frobeniusNorm();
+            }));
+        }
+        if (wanted("colSums")) {
+            report(measure("colSums", type, n, nn, nn * elem, options.min_time, [&] {
+                g_sink = g_sink + a.colSums()[0];
+            }));
+        }
+        if (wanted("expression")) {
+            Matrix<T> c(n, n);
+            report(measure("expression", type, n, 3 * nn, 3 * nn * elem, options.min_time, [&] {
+                c = a + b * static_cast<T>(2) - a;
+                g_sink = g_sink + c(0, 0);
+            }));
+        }
+
+        //Make the square operand diagonally dominant so it is well conditioned at every size
+        Square_Matrix<T> sq(a);
+        for (int i = 0; i < n; i++) {
+            sq(i, i) += static_cast<T>(n);
+        }
+        if (wanted("determinant")) {
+            report(measure("determinant", type, n, 2.0 / 3.0 * nn * n, nn * elem, options.min_time, [&] {
+                g_sink = g_sink + static_cast<double>(sq.determinant());
+            }));
+        }
+        if (wanted("multiplyStrassen")) {
+            Square_Matrix<T> sb(b);
+            //Reported against the classical 2n^3 count so GFLOP/s compares directly with GEMM
+            report(measure("multiplyStrassen", type, n, 2 * nn * n, 3 * nn * elem, options.min_time, [&] {
+                Square_Matrix<T> c = sq.multiplyStrassen(sb);
+                g_sink = g_sink + c(0, 0);
+            }));
+        }
+        if (wanted("inverse")) {
+            report(measure("inverse", type, n, 2 * nn * n, 2 * nn * elem, options.min_time, [&] {
+                Square_Matrix<T> inv = sq.inverse();
+                g_sink = g_sink + inv(0, 0);
+            }));
+        }
+        if (wanted("symmetricSolve")) {
+            //The lower triangle of sq with its shifted diagonal is positive definite
+            SymmetricMatrix<T> sym(sq);
+            std::vector<T> rhs(n, static_cast<T>(1));
+            report(measure("symmetricSolve", type, n, nn * n / 3.0 + 2 * nn, nn / 2 * elem, options.min_time, [&] {
+                std::vector<T> x = sym.solve(rhs);
+                g_sink = g_sink + x[0];
+            }));
+        }
+        if (wanted("bandedSolve")) {
+            constexpr int bandwidth = 8;
+            BandedMatrix<T> band(sq, bandwidth, bandwidth);
+            std::vector<T> rhs(n, static_cast<T>(1));
+            const double band_flops = 2.0 * n * bandwidth * (2 * bandwidth + 1);
+            report(measure("bandedSolve", type, n, band_flops, 2.0 * n * (3 * bandwidth + 1) * elem, options.min_time, [&] {
+                std::vector<T> x = band.solve(rhs);
+                g_sink = g_sink + x[0];
+            }));
+        }
+    }
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--sizes" && has_value) {
+            options.sizes.clear();
+            for (const std::string& s : splitList(argv[++i])) {
+                options.sizes.push_back(std::stoi(s));
+            }
+        } else if (arg == "--types" && has_value) {
+            options.types = splitList(argv[++i]);
+        } else if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time" && has_value) {
+            options.min_time = std::stod(argv[++i]);
+        } else if (arg == "--out" && has_value) {
+            options.out = argv[++i];
+        } else {
+            throw std::invalid_argument("Unknown argument: " + arg + "\n");
+        }
+    }
+    return options;
+}
+
+void writeJson(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open " + path + " for writing.\n");
+    }
+    out << "{\n";
+    out << "  \"library\": \"MatrixLib\",\n";
+    out << "  \"threads\": " << matrixlib::ThreadPool::instance().size() << ",\n";
+    out << "  \"gemm_kernel_float\": \"" << matrixlib::gemmKernelName<float>() << "\",\n";
+    out << "  \"gemm_kernel_double\": \"" << matrixlib::gemmKernelName<double>() << "\",\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        out << "    {\"op\": \"" << r.op << "\", \"type\": \"" << r.type << "\", \"n\": " << r.n
+            << ", \"calls\": " << r.calls
+            << ", \"seconds_per_call\": " << r.seconds_per_call
+            << ", \"gflops\": " << r.flops_per_call / r.seconds_per_call * 1e-9
+            << ", \"bytes_per_call\": " << r.bytes_per_call
+            << ", \"gbytes_per_second\": " << r.bytes_per_call / r.seconds_per_call * 1e-9
+            << ", \"allocations_per_call\": " << r.allocations_per_call
+            << ", \"allocated_bytes_per_call\": " << r.allocated_bytes_per_call << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parseOptions(argc, argv);
+        std::vector<Result> results;
+        std::printf("MatrixLib bench: %d threads, GEMM kernel %s (double), %s (float)\n",
+                    matrixlib::ThreadPool::instance().size(),
+                    matrixlib::gemmKernelName<double>(), matrixlib::gemmKernelName<float>());
+        for (const std::string& type : options.types) {
+            if (type == "float") {
+                runType<float>(type, options, results);
+            } else if (type == "double") {
+                runType<double>(type, options, results);
+            } else {
+                throw std::invalid_argument("Unsupported type: " + type + "\n");
+            }
+        }
+        writeJson(options.out, results);
+        std::printf("Results written to %s\n", options.out.c_str());
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what();
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <limits>
+#include "Instrumentation.hpp"
+
+/**
+ * @class AlignedAllocator
+ * @brief Standard-conforming allocator returning storage aligned to a fixed boundary.
+ * Used as the default storage allocator of Matrix so that every buffer starts on a cache line.
+ * @tparam T Element type.
+ * @tparam Alignment Required alignment in bytes (power of two, defaults to 64).
+ * @note Example: std::vector<double, AlignedAllocator<double>> buf(1024);
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T).");
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    /**
+     * @brief Allocates uninitialized storage for n objects of type T.
+     * @param n Number of objects.
+     * @return Pointer aligned to Alignment bytes.
+     * @throws std::bad_array_new_length if n is too large, std::bad_alloc on failure.
+     */
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        MATRIXLIB_RECORD_ALLOCATION(n * sizeof(T));
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    /**
+     * @brief Releases storage obtained from allocate().
+     * @param p Pointer returned by allocate().
+     * @param n Number of objects passed to allocate().
+     */
+    void deallocate(T* p, std::size_t n) noexcept {
+        ::operator delete(p, n * sizeof(T), std::align_val_t{Alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+};
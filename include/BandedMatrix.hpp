@@ -0,0 +1,348 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "Matrix.hpp"
+#include "SquareMatrix.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @class BandedMatrix
+ * @brief An n x n band matrix with kl diagonals below and ku above the main one, stored in
+ * n * (kl + ku + 1) elements.
+ * Row i keeps columns i - kl .. i + ku side by side (slots falling outside the matrix stay
+ * zero), so element (i, j) lives at i * (kl + ku) + j + kl and a column of the band is a strided
+ * walk. Products cost O(n * (kl + ku + 1) * k). Solves and the determinant use an LU
+ * factorization with partial pivoting that stays inside a band of width 2 * kl + ku + 1, for
+ * O(n * kl * (kl + ku)) work instead of O(n^3): a tridiagonal system is solved in O(n).
+ * @note Example:
+ * BandedMatrix<double> stencil(n, 1, 1); // tridiagonal
+ * std::vector<double> u = stencil.solve(f);
+ */
+template <typename T>
+class BandedMatrix
+{
+private:
+    int m_n;
+    int m_kl;
+    int m_ku;
+    std::vector<T> m_data;
+
+    /**
+     * @brief Band storage for the LU factors: U gets kl extra diagonals of fill-in from row swaps.
+     * Element (i, j) lives at i * (2 * kl + ku) + j + kl; L keeps its multipliers below the
+     * diagonal, in the order the row swaps left them.
+     */
+    struct Factors {
+        std::vector<T> lu;
+        std::vector<int> pivots;
+        bool singular = false;
+        bool negate = false;
+    };
+
+    static std::size_t bandIndex(int i, int j, int kl, int width) {
+        return static_cast<std::size_t>(i) * (width - 1) + j + kl;
+    }
+
+    T at(int i, int j) const { return m_data[bandIndex(i, j, m_kl, m_kl + m_ku + 1)]; }
+    T& at(int i, int j) { return m_data[bandIndex(i, j, m_kl, m_kl + m_ku + 1)]; }
+
+    bool inBand(int r, int c) const { return c - r <= m_ku && r - c <= m_kl; }
+
+    /**
+     * @brief LU factorization with partial pivoting; pivots are searched among the kl rows
+     * below the diagonal, the only ones with a nonzero in the column.
+     */
+    Factors factor() const {
+        const int n = m_n;
+        const int kl = m_kl;
+        const int reach = m_kl + m_ku; //Rightmost column of U in row c is c + reach
+        const int width = 2 * kl + m_ku + 1;
+        Factors f;
+        f.lu.assign(static_cast<std::size_t>(n) * width, T{});
+        f.pivots.resize(n);
+        const auto lu = [&](int i, int j) -> T& { return f.lu[bandIndex(i, j, kl, width)]; };
+        for (int i = 0; i < n; i++) {
+            for (int j = std::max(0, i - kl); j <= std::min(n - 1, i + m_ku); j++) {
+                lu(i, j) = at(i, j);
+            }
+        }
+        for (int c = 0; c < n; c++) {
+            const int last_row = std::min(n - 1, c + kl);
+            const int last_col = std::min(n - 1, c + reach);
+            int pivot = c;
+            for (int r = c + 1; r <= last_row; r++) {
+                if (std::abs(lu(r, c)) > std::abs(lu(pivot, c))) {
+                    pivot = r;
+                }
+            }
+            f.pivots[c] = pivot;
+            if (lu(pivot, c) == T{}) {
+                f.singular = true;
+                continue;
+            }
+            if (pivot != c) {
+                for (int j = c; j <= last_col; j++) {
+                    std::swap(lu(c, j), lu(pivot, j));
+                }
+                f.negate = !f.negate;
+            }
+            const T diag = lu(c, c);
+            for (int r = c + 1; r <= last_row; r++) {
+                const T l = lu(r, c) / diag;
+                lu(r, c) = l;
+                if (l == T{}) {
+                    continue;
+                }
+                for (int j = c + 1; j <= last_col; j++) {
+                    lu(r, j) -= l * lu(c, j);
+                }
+            }
+        }
+        return f;
+    }
+
+    /**
+     * @brief Applies the factors to B (n x k, row stride ldb), overwriting it with the solution.
+     */
+    void solveFactored(const Factors& f, int k, T* b, std::ptrdiff_t ldb) const {
+        const int n = m_n;
+        const int kl = m_kl;
+        const int reach = m_kl + m_ku;
+        const int width = 2 * kl + m_ku + 1;
+        const auto lu = [&](int i, int j) { return f.lu[bandIndex(i, j, kl, width)]; };
+        //L, with the row swaps interleaved in the order the factorization made them
+        for (int c = 0; c < n; c++) {
+            T* bc = b + c * ldb;
+            if (f.pivots[c] != c) {
+                std::swap_ranges(bc, bc + k, b + f.pivots[c] * ldb);
+            }
+            for (int r = c + 1; r <= std::min(n - 1, c + kl); r++) {
+                const T l = lu(r, c);
+                T* br = b + r * ldb;
+                for (int j = 0; j < k; j++) {
+                    br[j] -= l * bc[j];
+                }
+            }
+        }
+        for (int i = n - 1; i >= 0; i--) {
+            T* bi = b + i * ldb;
+            for (int p = i + 1; p <= std::min(n - 1, i + reach); p++) {
+                const T u = lu(i, p);
+                const T* bp = b + p * ldb;
+                for (int j = 0; j < k; j++) {
+                    bi[j] -= u * bp[j];
+                }
+            }
+            const T diag = lu(i, i);
+            for (int j = 0; j < k; j++) {
+                bi[j] /= diag;
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an all-zero n x n band matrix.
+     * @param n Dimension.
+     * @param kl Number of diagonals below the main one.
+     * @param ku Number of diagonals above the main one.
+     * @throws std::invalid_argument if n is not positive or a bandwidth is negative.
+     * @note Example: BandedMatrix<double> tridiagonal(1000, 1, 1);
+     */
+    BandedMatrix(int n, int kl, int ku) : m_n(n), m_kl(kl), m_ku(ku) {
+        if (n <= 0) {
+            throw std::invalid_argument("Size must be positive.\n");
+        }
+        if (kl < 0 || ku < 0) {
+            throw std::invalid_argument("Bandwidths must not be negative.\n");
+        }
+        //Bandwidths beyond the matrix would only store zeros
+        m_kl = std::min(kl, n - 1);
+        m_ku = std::min(ku, n - 1);
+        m_data.assign(static_cast<std::size_t>(n) * (m_kl + m_ku + 1), T{});
+    }
+
+    /**
+     * @brief Copies the band of a dense square matrix; elements outside it are not read.
+     * @throws std::invalid_argument if rows != columns or a bandwidth is negative.
+     * @note Example: BandedMatrix<double> b(dense, 2, 2);
+     */
+    template <typename Alloc>
+    BandedMatrix(const Matrix<T, Alloc>& dense, int kl, int ku) : BandedMatrix(dense.getRows(), kl, ku) {
+        if (dense.getRows() != dense.getCols()) {
+            throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
+        }
+        for (int i = 0; i < m_n; i++) {
+            for (int j = std::max(0, i - m_kl); j <= std::min(m_n - 1, i + m_ku); j++) {
+                at(i, j) = dense(i, j);
+            }
+        }
+    }
+
+    int getRows() const { return m_n; }
+    int getCols() const { return m_n; }
+    int lowerBandwidth() const { return m_kl; }
+    int upperBandwidth() const { return m_ku; }
+
+    /**
+     * @brief Band storage, kl + ku + 1 elements per row.
+     */
+    const std::vector<T>& data() const { return m_data; }
+
+    /**
+     * @brief Retrieves a single element (zero outside the band).
+     * @throws std::invalid_argument if indices are out of bounds.
+     * @note Example: double v = b.getValue(4, 5);
+     */
+    T getValue(int r, int c) const {
+        if (r < 0 || r >= m_n || c < 0 || c >= m_n) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        return inBand(r, c) ? at(r, c) : T{};
+    }
+
+    /**
+     * @brief Sets an element inside the band.
+     * @throws std::invalid_argument if indices are out of bounds or outside the band.
+     * @note Example: b.setValue(4, 5, -1.0);
+     */
+    void setValue(int r, int c, T value) {
+        if (r < 0 || r >= m_n || c < 0 || c >= m_n) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        if (!inBand(r, c)) {
+            throw std::invalid_argument("Element is outside the band.\n");
+        }
+        at(r, c) = value;
+    }
+
+    /**
+     * @brief Expands to a dense Square_Matrix with zeros outside the band.
+     * @note Example: Square_Matrix<double> d = b.toDense();
+     */
+    Square_Matrix<T> toDense() const {
+        Square_Matrix<T> dense(m_n);
+        for (int i = 0; i < m_n; i++) {
+            for (int j = std::max(0, i - m_kl); j <= std::min(m_n - 1, i + m_ku); j++) {
+                dense(i, j) = at(i, j);
+            }
+        }
+        return dense;
+    }
+
+    /**
+     * @brief Band matrix times dense matrix; each output row combines at most kl + ku + 1 rows
+     * of b. Rows run in parallel.
+     * @throws std::invalid_argument if b does not have n rows.
+     * @note Example: Matrix<double> c = band.multiply(dense);
+     */
+    template <typename Alloc>
+    Matrix<T, Alloc> multiply(const Matrix<T, Alloc>& b) const {
+        if (b.getRows() != m_n) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        const int k = b.getCols();
+        Matrix<T, Alloc> c(m_n, k);
+        matrixlib::parallelRows(m_n, static_cast<long long>(m_n) * (m_kl + m_ku + 1) * k, [&](int row_begin, int row_end) {
+            for (int i = row_begin; i < row_end; i++) {
+                T* ci = c.rowData(i);
+                for (int p = std::max(0, i - m_kl); p <= std::min(m_n - 1, i + m_ku); p++) {
+                    const T a = at(i, p);
+                    const T* bp = b.rowData(p);
+                    for (int j = 0; j < k; j++) {
+                        ci[j] += a * bp[j];
+                    }
+                }
+            }
+        });
+        return c;
+    }
+
+    /**
+     * @brief Band matrix times vector.
+     * @throws std::invalid_argument if x.size() != n.
+     * @note Example: std::vector<double> y = band.multiply(x);
+     */
+    std::vector<T> multiply(const std::vector<T>& x) const {
+        if (static_cast<int>(x.size()) != m_n) {
+            throw std::invalid_argument("Vector length must be equal to the number of columns.\n");
+        }
+        std::vector<T> y(m_n);
+        matrixlib::parallelRows(m_n, static_cast<long long>(m_n) * (m_kl + m_ku + 1), [&](int row_begin, int row_end) {
+            for (int i = row_begin; i < row_end; i++) {
+                T sum{};
+                for (int p = std::max(0, i - m_kl); p <= std::min(m_n - 1, i + m_ku); p++) {
+                    sum += at(i, p) * x[p];
+                }
+                y[i] = sum;
+            }
+        });
+        return y;
+    }
+
+    /**
+     * @brief Calculates the determinant from the banded LU factorization.
+     * @note Example: double det = band.determinant();
+     */
+    T determinant() const
+        requires std::is_floating_point_v<T>
+    {
+        const Factors f = factor();
+        if (f.singular) {
+            return T{};
+        }
+        const int width = 2 * m_kl + m_ku + 1;
+        T det = f.negate ? static_cast<T>(-1) : static_cast<T>(1);
+        for (int i = 0; i < m_n; i++) {
+            det *= f.lu[bandIndex(i, i, m_kl, width)];
+        }
+        return det;
+    }
+
+    /**
+     * @brief Solves A * X = B for all columns of B with the banded LU factorization.
+     * @param b Right-hand sides (n x k).
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if sizes do not match or the matrix is singular.
+     * @note Example: Matrix<double> x = band.solve(b);
+     */
+    template <typename Alloc>
+        requires std::is_floating_point_v<T>
+    Matrix<T, Alloc> solve(const Matrix<T, Alloc>& b) const {
+        if (b.getRows() != m_n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        const Factors f = factor();
+        if (f.singular) {
+            throw std::invalid_argument("Cannot solve: matrix is singular.\n");
+        }
+        Matrix<T, Alloc> x(b);
+        solveFactored(f, x.getCols(), x.rowData(0), x.getStride());
+        return x;
+    }
+
+    /**
+     * @brief Solves A * x = b for a single right-hand side vector.
+     * @throws std::invalid_argument if sizes do not match or the matrix is singular.
+     * @note Example: std::vector<double> u = stencil.solve(f);
+     */
+    std::vector<T> solve(const std::vector<T>& b) const
+        requires std::is_floating_point_v<T>
+    {
+        if (static_cast<int>(b.size()) != m_n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        const Factors f = factor();
+        if (f.singular) {
+            throw std::invalid_argument("Cannot solve: matrix is singular.\n");
+        }
+        std::vector<T> x(b);
+        solveFactored(f, 1, x.data(), 1);
+        return x;
+    }
+};
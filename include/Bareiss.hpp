@@ -0,0 +1,431 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "ScratchArena.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @file Bareiss.hpp
+ * @brief Exact determinants and linear solves for integer matrices in O(n^3).
+ *
+ * Bareiss' fraction-free elimination keeps every intermediate an integer (each one is a minor
+ * of the input), dividing exactly by the previous pivot at every step. Products are formed in
+ * 128 bits and each quotient must fit in 64 bits. When one does not, the computation is repeated
+ * modulo enough 31-bit primes to cover Hadamard's bound on the result, the primes running in
+ * parallel, and the result is reconstructed with the Chinese remainder theorem (Garner's mixed
+ * radix form). Reconstruction also tells whether the final value fits in 64 bits, so large
+ * intermediates never cause a wrong answer: the result is either exact or std::overflow_error.
+ * A solve returns integer numerators N and the denominator det(A), with X = N / det(A).
+ */
+namespace matrixlib {
+
+namespace detail {
+
+using wide_int = __int128;
+
+inline constexpr int crt_min_primes = 4;
+
+/**
+ * @brief Deterministic Miller-Rabin test, exact for every n below 2^32.
+ */
+inline bool isPrime32(std::uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (std::uint64_t p : {2u, 3u, 5u, 7u}) {
+        if (n % p == 0) {
+            return n == p;
+        }
+    }
+    std::uint64_t d = n - 1;
+    int s = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        s++;
+    }
+    for (std::uint64_t base : {2u, 7u, 61u}) {
+        if (base % n == 0) {
+            continue;
+        }
+        std::uint64_t x = 1;
+        std::uint64_t b = base % n;
+        for (std::uint64_t e = d; e > 0; e >>= 1) {
+            if (e & 1) {
+                x = x * b % n;
+            }
+            b = b * b % n;
+        }
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        bool composite = true;
+        for (int i = 1; i < s && composite; i++) {
+            x = x * x % n;
+            composite = x != n - 1;
+        }
+        if (composite) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief The count largest primes below 2^31, found once and shared by all threads.
+ */
+inline std::vector<std::uint64_t> crtPrimes(std::size_t count) {
+    static std::mutex mutex;
+    static std::vector<std::uint64_t> primes;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::uint64_t candidate = primes.empty() ? (std::uint64_t{1} << 31) - 1 : primes.back() - 2;
+    while (primes.size() < count) {
+        if (isPrime32(candidate)) {
+            primes.push_back(candidate);
+        }
+        candidate -= 2;
+    }
+    return std::vector<std::uint64_t>(primes.begin(), primes.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+inline std::uint64_t powMod(std::uint64_t b, std::uint64_t e, std::uint64_t p) {
+    std::uint64_t x = 1;
+    for (b %= p; e > 0; e >>= 1) {
+        if (e & 1) {
+            x = x * b % p;
+        }
+        b = b * b % p;
+    }
+    return x;
+}
+
+template <typename T>
+std::uint64_t reduceMod(T value, std::uint64_t p) {
+    if constexpr (std::is_signed_v<T>) {
+        const long long r = static_cast<long long>(value) % static_cast<long long>(p);
+        return static_cast<std::uint64_t>(r < 0 ? r + static_cast<long long>(p) : r);
+    } else {
+        return static_cast<std::uint64_t>(value) % p;
+    }
+}
+
+/**
+ * @brief Eliminates the n x (n + k) matrix m (row stride ld, entries in [0, p)) modulo p.
+ * @return det of the leading n x n block modulo p. When it is nonzero and k > 0, the last k
+ * columns of rows 0..n-1 are left holding det * A^-1 * B modulo p.
+ */
+inline std::uint64_t eliminateMod(int n, int k, std::uint64_t* m, std::ptrdiff_t ld, std::uint64_t p) {
+    const int width = n + k;
+    std::uint64_t det = 1;
+    for (int c = 0; c < n; c++) {
+        int pivot = c;
+        while (pivot < n && m[pivot * ld + c] == 0) {
+            pivot++;
+        }
+        if (pivot == n) {
+            return 0;
+        }
+        if (pivot != c) {
+            std::swap_ranges(m + pivot * ld, m + pivot * ld + width, m + c * ld);
+            det = (p - det) % p;
+        }
+        std::uint64_t* row_c = m + c * ld;
+        det = det * row_c[c] % p;
+        const std::uint64_t inverse = powMod(row_c[c], p - 2, p);
+        for (int j = c; j < width; j++) {
+            row_c[j] = row_c[j] * inverse % p;
+        }
+        //Gauss-Jordan: clear column c above and below, so the left block ends as the identity
+        for (int i = 0; i < n; i++) {
+            std::uint64_t* row_i = m + i * ld;
+            const std::uint64_t factor = row_i[c];
+            if (i == c || factor == 0) {
+                continue;
+            }
+            for (int j = c; j < width; j++) {
+                row_i[j] = (row_i[j] + (p - factor) * row_c[j]) % p;
+            }
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        std::uint64_t* row_i = m + i * ld;
+        for (int j = n; j < width; j++) {
+            row_i[j] = row_i[j] * det % p;
+        }
+    }
+    return det;
+}
+
+/**
+ * @brief Turns residues modulo primes[0..count) into a signed 64-bit value.
+ * Needs |value| < (product of the primes) / 2.
+ * @param residues count residues, residue i being taken at stride.
+ * @param digits Workspace for count values.
+ * @param value Receives the result.
+ * @return false if the value does not fit in 64 bits.
+ */
+inline bool reconstructCRT(const std::uint64_t* residues, std::ptrdiff_t stride, const std::vector<std::uint64_t>& primes,
+                           const std::vector<std::uint64_t>& inverses, std::uint64_t* digits, long long& value) {
+    const int count = static_cast<int>(primes.size());
+    //Mixed radix digits: x = d0 + d1 * p0 + d2 * p0 * p1 + ...
+    for (int i = 0; i < count; i++) {
+        const std::uint64_t p = primes[i];
+        std::uint64_t partial = 0;
+        for (int j = i - 1; j >= 0; j--) {
+            partial = (partial * (primes[j] % p) + digits[j]) % p;
+        }
+        digits[i] = (residues[i * stride] + p - partial) * inverses[i] % p;
+    }
+    //Non-negative values have only low digits; negative ones are M - |x| and have only maximal
+    //high digits, i.e. the complement M - 1 - x = |x| - 1 has only low digits
+    bool positive = true;
+    bool negative = true;
+    for (int i = 3; i < count; i++) {
+        positive = positive && digits[i] == 0;
+        negative = negative && digits[i] == primes[i] - 1;
+    }
+    if (!positive && !negative) {
+        return false;
+    }
+    wide_int low = 0;
+    for (int i = 2; i >= 0; i--) {
+        const std::uint64_t d = positive ? digits[i] : primes[i] - 1 - digits[i];
+        low = low * static_cast<wide_int>(primes[i]) + static_cast<wide_int>(d);
+    }
+    const wide_int result = positive ? low : -(low + 1);
+    if (result > std::numeric_limits<long long>::max() || result < std::numeric_limits<long long>::min()) {
+        return false;
+    }
+    value = static_cast<long long>(result);
+    return true;
+}
+
+/**
+ * @brief Exact result of an integer elimination: det(A) and, for a solve, N = det(A) * A^-1 * B.
+ */
+struct ExactSolution {
+    long long det = 0;
+    std::vector<long long> numerators; //n x k, row-major
+};
+
+/**
+ * @brief Fraction-free elimination in 64-bit integers with 128-bit products.
+ * @return false if an intermediate or the result does not fit in 64 bits.
+ */
+template <typename T>
+bool bareiss(int n, int k, const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb, ExactSolution& out) {
+    const int width = n + k;
+    ScratchScope scope;
+    long long* m = scope.allocate<long long>(static_cast<std::size_t>(n) * width);
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < width; c++) {
+            const T value = c < n ? a[r * lda + c] : b[r * ldb + (c - n)];
+            if constexpr (std::is_unsigned_v<T> && sizeof(T) >= sizeof(long long)) {
+                if (value > static_cast<T>(std::numeric_limits<long long>::max())) {
+                    return false;
+                }
+            }
+            m[r * width + c] = static_cast<long long>(value);
+        }
+    }
+    constexpr wide_int lo = std::numeric_limits<long long>::min();
+    constexpr wide_int hi = std::numeric_limits<long long>::max();
+    bool negate = false;
+    long long previous = 1;
+    for (int c = 0; c < n; c++) {
+        int pivot = c;
+        while (pivot < n && m[pivot * width + c] == 0) {
+            pivot++;
+        }
+        if (pivot == n) {
+            out.det = 0;
+            out.numerators.assign(static_cast<std::size_t>(n) * k, 0);
+            return true;
+        }
+        if (pivot != c) {
+            std::swap_ranges(m + pivot * width, m + pivot * width + width, m + c * width);
+            negate = !negate;
+        }
+        const long long* row_c = m + c * width;
+        const wide_int diagonal = row_c[c];
+        for (int i = c + 1; i < n; i++) {
+            long long* row_i = m + i * width;
+            const wide_int factor = row_i[c];
+            for (int j = c + 1; j < width; j++) {
+                wide_int left, right, difference;
+                if (__builtin_mul_overflow(diagonal, static_cast<wide_int>(row_i[j]), &left) ||
+                    __builtin_mul_overflow(factor, static_cast<wide_int>(row_c[j]), &right) ||
+                    __builtin_sub_overflow(left, right, &difference)) {
+                    return false;
+                }
+                //Exact by Sylvester's identity
+                const wide_int quotient = difference / previous;
+                if (quotient < lo || quotient > hi) {
+                    return false;
+                }
+                row_i[j] = static_cast<long long>(quotient);
+            }
+            row_i[c] = 0;
+        }
+        previous = row_c[c];
+    }
+    //The last pivot is det(P * A); back substitution keeps numerators over that denominator
+    const long long d = m[(n - 1) * width + (n - 1)];
+    if (negate && d == std::numeric_limits<long long>::min()) {
+        return false;
+    }
+    out.det = negate ? -d : d;
+    out.numerators.assign(static_cast<std::size_t>(n) * k, 0);
+    for (int col = 0; col < k; col++) {
+        for (int i = n - 1; i >= 0; i--) {
+            const long long* row_i = m + i * width;
+            wide_int sum;
+            if (__builtin_mul_overflow(static_cast<wide_int>(d), static_cast<wide_int>(row_i[n + col]), &sum)) {
+                return false;
+            }
+            for (int j = i + 1; j < n; j++) {
+                wide_int term;
+                if (__builtin_mul_overflow(static_cast<wide_int>(row_i[j]), static_cast<wide_int>(out.numerators[j * k + col]), &term) ||
+                    __builtin_sub_overflow(sum, term, &sum)) {
+                    return false;
+                }
+            }
+            //det(P * A) * x_i is an integer (Cramer's rule), so the division is exact
+            const wide_int x = sum / row_i[i];
+            if (x < lo || x > hi || (negate && x == lo)) {
+                return false;
+            }
+            out.numerators[i * k + col] = static_cast<long long>(x);
+        }
+    }
+    if (negate) {
+        for (long long& x : out.numerators) {
+            x = -x;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Multi-modular elimination, used when bareiss() overflows.
+ * @throws std::overflow_error if det(A) or a numerator does not fit in 64 bits.
+ */
+template <typename T>
+void multiModular(int n, int k, const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb, ExactSolution& out) {
+    const int width = n + k;
+    //Hadamard: |det| <= prod of row norms, and replacing a column of A by a column of B gives a
+    //matrix whose rows are no longer than the rows of [A | B]
+    long double log2_bound = 0;
+    for (int r = 0; r < n; r++) {
+        long double norm = 0;
+        for (int c = 0; c < width; c++) {
+            const long double value = static_cast<long double>(c < n ? a[r * lda + c] : b[r * ldb + (c - n)]);
+            norm += value * value;
+        }
+        log2_bound += 0.5L * std::log2(std::max(norm, 1.0L));
+    }
+    //One bit for the sign, a few for rounding, 31 bits per prime
+    const std::size_t needed = std::max<std::size_t>(crt_min_primes, static_cast<std::size_t>(log2_bound / 30.0L) + 2);
+
+    ThreadPool& pool = ThreadPool::instance();
+    std::vector<std::uint64_t> primes;
+    std::vector<std::uint64_t> residues; //Per prime: det, then the n x k numerators
+    const std::size_t per_prime = 1 + static_cast<std::size_t>(n) * k;
+    std::size_t tried = 0;
+    long double unlucky_bits = 0;
+    while (primes.size() < needed) {
+        const std::vector<std::uint64_t> batch_primes = [&] {
+            std::vector<std::uint64_t> all = crtPrimes(tried + (needed - primes.size()));
+            return std::vector<std::uint64_t>(all.begin() + static_cast<std::ptrdiff_t>(tried), all.end());
+        }();
+        const int batch = static_cast<int>(batch_primes.size());
+        tried += batch_primes.size();
+        std::vector<std::uint64_t> batch_residues(batch_primes.size() * per_prime);
+        pool.parallelFor(batch, [&](int i) {
+            const std::uint64_t p = batch_primes[i];
+            ScratchScope scope;
+            std::uint64_t* m = scope.allocate<std::uint64_t>(static_cast<std::size_t>(n) * width);
+            for (int r = 0; r < n; r++) {
+                for (int c = 0; c < width; c++) {
+                    m[r * width + c] = c < n ? reduceMod(a[r * lda + c], p) : reduceMod(b[r * ldb + (c - n)], p);
+                }
+            }
+            std::uint64_t* res = batch_residues.data() + static_cast<std::size_t>(i) * per_prime;
+            res[0] = eliminateMod(n, k, m, width, p);
+            for (int r = 0; r < n; r++) {
+                for (int c = 0; c < k; c++) {
+                    res[1 + r * k + c] = m[r * width + n + c];
+                }
+            }
+        });
+        //A prime dividing det(A) gives no numerators, so a solve skips it and takes another.
+        //Once the skipped primes multiply past the bound on |det(A)|, det(A) must be 0
+        for (int i = 0; i < batch; i++) {
+            const std::uint64_t* res = batch_residues.data() + static_cast<std::size_t>(i) * per_prime;
+            if (k == 0 || res[0] != 0) {
+                primes.push_back(batch_primes[i]);
+                residues.insert(residues.end(), res, res + per_prime);
+            } else {
+                unlucky_bits += std::log2(static_cast<long double>(batch_primes[i]));
+            }
+        }
+        if (unlucky_bits > log2_bound + 1) {
+            out.det = 0;
+            out.numerators.assign(static_cast<std::size_t>(n) * k, 0);
+            return;
+        }
+    }
+
+    //inverses[i] = (p0 * ... * p_{i-1})^-1 mod p_i
+    std::vector<std::uint64_t> inverses(primes.size());
+    for (std::size_t i = 0; i < primes.size(); i++) {
+        std::uint64_t product = 1;
+        for (std::size_t j = 0; j < i; j++) {
+            product = product * (primes[j] % primes[i]) % primes[i];
+        }
+        inverses[i] = powMod(product, primes[i] - 2, primes[i]);
+    }
+    std::vector<std::uint64_t> digits(primes.size());
+    const auto reconstruct = [&](std::size_t index, long long& value) {
+        if (!reconstructCRT(residues.data() + index, static_cast<std::ptrdiff_t>(per_prime), primes, inverses, digits.data(), value)) {
+            throw std::overflow_error("Exact result does not fit in 64 bits.\n");
+        }
+    };
+    reconstruct(0, out.det);
+    out.numerators.assign(static_cast<std::size_t>(n) * k, 0);
+    if (k > 0 && out.det != 0) {
+        for (std::size_t i = 0; i < out.numerators.size(); i++) {
+            reconstruct(1 + i, out.numerators[i]);
+        }
+    }
+}
+
+/**
+ * @brief Exact det(A) and N = det(A) * A^-1 * B for integer A (n x n) and B (n x k).
+ * Tries Bareiss in 64-bit integers first, and falls back to multi-modular arithmetic when that
+ * overflows. When det(A) is 0 the numerators are left at zero.
+ * @throws std::overflow_error if det(A) or a numerator does not fit in 64 bits.
+ */
+template <typename T>
+ExactSolution exactSolve(int n, int k, const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb) {
+    ExactSolution out;
+    if (n == 0) {
+        out.det = 1;
+        return out;
+    }
+    if (!bareiss(n, k, a, lda, b, ldb, out)) {
+        out = ExactSolution{};
+        multiModular(n, k, a, lda, b, ldb, out);
+    }
+    return out;
+}
+
+} // namespace detail
+
+} // namespace matrixlib
@@ -0,0 +1,167 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * @file BinaryFormat.hpp
+ * @brief On-disk layout shared by Matrix::save(), Matrix::load() and MappedMatrix.
+ *
+ * A file is a 64-byte header followed by the raw row-major payload: rows * stride elements,
+ * exactly as they sit in a Matrix buffer (padding included). Because the payload starts at a
+ * 64-byte offset, a memory-mapped file keeps the same cache-line alignment as an in-memory Matrix.
+ * The header records the element type, the shape, the row stride and the writer's byte order;
+ * readers on a machine with the other byte order swap the payload while loading.
+ */
+namespace matrixlib {
+
+/**
+ * @brief Element type tag stored in the file header.
+ */
+enum class DType : std::uint32_t {
+    Int8 = 1,
+    UInt8 = 2,
+    Int16 = 3,
+    UInt16 = 4,
+    Int32 = 5,
+    UInt32 = 6,
+    Int64 = 7,
+    UInt64 = 8,
+    Float32 = 9,
+    Float64 = 10
+};
+
+/**
+ * @brief Fixed 64-byte file header. Multi-byte fields are written in the writer's byte order.
+ */
+struct BinaryHeader {
+    char magic[8];                 //"MTXLIB" followed by two zero bytes
+    std::uint32_t byte_order;      //byte_order_mark as seen by the writer
+    std::uint32_t version;
+    std::uint32_t dtype;           //DType
+    std::uint32_t element_size;    //sizeof(T), redundant with dtype but cheap to check
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t stride;          //Elements between consecutive rows in the payload
+    std::uint8_t reserved[16];
+};
+static_assert(sizeof(BinaryHeader) == 64, "BinaryHeader must stay 64 bytes.");
+
+namespace detail {
+
+inline constexpr char binary_magic[8] = {'M', 'T', 'X', 'L', 'I', 'B', 0, 0};
+inline constexpr std::uint32_t binary_version = 1;
+inline constexpr std::uint32_t byte_order_mark = 0x01020304u;
+
+/**
+ * @brief Maps an arithmetic element type to its DType tag.
+ */
+template <typename T>
+constexpr DType dtypeOf() {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, long double>,
+                  "Binary format supports integer, float and double elements.");
+    if constexpr (std::is_floating_point_v<T>) {
+        return sizeof(T) == 4 ? DType::Float32 : DType::Float64;
+    } else {
+        constexpr std::uint32_t base = sizeof(T) == 1 ? 1 : sizeof(T) == 2 ? 3 : sizeof(T) == 4 ? 5 : 7;
+        return static_cast<DType>(std::is_signed_v<T> ? base : base + 1);
+    }
+}
+
+template <typename U>
+U byteswapValue(U value) {
+    unsigned char bytes[sizeof(U)];
+    std::memcpy(bytes, &value, sizeof(U));
+    std::reverse(bytes, bytes + sizeof(U));
+    std::memcpy(&value, bytes, sizeof(U));
+    return value;
+}
+
+/**
+ * @brief Reverses the byte order of count elements in place.
+ */
+template <typename T>
+void byteswapBuffer(T* values, std::size_t count) {
+    if constexpr (sizeof(T) > 1) {
+        for (std::size_t i = 0; i < count; i++) {
+            values[i] = byteswapValue(values[i]);
+        }
+    }
+}
+
+/**
+ * @brief Builds the header describing a rows x cols payload with the given row stride.
+ */
+template <typename T>
+BinaryHeader makeHeader(int rows, int cols, int stride) {
+    BinaryHeader header{};
+    std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+    header.byte_order = byte_order_mark;
+    header.version = binary_version;
+    header.dtype = static_cast<std::uint32_t>(dtypeOf<T>());
+    header.element_size = sizeof(T);
+    header.rows = static_cast<std::uint64_t>(rows);
+    header.cols = static_cast<std::uint64_t>(cols);
+    header.stride = static_cast<std::uint64_t>(stride);
+    return header;
+}
+
+/**
+ * @brief Validates a raw header for element type T and converts it to native byte order.
+ * @param header Header as read from the file; rewritten in native byte order.
+ * @return true if the payload was written with the other byte order and must be swapped.
+ * @throws std::invalid_argument if the header is not a matrix header for element type T.
+ */
+template <typename T>
+bool normalizeHeader(BinaryHeader& header) {
+    if (std::memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0) {
+        throw std::invalid_argument("Not a matrix file.\n");
+    }
+    bool swapped = false;
+    if (header.byte_order != byte_order_mark) {
+        if (byteswapValue(header.byte_order) != byte_order_mark) {
+            throw std::invalid_argument("Matrix file has an unknown byte order.\n");
+        }
+        swapped = true;
+        header.version = byteswapValue(header.version);
+        header.dtype = byteswapValue(header.dtype);
+        header.element_size = byteswapValue(header.element_size);
+        header.rows = byteswapValue(header.rows);
+        header.cols = byteswapValue(header.cols);
+        header.stride = byteswapValue(header.stride);
+        header.byte_order = byte_order_mark;
+    }
+    if (header.version != binary_version) {
+        throw std::invalid_argument("Unsupported matrix file version.\n");
+    }
+    if (header.dtype != static_cast<std::uint32_t>(dtypeOf<T>()) || header.element_size != sizeof(T)) {
+        throw std::invalid_argument("Matrix file element type does not match.\n");
+    }
+    constexpr std::uint64_t max_dim = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+    if (header.rows > max_dim || header.cols > max_dim || header.stride > max_dim || header.stride < header.cols) {
+        throw std::invalid_argument("Matrix file has an invalid shape.\n");
+    }
+    return swapped;
+}
+
+/**
+ * @brief Reads and validates the header at the current stream position.
+ * @return true if the payload must be byte-swapped.
+ * @throws std::runtime_error if the stream ends early.
+ * @throws std::invalid_argument if the header does not describe a matrix of T.
+ */
+template <typename T>
+bool readHeader(std::istream& in, BinaryHeader& header) {
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Cannot read matrix file.\n");
+    }
+    return normalizeHeader<T>(header);
+}
+
+} // namespace detail
+} // namespace matrixlib
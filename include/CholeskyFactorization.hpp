@@ -0,0 +1,236 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "Matrix.hpp"
+#include "Gemm.hpp"
+#include "ScratchArena.hpp"
+#include "Syrk.hpp"
+#include "ThreadPool.hpp"
+#include "TriangularSolve.hpp"
+
+/**
+ * @class Cholesky_Factorization
+ * @brief Cholesky factorization A = L * L^T of a symmetric positive definite matrix, in O(n^3 / 3).
+ * Half the work of LU and no pivoting. Only the lower triangle of A is read; L is stored in the
+ * lower triangle of an n x n matrix whose strict upper triangle is zero.
+ * The factorization is blocked: each diagonal block is factored directly, the panel below it is
+ * solved row by row in parallel, and the lower triangle of the trailing submatrix is updated
+ * with a symmetric rank-k update (SYRK).
+ * @note Intended for floating point types (float/double).
+ * @note Example: Cholesky_Factorization<double> chol = sq.cholesky(); Matrix<double> x = chol.solve(b);
+ */
+template <typename T, typename Alloc = AlignedAllocator<T>>
+class Cholesky_Factorization
+{
+private:
+    static constexpr int block_size = 64;
+
+    Matrix<T, Alloc> m_l;
+    bool m_positive_definite = true;
+
+    /**
+     * @brief Factors the diagonal block [k0, k0 + kb) in place.
+     * @return false if a pivot is not positive (the matrix is not positive definite).
+     */
+    bool factorDiagonal(int k0, int kb) {
+        for (int j = k0; j < k0 + kb; j++) {
+            T* row_j = m_l.rowData(j);
+            T diag = row_j[j];
+            for (int p = k0; p < j; p++) {
+                diag -= row_j[p] * row_j[p];
+            }
+            if (!(diag > static_cast<T>(0))) {
+                return false;
+            }
+            diag = std::sqrt(diag);
+            row_j[j] = diag;
+            for (int i = j + 1; i < k0 + kb; i++) {
+                T* row_i = m_l.rowData(i);
+                T sum = row_i[j];
+                for (int p = k0; p < j; p++) {
+                    sum -= row_i[p] * row_j[p];
+                }
+                row_i[j] = sum / diag;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Runs the blocked right-looking factorization over the whole matrix.
+     */
+    void factor() {
+        const int n = m_l.getRows();
+        const std::ptrdiff_t ld = m_l.getStride();
+        for (int k0 = 0; k0 < n; k0 += block_size) {
+            const int kb = std::min(block_size, n - k0);
+            const int rest = n - k0 - kb;
+            if (!factorDiagonal(k0, kb)) {
+                m_positive_definite = false;
+                return;
+            }
+            if (rest == 0) {
+                continue;
+            }
+
+            //L21 = A21 * L11^-T: every row of the panel is an independent forward substitution.
+            //Run in axpy form against a copy of L11^T so the inner loops are contiguous updates
+            matrixlib::ScratchScope scope;
+            T* u = scope.allocate<T>(static_cast<std::size_t>(kb) * kb);
+            for (int j = 0; j < kb; j++) {
+                for (int c = j; c < kb; c++) {
+                    u[j * kb + c] = m_l(k0 + c, k0 + j);
+                }
+            }
+            matrixlib::parallelRows(rest, static_cast<long long>(rest) * kb * kb, [&](int r0, int r1) {
+                for (int i = k0 + kb + r0; i < k0 + kb + r1; i++) {
+                    T* row_i = m_l.rowData(i) + k0;
+                    for (int j = 0; j < kb; j++) {
+                        const T* u_j = u + j * kb;
+                        const T x = row_i[j] / u_j[j];
+                        row_i[j] = x;
+                        for (int c = j + 1; c < kb; c++) {
+                            row_i[c] -= x * u_j[c];
+                        }
+                    }
+                }
+            });
+
+            //A22 -= L21 * L21^T on the lower triangle only
+            const int row0 = k0 + kb;
+            matrixlib::syrk<T>(matrixlib::Triangle::Lower, rest, kb, static_cast<T>(-1),
+                               m_l.rowData(row0) + k0, ld, 1,
+                               static_cast<T>(1), m_l.rowData(row0) + row0, ld);
+        }
+        for (int i = 0; i < n; i++) {
+            std::fill(m_l.rowData(i) + i + 1, m_l.rowData(i) + n, static_cast<T>(0));
+        }
+    }
+
+public:
+    /**
+     * @brief Factors a symmetric positive definite matrix.
+     * @param a The matrix to factor; only its lower triangle is read.
+     * @throws std::invalid_argument if the matrix is not square.
+     * @note Example: Cholesky_Factorization<double> chol(mat);
+     */
+    explicit Cholesky_Factorization(const Matrix<T, Alloc>& a) : m_l(a) {
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("Cholesky factorization requires a square matrix.\n");
+        }
+        factor();
+    }
+
+    /**
+     * @brief Factors a temporary symmetric positive definite matrix in its own buffer.
+     * @param a The matrix to factor (consumed).
+     * @throws std::invalid_argument if the matrix is not square.
+     * @note Example: Cholesky_Factorization<double> chol(std::move(mat));
+     */
+    explicit Cholesky_Factorization(Matrix<T, Alloc>&& a) : m_l(std::move(a)) {
+        if (m_l.getRows() != m_l.getCols()) {
+            throw std::invalid_argument("Cholesky factorization requires a square matrix.\n");
+        }
+        factor();
+    }
+
+    /**
+     * @brief Returns the dimension of the factored matrix.
+     */
+    int size() const { return m_l.getRows(); }
+
+    /**
+     * @brief Checks whether the factorization succeeded, i.e. the matrix is positive definite.
+     */
+    bool isPositiveDefinite() const { return m_positive_definite; }
+
+    /**
+     * @brief Returns the lower triangular factor L.
+     * @throws std::invalid_argument if the matrix is not positive definite.
+     */
+    const Matrix<T, Alloc>& lower() const {
+        if (!m_positive_definite) {
+            throw std::invalid_argument("Matrix is not positive definite.\n");
+        }
+        return m_l;
+    }
+
+    /**
+     * @brief Calculates the determinant as the squared product of L's diagonal.
+     * @throws std::invalid_argument if the matrix is not positive definite.
+     * @note Example: double det = chol.determinant();
+     */
+    T determinant() const {
+        const Matrix<T, Alloc>& l = lower();
+        T det = static_cast<T>(1);
+        for (int i = 0; i < size(); i++) {
+            det *= l(i, i) * l(i, i);
+        }
+        return det;
+    }
+
+    /**
+     * @brief Solves A * X = B in place: B is overwritten with X, nothing is allocated.
+     * @param x Right-hand sides, one per column (n x k); receives the solution. Any allocator.
+     * @throws std::invalid_argument if B has the wrong number of rows or A is not positive definite.
+     * @note Example: chol.solveInPlace(b);
+     */
+    template <typename XAlloc>
+    void solveInPlace(Matrix<T, XAlloc>& x) const {
+        const int n = size();
+        if (x.getRows() != n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        if (!m_positive_definite) {
+            throw std::invalid_argument("Matrix is not positive definite.\n");
+        }
+        //L * Y = B, then L^T * X = Y (L^T is L with its strides swapped)
+        const std::ptrdiff_t ld = m_l.getStride();
+        matrixlib::trsm<T>(matrixlib::Triangle::Lower, false, n, x.getCols(), m_l.rowData(0), ld, 1, x.rowData(0), x.getStride());
+        matrixlib::trsm<T>(matrixlib::Triangle::Upper, false, n, x.getCols(), m_l.rowData(0), 1, ld, x.rowData(0), x.getStride());
+    }
+
+    /**
+     * @brief Solves A * X = B for every column of B at once.
+     * @param b Right-hand sides, one per column (n x k).
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if B has the wrong number of rows or A is not positive definite.
+     * @note Example: Matrix<double> x = chol.solve(b);
+     */
+    template <typename BAlloc>
+    Matrix<T, BAlloc> solve(const Matrix<T, BAlloc>& b) const {
+        Matrix<T, BAlloc> x(b);
+        solveInPlace(x);
+        return x;
+    }
+
+    /**
+     * @brief Solves A * X = B, reusing the buffer of a temporary B for the solution.
+     * @note Example: Matrix<double> x = chol.solve(a * y);
+     */
+    template <typename BAlloc>
+    Matrix<T, BAlloc> solve(Matrix<T, BAlloc>&& b) const {
+        solveInPlace(b);
+        return std::move(b);
+    }
+
+    /**
+     * @brief Solves A * x = b for a single right-hand side vector.
+     * @param b Right-hand side of length n.
+     * @return The solution vector x.
+     * @throws std::invalid_argument if b has the wrong length or A is not positive definite.
+     * @note Example: std::vector<double> x = chol.solve({1.0, 2.0, 3.0});
+     */
+    std::vector<T> solve(const std::vector<T>& b) const {
+        if (static_cast<int>(b.size()) != size()) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        Matrix<T, Alloc> rhs(size(), 1);
+        rhs.setColVal(0, b);
+        solveInPlace(rhs);
+        return rhs.getCol(0);
+    }
+};
@@ -0,0 +1,412 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "Matrix.hpp"
+
+namespace matrixlib::detail {
+
+/**
+ * @brief Closed-form determinant of an N x N matrix (N <= 4) read through a(row, col).
+ * Shared by FixedMatrix and MatrixBatch, which evaluates it once per SIMD lane.
+ */
+template <int N, typename T, typename A>
+constexpr T closedFormDeterminant(const A& a) {
+    static_assert(N >= 1 && N <= 4, "Closed-form determinant is available for sizes 1 to 4.");
+    if constexpr (N == 1) {
+        return a(0, 0);
+    } else if constexpr (N == 2) {
+        return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+    } else if constexpr (N == 3) {
+        return a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1))
+             - a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0))
+             + a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+    } else {
+        const T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+        const T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+        const T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+        const T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+        const T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+        const T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+        const T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+        const T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+        const T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+        const T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+        const T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+        const T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+}
+
+/**
+ * @brief Writes the adjugate of an N x N matrix (N <= 4) through adj(row, col) and returns the
+ * determinant computed from the same cofactors. The inverse is the adjugate divided by it.
+ */
+template <int N, typename T, typename A, typename Adj>
+constexpr T closedFormAdjugate(const A& a, const Adj& adj) {
+    static_assert(N >= 1 && N <= 4, "Closed-form adjugate is available for sizes 1 to 4.");
+    if constexpr (N == 1) {
+        adj(0, 0) = static_cast<T>(1);
+        return a(0, 0);
+    } else if constexpr (N == 2) {
+        const T a00 = a(0, 0), a01 = a(0, 1), a10 = a(1, 0), a11 = a(1, 1);
+        adj(0, 0) = a11;
+        adj(0, 1) = -a01;
+        adj(1, 0) = -a10;
+        adj(1, 1) = a00;
+        return a00 * a11 - a01 * a10;
+    } else if constexpr (N == 3) {
+        const T i00 = a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1);
+        const T i10 = a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2);
+        const T i20 = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+        const T det = a(0, 0) * i00 + a(0, 1) * i10 + a(0, 2) * i20;
+        const T i01 = a(0, 2) * a(2, 1) - a(0, 1) * a(2, 2);
+        const T i02 = a(0, 1) * a(1, 2) - a(0, 2) * a(1, 1);
+        const T i11 = a(0, 0) * a(2, 2) - a(0, 2) * a(2, 0);
+        const T i12 = a(0, 2) * a(1, 0) - a(0, 0) * a(1, 2);
+        const T i21 = a(0, 1) * a(2, 0) - a(0, 0) * a(2, 1);
+        const T i22 = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+        adj(0, 0) = i00; adj(0, 1) = i01; adj(0, 2) = i02;
+        adj(1, 0) = i10; adj(1, 1) = i11; adj(1, 2) = i12;
+        adj(2, 0) = i20; adj(2, 1) = i21; adj(2, 2) = i22;
+        return det;
+    } else {
+        const T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+        const T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+        const T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+        const T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+        const T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+        const T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+        const T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+        const T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+        const T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+        const T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+        const T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+        const T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+        const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+        //All cofactors are computed before the first write, so adj may alias a
+        const T i00 =  a(1, 1) * c5 - a(1, 2) * c4 + a(1, 3) * c3;
+        const T i01 = -a(0, 1) * c5 + a(0, 2) * c4 - a(0, 3) * c3;
+        const T i02 =  a(3, 1) * s5 - a(3, 2) * s4 + a(3, 3) * s3;
+        const T i03 = -a(2, 1) * s5 + a(2, 2) * s4 - a(2, 3) * s3;
+        const T i10 = -a(1, 0) * c5 + a(1, 2) * c2 - a(1, 3) * c1;
+        const T i11 =  a(0, 0) * c5 - a(0, 2) * c2 + a(0, 3) * c1;
+        const T i12 = -a(3, 0) * s5 + a(3, 2) * s2 - a(3, 3) * s1;
+        const T i13 =  a(2, 0) * s5 - a(2, 2) * s2 + a(2, 3) * s1;
+        const T i20 =  a(1, 0) * c4 - a(1, 1) * c2 + a(1, 3) * c0;
+        const T i21 = -a(0, 0) * c4 + a(0, 1) * c2 - a(0, 3) * c0;
+        const T i22 =  a(3, 0) * s4 - a(3, 1) * s2 + a(3, 3) * s0;
+        const T i23 = -a(2, 0) * s4 + a(2, 1) * s2 - a(2, 3) * s0;
+        const T i30 = -a(1, 0) * c3 + a(1, 1) * c1 - a(1, 2) * c0;
+        const T i31 =  a(0, 0) * c3 - a(0, 1) * c1 + a(0, 2) * c0;
+        const T i32 = -a(3, 0) * s3 + a(3, 1) * s1 - a(3, 2) * s0;
+        const T i33 =  a(2, 0) * s3 - a(2, 1) * s1 + a(2, 2) * s0;
+        adj(0, 0) = i00; adj(0, 1) = i01; adj(0, 2) = i02; adj(0, 3) = i03;
+        adj(1, 0) = i10; adj(1, 1) = i11; adj(1, 2) = i12; adj(1, 3) = i13;
+        adj(2, 0) = i20; adj(2, 1) = i21; adj(2, 2) = i22; adj(2, 3) = i23;
+        adj(3, 0) = i30; adj(3, 1) = i31; adj(3, 2) = i32; adj(3, 3) = i33;
+        return det;
+    }
+}
+
+} // namespace matrixlib::detail
+
+/**
+ * @class FixedMatrix
+ * @brief A stack-allocated matrix whose dimensions are template parameters.
+ * Intended for the many small (2x2, 3x3, 4x4) matrices of geometry code: no heap allocation,
+ * dimension mismatches are compile errors, all arithmetic is constexpr and the loops have
+ * compile-time trip counts so they are fully unrolled. Determinant and inverse use closed-form
+ * expressions for sizes up to 4. A FixedMatrix is also a MatrixExpr, so it can be mixed with
+ * the dynamic Matrix<T> in expressions and converted to and from it.
+ * @note Example: FixedMatrix<double, 3, 3> rot({{0, -1, 0}, {1, 0, 0}, {0, 0, 1}});
+ */
+template <typename T, int R, int C>
+class FixedMatrix : public MatrixExpr<FixedMatrix<T, R, C>>
+{
+    static_assert(R > 0 && C > 0, "FixedMatrix dimensions must be positive.");
+
+private:
+    std::array<T, R * C> data{};
+
+public:
+    using value_type = T;
+    static constexpr int rows = R;
+    static constexpr int cols = C;
+
+    /**
+     * @brief Constructs a zero matrix.
+     * @note Example: FixedMatrix<float, 4, 4> m;
+     */
+    constexpr FixedMatrix() = default;
+
+    /**
+     * @brief Constructs a matrix from a nested brace list; too many values is a compile error.
+     * @param values Row-major initial values (missing trailing values are zero).
+     * @note Example: FixedMatrix<int, 2, 2> m({{1, 2}, {3, 4}});
+     */
+    constexpr FixedMatrix(const T (&values)[R][C]) {
+        for (int r = 0; r < R; r++) {
+            for (int c = 0; c < C; c++) {
+                data[r * C + c] = values[r][c];
+            }
+        }
+    }
+
+    /**
+     * @brief Copies a dynamic Matrix of matching size.
+     * @param other Source matrix.
+     * @throws std::invalid_argument if the dimensions differ from R x C.
+     * @note Example: FixedMatrix<double, 3, 3> f(dynamicMat);
+     */
+    explicit FixedMatrix(const Matrix<T>& other) {
+        if (other.getRows() != R || other.getCols() != C) {
+            throw std::invalid_argument("Matrix dimensions do not match the FixedMatrix size.\n");
+        }
+        for (int r = 0; r < R; r++) {
+            for (int c = 0; c < C; c++) {
+                data[r * C + c] = other(r, c);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the identity matrix (square sizes only).
+     * @note Example: auto id = FixedMatrix<double, 4, 4>::identity();
+     */
+    static constexpr FixedMatrix identity() requires (R == C) {
+        FixedMatrix result;
+        for (int i = 0; i < R; i++) {
+            result(i, i) = static_cast<T>(1);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Converts to a heap-allocated dynamic Matrix.
+     * @note Example: Matrix<double> dyn = fixed.toMatrix();
+     */
+    Matrix<T> toMatrix() const {
+        return Matrix<T>(*this);
+    }
+
+    constexpr int getRows() const { return R; }
+    constexpr int getCols() const { return C; }
+
+    /**
+     * @brief Unchecked element access.
+     * @note Example: m(1, 2) = 3.0;
+     */
+    constexpr T& operator()(int row, int col) { return data[row * C + col]; }
+    constexpr const T& operator()(int row, int col) const { return data[row * C + col]; }
+
+    /**
+     * @brief Element read used when the matrix appears in an expression.
+     */
+    constexpr const T& coeff(int row, int col) const { return data[row * C + col]; }
+
+    /**
+     * @brief Strided layout descriptor, lets GEMM read the matrix in place.
+     */
+    const T* stridedData() const { return data.data(); }
+    std::ptrdiff_t rowStride() const { return C; }
+    std::ptrdiff_t colStride() const { return 1; }
+
+    /**
+     * @brief Element access with indices checked at compile time.
+     * @note Example: double x = m.get<0, 2>();
+     */
+    template <int row, int col>
+    constexpr T& get() {
+        static_assert(row >= 0 && row < R && col >= 0 && col < C, "Index out of bounds.");
+        return data[row * C + col];
+    }
+
+    template <int row, int col>
+    constexpr const T& get() const {
+        static_assert(row >= 0 && row < R && col >= 0 && col < C, "Index out of bounds.");
+        return data[row * C + col];
+    }
+
+    /**
+     * @brief Retrieves a single element with runtime bounds checking.
+     * @throws std::invalid_argument if indices are out of bounds.
+     * @note Example: double val = m.getValue(1, 1);
+     */
+    constexpr T getValue(int row, int col) const {
+        if (row < 0 || row >= R || col < 0 || col >= C) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        return data[row * C + col];
+    }
+
+    constexpr FixedMatrix& operator+=(const FixedMatrix& other) {
+        for (int i = 0; i < R * C; i++) data[i] += other.data[i];
+        return *this;
+    }
+
+    constexpr FixedMatrix& operator-=(const FixedMatrix& other) {
+        for (int i = 0; i < R * C; i++) data[i] -= other.data[i];
+        return *this;
+    }
+
+    constexpr FixedMatrix& operator*=(T constant) {
+        for (int i = 0; i < R * C; i++) data[i] *= constant;
+        return *this;
+    }
+
+    /**
+     * @throws std::invalid_argument if dividing by zero.
+     */
+    constexpr FixedMatrix& operator/=(T constant) {
+        if (constant == static_cast<T>(0)) {
+            throw std::invalid_argument("Constant must be a nonzero value.\n");
+        }
+        for (int i = 0; i < R * C; i++) data[i] /= constant;
+        return *this;
+    }
+
+    /**
+     * @brief Returns the transposed matrix (C x R).
+     * @note Example: FixedMatrix<double, 3, 2> t = m.transposed();
+     */
+    constexpr FixedMatrix<T, C, R> transposed() const {
+        FixedMatrix<T, C, R> result;
+        for (int r = 0; r < R; r++) {
+            for (int c = 0; c < C; c++) {
+                result(c, r) = (*this)(r, c);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Calculates the determinant with a closed-form expression (sizes 1 to 4).
+     * @note Example: double det = m.determinant();
+     */
+    constexpr T determinant() const requires (R == C && R <= 4) {
+        return matrixlib::detail::closedFormDeterminant<R, T>(*this);
+    }
+
+    /**
+     * @brief Calculates the inverse with closed-form cofactor expressions (sizes 1 to 4).
+     * @throws std::invalid_argument if the matrix is singular (determinant is 0) or, for integral
+     * T, the inverse is not an integer matrix.
+     * @note Recommended to use with floating point types (float/double).
+     * @note Example: FixedMatrix<double, 4, 4> inv = m.inverse();
+     */
+    constexpr FixedMatrix inverse() const requires (R == C && R <= 4) {
+        FixedMatrix inv;
+        const T det = matrixlib::detail::closedFormAdjugate<R, T>(*this, [&inv](int r, int c) -> T& { return inv(r, c); });
+        if (det == static_cast<T>(0)) {
+            throw std::invalid_argument("Cannot calculate inverse: Determinant is 0.\n");
+        }
+        if constexpr (std::is_integral_v<T>) {
+            for (int i = 0; i < R * C; i++) {
+                if (inv.data[i] % det != 0) {
+                    throw std::invalid_argument("Inverse is not an integer matrix.\n");
+                }
+            }
+        }
+        for (int i = 0; i < R * C; i++) {
+            inv.data[i] /= det;
+        }
+        return inv;
+    }
+};
+
+namespace matrixlib::detail {
+
+template <typename T, int R, int C>
+struct is_expression_leaf<FixedMatrix<T, R, C>> : std::true_type {};
+
+} // namespace matrixlib::detail
+
+/**
+ * @brief Element-wise addition of two FixedMatrix objects of the same size.
+ * @note Example: constexpr auto c = a + b;
+ */
+template <typename T, int R, int C>
+constexpr FixedMatrix<T, R, C> operator+(const FixedMatrix<T, R, C>& lhs, const FixedMatrix<T, R, C>& rhs) {
+    FixedMatrix<T, R, C> result = lhs;
+    result += rhs;
+    return result;
+}
+
+/**
+ * @brief Element-wise subtraction of two FixedMatrix objects of the same size.
+ */
+template <typename T, int R, int C>
+constexpr FixedMatrix<T, R, C> operator-(const FixedMatrix<T, R, C>& lhs, const FixedMatrix<T, R, C>& rhs) {
+    FixedMatrix<T, R, C> result = lhs;
+    result -= rhs;
+    return result;
+}
+
+/**
+ * @brief Scalar multiplication.
+ */
+template <typename T, int R, int C>
+constexpr FixedMatrix<T, R, C> operator*(const FixedMatrix<T, R, C>& lhs, std::type_identity_t<T> constant) {
+    FixedMatrix<T, R, C> result = lhs;
+    result *= constant;
+    return result;
+}
+
+template <typename T, int R, int C>
+constexpr FixedMatrix<T, R, C> operator*(std::type_identity_t<T> constant, const FixedMatrix<T, R, C>& rhs) {
+    FixedMatrix<T, R, C> result;
+    for (int r = 0; r < R; r++) {
+        for (int c = 0; c < C; c++) {
+            result(r, c) = constant * rhs(r, c);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Scalar division.
+ * @throws std::invalid_argument if dividing by zero.
+ */
+template <typename T, int R, int C>
+constexpr FixedMatrix<T, R, C> operator/(const FixedMatrix<T, R, C>& lhs, std::type_identity_t<T> constant) {
+    FixedMatrix<T, R, C> result = lhs;
+    result /= constant;
+    return result;
+}
+
+/**
+ * @brief Matrix multiplication; inner dimensions are checked at compile time.
+ * @note Example: FixedMatrix<double, 3, 1> v2 = rot * v;
+ */
+template <typename T, int R, int K, int C>
+constexpr FixedMatrix<T, R, C> operator*(const FixedMatrix<T, R, K>& lhs, const FixedMatrix<T, K, C>& rhs) {
+    FixedMatrix<T, R, C> result;
+    for (int r = 0; r < R; r++) {
+        for (int k = 0; k < K; k++) {
+            const T a = lhs(r, k);
+            for (int c = 0; c < C; c++) {
+                result(r, c) += a * rhs(k, c);
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Mismatched sizes are rejected at compile time instead of falling back to the
+ * runtime-checked MatrixExpr operators.
+ */
+template <typename T, int R1, int C1, int R2, int C2>
+    requires (R1 != R2 || C1 != C2)
+void operator+(const FixedMatrix<T, R1, C1>&, const FixedMatrix<T, R2, C2>&) = delete;
+
+template <typename T, int R1, int C1, int R2, int C2>
+    requires (R1 != R2 || C1 != C2)
+void operator-(const FixedMatrix<T, R1, C1>&, const FixedMatrix<T, R2, C2>&) = delete;
+
+template <typename T, int R, int K1, int K2, int C>
+    requires (K1 != K2)
+void operator*(const FixedMatrix<T, R, K1>&, const FixedMatrix<T, K2, C>&) = delete;
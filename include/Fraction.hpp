@@ -0,0 +1,154 @@
+#pragma once
+#include <compare>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace matrixlib {
+
+/**
+ * @class Fraction
+ * @brief Exact rational number num / den over a signed integer type I.
+ * Always kept in lowest terms with a positive denominator, so equal values compare equal
+ * member by member. Arithmetic cancels common factors before multiplying and checks every
+ * step, throwing std::overflow_error rather than wrapping around.
+ * @note Example: Fraction<long long> third(1, 3); Fraction<long long> one = third * 3;
+ */
+template <typename I>
+class Fraction
+{
+    static_assert(std::is_integral_v<I> && std::is_signed_v<I>, "Fraction needs a signed integer type.");
+
+private:
+    I m_num = 0;
+    I m_den = 1;
+
+    static I checkedAdd(I a, I b) {
+        I result;
+        if (__builtin_add_overflow(a, b, &result)) {
+            throw std::overflow_error("Fraction overflow.\n");
+        }
+        return result;
+    }
+
+    static I checkedMul(I a, I b) {
+        I result;
+        if (__builtin_mul_overflow(a, b, &result)) {
+            throw std::overflow_error("Fraction overflow.\n");
+        }
+        return result;
+    }
+
+    static I checkedNeg(I a) {
+        I result;
+        if (__builtin_sub_overflow(I{0}, a, &result)) {
+            throw std::overflow_error("Fraction overflow.\n");
+        }
+        return result;
+    }
+
+    /**
+     * @brief Builds a fraction from a numerator and denominator already in lowest terms.
+     */
+    static Fraction reduced(I num, I den) {
+        Fraction f;
+        f.m_num = num;
+        f.m_den = den;
+        return f;
+    }
+
+public:
+    /**
+     * @brief Constructs num / den in lowest terms.
+     * @throws std::invalid_argument if den is zero.
+     * @throws std::overflow_error if the sign cannot be moved to the numerator.
+     * @note Example: Fraction<long long> half(2, 4); // 1/2
+     */
+    Fraction(I num = 0, I den = 1) {
+        if (den == 0) {
+            throw std::invalid_argument("Denominator must be nonzero.\n");
+        }
+        const I g = std::gcd(num, den);
+        num /= g;
+        den /= g;
+        if (den < 0) {
+            num = checkedNeg(num);
+            den = checkedNeg(den);
+        }
+        m_num = num;
+        m_den = den;
+    }
+
+    I num() const { return m_num; }
+    I den() const { return m_den; }
+
+    /**
+     * @brief Whether the value is a whole number.
+     */
+    bool isInteger() const { return m_den == 1; }
+
+    /**
+     * @brief Nearest double to the value.
+     * @note Example: double x = f.toDouble();
+     */
+    double toDouble() const { return static_cast<double>(m_num) / static_cast<double>(m_den); }
+
+    Fraction operator-() const { return reduced(checkedNeg(m_num), m_den); }
+
+    friend Fraction operator+(const Fraction& a, const Fraction& b) {
+        //a/b + c/d = (a * (d/g) + c * (b/g)) / (b/g * d), with g = gcd(b, d)
+        const I g = std::gcd(a.m_den, b.m_den);
+        const I num = checkedAdd(checkedMul(a.m_num, b.m_den / g), checkedMul(b.m_num, a.m_den / g));
+        const I g2 = std::gcd(num, g);
+        return reduced(num / g2, checkedMul(a.m_den / g, b.m_den / g2));
+    }
+
+    friend Fraction operator-(const Fraction& a, const Fraction& b) { return a + (-b); }
+
+    friend Fraction operator*(const Fraction& a, const Fraction& b) {
+        //Denominators are positive, so both gcds are at least 1
+        const I g1 = std::gcd(a.m_num, b.m_den);
+        const I g2 = std::gcd(b.m_num, a.m_den);
+        return reduced(checkedMul(a.m_num / g1, b.m_num / g2), checkedMul(a.m_den / g2, b.m_den / g1));
+    }
+
+    /**
+     * @throws std::invalid_argument if b is zero.
+     */
+    friend Fraction operator/(const Fraction& a, const Fraction& b) {
+        if (b.m_num == 0) {
+            throw std::invalid_argument("Cannot divide by zero.\n");
+        }
+        const I num = b.m_num < 0 ? checkedNeg(b.m_den) : b.m_den;
+        const I den = b.m_num < 0 ? checkedNeg(b.m_num) : b.m_num;
+        return a * reduced(num, den);
+    }
+
+    Fraction& operator+=(const Fraction& b) { return *this = *this + b; }
+    Fraction& operator-=(const Fraction& b) { return *this = *this - b; }
+    Fraction& operator*=(const Fraction& b) { return *this = *this * b; }
+    Fraction& operator/=(const Fraction& b) { return *this = *this / b; }
+
+    friend bool operator==(const Fraction& a, const Fraction& b) {
+        return a.m_num == b.m_num && a.m_den == b.m_den;
+    }
+
+    friend std::strong_ordering operator<=>(const Fraction& a, const Fraction& b) {
+        //Compare a.num * b.den with b.num * a.den in twice the width, which cannot overflow
+        using Wide = std::conditional_t<(sizeof(I) < sizeof(long long)), long long, __int128>;
+        return static_cast<Wide>(a.m_num) * b.m_den <=> static_cast<Wide>(b.m_num) * a.m_den;
+    }
+
+    /**
+     * @brief Writes "num/den", or just "num" for whole numbers.
+     */
+    friend std::ostream& operator<<(std::ostream& out, const Fraction& f) {
+        if (f.m_den == 1) {
+            return out << f.m_num;
+        }
+        return out << f.m_num << '/' << f.m_den;
+    }
+};
+
+} // namespace matrixlib
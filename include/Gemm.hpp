@@ -0,0 +1,491 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <cstdlib>
+#include <string>
+#include "AlignedAllocator.hpp"
+#include "ScratchArena.hpp"
+#include "ThreadPool.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MATRIXLIB_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define MATRIXLIB_X86_KERNELS 0
+#endif
+
+/**
+ * @file Gemm.hpp
+ * @brief Packed, cache-blocked general matrix multiply used by Matrix::multiplyByMatrix.
+ *
+ * Computes C = alpha * A * B + beta * C for operands described by a base pointer and a row/column
+ * stride, so row-major, column-major and transposed operands all go through the same path.
+ * The loop nest follows the classic Goto/BLIS layout: B is packed into KC x NC panels (sized for L3),
+ * A into MC x KC blocks (sized for L2), and a register-tiled MR x NR micro-kernel streams both
+ * packed panels out of L1. The micro-kernel is chosen once at runtime from the CPU features
+ * (AVX-512, AVX2+FMA) for float and double; every other element type uses a portable kernel.
+ * Large products split each packed B panel into 2D tiles of C that run on the shared ThreadPool.
+ */
+namespace matrixlib {
+
+/**
+ * @brief Operand transformation applied before a product: the operand itself or its transpose.
+ */
+enum class Op {
+    NoTrans,
+    Trans
+};
+
+namespace detail {
+
+/**
+ * @brief Signature of a micro-kernel: C[MR x NR] = alpha * sum_p a[p] * b[p] + beta * C.
+ * @param kc Depth of the packed panels.
+ * @param a Packed A panel (kc groups of MR values).
+ * @param b Packed B panel (kc groups of NR values).
+ * @param c Top-left element of the output tile.
+ * @param ldc Row stride of the output tile.
+ * @param alpha Scale applied to the product.
+ * @param beta Scale applied to the existing tile; when zero the tile is overwritten.
+ */
+template <typename T>
+using MicroKernel = void (*)(int kc, const T* a, const T* b, T* c, std::ptrdiff_t ldc, T alpha, T beta);
+
+/**
+ * @struct GemmKernel
+ * @brief A micro-kernel together with its register tile shape and cache blocking.
+ */
+template <typename T>
+struct GemmKernel {
+    int mr;             //Rows of the register tile
+    int nr;             //Columns of the register tile
+    int mc;             //Rows of a packed A block (L2)
+    int kc;             //Depth of packed panels (L1)
+    int nc;             //Columns of a packed B panel (L3)
+    MicroKernel<T> run;
+    const char* name;
+};
+
+/**
+ * @brief Portable micro-kernel written so the compiler can keep the tile in registers.
+ */
+template <typename T, int MR, int NR>
+void microKernelGeneric(int kc, const T* a, const T* b, T* c, std::ptrdiff_t ldc, T alpha, T beta) {
+    T acc[MR][NR]{};
+    for (int p = 0; p < kc; p++) {
+        for (int i = 0; i < MR; i++) {
+            const T ai = a[i];
+            for (int j = 0; j < NR; j++) {
+                acc[i][j] += ai * b[j];
+            }
+        }
+        a += MR;
+        b += NR;
+    }
+    for (int i = 0; i < MR; i++) {
+        T* ci = c + i * ldc;
+        if (beta == static_cast<T>(0)) {
+            for (int j = 0; j < NR; j++) ci[j] = alpha * acc[i][j];
+        } else {
+            for (int j = 0; j < NR; j++) ci[j] = alpha * acc[i][j] + beta * ci[j];
+        }
+    }
+}
+
+#if MATRIXLIB_X86_KERNELS
+
+/**
+ * @brief AVX2/FMA double kernel, 6 x 8 tile (12 ymm accumulators).
+ */
+__attribute__((target("avx2,fma")))
+inline void microKernelAvx2(int kc, const double* a, const double* b, double* c, std::ptrdiff_t ldc, double alpha, double beta) {
+    __m256d acc[6][2];
+#pragma GCC unroll 6
+    for (int i = 0; i < 6; i++) {
+        acc[i][0] = _mm256_setzero_pd();
+        acc[i][1] = _mm256_setzero_pd();
+    }
+    for (int p = 0; p < kc; p++) {
+        const __m256d b0 = _mm256_loadu_pd(b);
+        const __m256d b1 = _mm256_loadu_pd(b + 4);
+#pragma GCC unroll 6
+        for (int i = 0; i < 6; i++) {
+            const __m256d ai = _mm256_broadcast_sd(a + i);
+            acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+        }
+        a += 6;
+        b += 8;
+    }
+    const __m256d va = _mm256_set1_pd(alpha);
+    const __m256d vb = _mm256_set1_pd(beta);
+#pragma GCC unroll 6
+    for (int i = 0; i < 6; i++) {
+        double* ci = c + i * ldc;
+        __m256d r0 = _mm256_mul_pd(va, acc[i][0]);
+        __m256d r1 = _mm256_mul_pd(va, acc[i][1]);
+        if (beta != 0.0) {
+            r0 = _mm256_fmadd_pd(vb, _mm256_loadu_pd(ci), r0);
+            r1 = _mm256_fmadd_pd(vb, _mm256_loadu_pd(ci + 4), r1);
+        }
+        _mm256_storeu_pd(ci, r0);
+        _mm256_storeu_pd(ci + 4, r1);
+    }
+}
+
+/**
+ * @brief AVX2/FMA float kernel, 6 x 16 tile (12 ymm accumulators).
+ */
+__attribute__((target("avx2,fma")))
+inline void microKernelAvx2(int kc, const float* a, const float* b, float* c, std::ptrdiff_t ldc, float alpha, float beta) {
+    __m256 acc[6][2];
+#pragma GCC unroll 6
+    for (int i = 0; i < 6; i++) {
+        acc[i][0] = _mm256_setzero_ps();
+        acc[i][1] = _mm256_setzero_ps();
+    }
+    for (int p = 0; p < kc; p++) {
+        const __m256 b0 = _mm256_loadu_ps(b);
+        const __m256 b1 = _mm256_loadu_ps(b + 8);
+#pragma GCC unroll 6
+        for (int i = 0; i < 6; i++) {
+            const __m256 ai = _mm256_broadcast_ss(a + i);
+            acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+        }
+        a += 6;
+        b += 16;
+    }
+    const __m256 va = _mm256_set1_ps(alpha);
+    const __m256 vb = _mm256_set1_ps(beta);
+#pragma GCC unroll 6
+    for (int i = 0; i < 6; i++) {
+        float* ci = c + i * ldc;
+        __m256 r0 = _mm256_mul_ps(va, acc[i][0]);
+        __m256 r1 = _mm256_mul_ps(va, acc[i][1]);
+        if (beta != 0.0f) {
+            r0 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(ci), r0);
+            r1 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(ci + 8), r1);
+        }
+        _mm256_storeu_ps(ci, r0);
+        _mm256_storeu_ps(ci + 8, r1);
+    }
+}
+
+/**
+ * @brief AVX-512 double kernel, 8 x 16 tile (16 zmm accumulators).
+ */
+__attribute__((target("avx512f")))
+inline void microKernelAvx512(int kc, const double* a, const double* b, double* c, std::ptrdiff_t ldc, double alpha, double beta) {
+    __m512d acc[8][2];
+#pragma GCC unroll 8
+    for (int i = 0; i < 8; i++) {
+        acc[i][0] = _mm512_setzero_pd();
+        acc[i][1] = _mm512_setzero_pd();
+    }
+    for (int p = 0; p < kc; p++) {
+        const __m512d b0 = _mm512_loadu_pd(b);
+        const __m512d b1 = _mm512_loadu_pd(b + 8);
+#pragma GCC unroll 8
+        for (int i = 0; i < 8; i++) {
+            const __m512d ai = _mm512_set1_pd(a[i]);
+            acc[i][0] = _mm512_fmadd_pd(ai, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_pd(ai, b1, acc[i][1]);
+        }
+        a += 8;
+        b += 16;
+    }
+    const __m512d va = _mm512_set1_pd(alpha);
+    const __m512d vb = _mm512_set1_pd(beta);
+#pragma GCC unroll 8
+    for (int i = 0; i < 8; i++) {
+        double* ci = c + i * ldc;
+        __m512d r0 = _mm512_mul_pd(va, acc[i][0]);
+        __m512d r1 = _mm512_mul_pd(va, acc[i][1]);
+        if (beta != 0.0) {
+            r0 = _mm512_fmadd_pd(vb, _mm512_loadu_pd(ci), r0);
+            r1 = _mm512_fmadd_pd(vb, _mm512_loadu_pd(ci + 8), r1);
+        }
+        _mm512_storeu_pd(ci, r0);
+        _mm512_storeu_pd(ci + 8, r1);
+    }
+}
+
+/**
+ * @brief AVX-512 float kernel, 8 x 32 tile (16 zmm accumulators).
+ */
+__attribute__((target("avx512f")))
+inline void microKernelAvx512(int kc, const float* a, const float* b, float* c, std::ptrdiff_t ldc, float alpha, float beta) {
+    __m512 acc[8][2];
+#pragma GCC unroll 8
+    for (int i = 0; i < 8; i++) {
+        acc[i][0] = _mm512_setzero_ps();
+        acc[i][1] = _mm512_setzero_ps();
+    }
+    for (int p = 0; p < kc; p++) {
+        const __m512 b0 = _mm512_loadu_ps(b);
+        const __m512 b1 = _mm512_loadu_ps(b + 16);
+#pragma GCC unroll 8
+        for (int i = 0; i < 8; i++) {
+            const __m512 ai = _mm512_set1_ps(a[i]);
+            acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+        }
+        a += 8;
+        b += 32;
+    }
+    const __m512 va = _mm512_set1_ps(alpha);
+    const __m512 vb = _mm512_set1_ps(beta);
+#pragma GCC unroll 8
+    for (int i = 0; i < 8; i++) {
+        float* ci = c + i * ldc;
+        __m512 r0 = _mm512_mul_ps(va, acc[i][0]);
+        __m512 r1 = _mm512_mul_ps(va, acc[i][1]);
+        if (beta != 0.0f) {
+            r0 = _mm512_fmadd_ps(vb, _mm512_loadu_ps(ci), r0);
+            r1 = _mm512_fmadd_ps(vb, _mm512_loadu_ps(ci + 16), r1);
+        }
+        _mm512_storeu_ps(ci, r0);
+        _mm512_storeu_ps(ci + 16, r1);
+    }
+}
+
+#endif // MATRIXLIB_X86_KERNELS
+
+/** Largest MR x NR register tile of any kernel (AVX-512 float: 8 x 32). */
+inline constexpr int maxTileSize = 8 * 32;
+
+/**
+ * @brief Builds a kernel descriptor, deriving MC and NC from the tile shape.
+ */
+template <typename T>
+GemmKernel<T> makeKernel(int mr, int nr, MicroKernel<T> run, const char* name) {
+    return GemmKernel<T>{mr, nr, mr * 16, 256, nr * 256, run, name};
+}
+
+/**
+ * @brief Picks the best micro-kernel the running CPU supports.
+ * Setting MATRIXLIB_GEMM_KERNEL to "avx2" or "generic" caps the choice (e.g. for benchmarking).
+ */
+template <typename T>
+GemmKernel<T> pickKernel() {
+#if MATRIXLIB_X86_KERNELS
+    if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+        constexpr int lanes512 = 64 / sizeof(T);
+        constexpr int lanes256 = 32 / sizeof(T);
+        const char* cap = std::getenv("MATRIXLIB_GEMM_KERNEL");
+        const std::string limit = cap ? cap : "";
+        __builtin_cpu_init();
+        if (limit.empty() && __builtin_cpu_supports("avx512f")) {
+            return makeKernel<T>(8, 2 * lanes512, static_cast<MicroKernel<T>>(&microKernelAvx512), "avx512");
+        }
+        if (limit != "generic" && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return makeKernel<T>(6, 2 * lanes256, static_cast<MicroKernel<T>>(&microKernelAvx2), "avx2");
+        }
+    }
+#endif
+    return makeKernel<T>(4, 8, &microKernelGeneric<T, 4, 8>, "generic");
+}
+
+/**
+ * @brief Returns the micro-kernel selected for T (resolved once per process).
+ */
+template <typename T>
+const GemmKernel<T>& gemmKernel() {
+    static const GemmKernel<T> kernel = pickKernel<T>();
+    return kernel;
+}
+
+/**
+ * @brief Packs an mc x kc block of A into MR-row panels, zero-padding the last panel.
+ */
+template <typename T>
+void packA(int mc, int kc, const T* a, std::ptrdiff_t rs, std::ptrdiff_t cs, int mr, T* buf) {
+    for (int i0 = 0; i0 < mc; i0 += mr) {
+        int rows = std::min(mr, mc - i0);
+        for (int p = 0; p < kc; p++) {
+            const T* src = a + i0 * rs + p * cs;
+            for (int i = 0; i < rows; i++) buf[i] = src[i * rs];
+            for (int i = rows; i < mr; i++) buf[i] = T{};
+            buf += mr;
+        }
+    }
+}
+
+/**
+ * @brief Packs a kc x nc panel of B into NR-column slivers, zero-padding the last sliver.
+ */
+template <typename T>
+void packB(int kc, int nc, const T* b, std::ptrdiff_t rs, std::ptrdiff_t cs, int nr, T* buf) {
+    for (int j0 = 0; j0 < nc; j0 += nr) {
+        int cols = std::min(nr, nc - j0);
+        for (int p = 0; p < kc; p++) {
+            const T* src = b + p * rs + j0 * cs;
+            for (int j = 0; j < cols; j++) buf[j] = src[j * cs];
+            for (int j = cols; j < nr; j++) buf[j] = T{};
+            buf += nr;
+        }
+    }
+}
+
+/**
+ * @brief Scales C by beta (overwriting with zero when beta is zero).
+ */
+template <typename T>
+void scaleOutput(int m, int n, T beta, T* c, std::ptrdiff_t ldc) {
+    for (int i = 0; i < m; i++) {
+        T* ci = c + i * ldc;
+        for (int j = 0; j < n; j++) {
+            ci[j] = (beta == static_cast<T>(0)) ? T{} : beta * ci[j];
+        }
+    }
+}
+
+/**
+ * @brief Unblocked reference loop used for products too small to amortize packing.
+ */
+template <typename T>
+void gemmSmall(int m, int n, int k, T alpha,
+               const T* a, std::ptrdiff_t rsA, std::ptrdiff_t csA,
+               const T* b, std::ptrdiff_t rsB, std::ptrdiff_t csB,
+               T beta, T* c, std::ptrdiff_t ldc) {
+    scaleOutput(m, n, beta, c, ldc);
+    for (int i = 0; i < m; i++) {
+        T* ci = c + i * ldc;
+        for (int p = 0; p < k; p++) {
+            const T aip = alpha * a[i * rsA + p * csA];
+            const T* bp = b + p * rsB;
+            for (int j = 0; j < n; j++) {
+                ci[j] += aip * bp[j * csB];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Runs the register-tiled kernel over one packed mc x nc block of C.
+ * Partial edge tiles are computed into a local tile and merged.
+ */
+template <typename T>
+void gemmMacroKernel(const GemmKernel<T>& kernel, int mc, int nc, int kc, T alpha,
+                     const T* packedA, const T* packedB, T beta, T* c, std::ptrdiff_t ldc) {
+    const int mr = kernel.mr;
+    const int nr = kernel.nr;
+    alignas(64) T tile[maxTileSize];
+    for (int jr = 0; jr < nc; jr += nr) {
+        const int cols = std::min(nr, nc - jr);
+        const T* b = packedB + static_cast<std::size_t>(jr) * kc;
+        for (int ir = 0; ir < mc; ir += mr) {
+            const int rows = std::min(mr, mc - ir);
+            const T* a = packedA + static_cast<std::size_t>(ir) * kc;
+            T* cij = c + ir * ldc + jr;
+            if (rows == mr && cols == nr) {
+                kernel.run(kc, a, b, cij, ldc, alpha, beta);
+                continue;
+            }
+            kernel.run(kc, a, b, tile, nr, alpha, T{});
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j < cols; j++) {
+                    T& dst = cij[i * ldc + j];
+                    dst = (beta == static_cast<T>(0)) ? tile[i * nr + j] : beta * dst + tile[i * nr + j];
+                }
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief General matrix multiply: C = alpha * A * B + beta * C.
+ * A is m x k, B is k x n and C is m x n. Element (i, j) of A lives at a[i * rsA + j * csA]
+ * (likewise for B), so a transposed operand is passed by swapping its strides.
+ * C must be row-major with row stride ldc and must not alias A or B.
+ * @param m Rows of A and C.
+ * @param n Columns of B and C.
+ * @param k Columns of A and rows of B.
+ * @note Example: gemm(m, n, k, 1.0, A, lda, 1, B, ldb, 1, 0.0, C, ldc);
+ */
+template <typename T>
+void gemm(int m, int n, int k, T alpha,
+          const T* a, std::ptrdiff_t rsA, std::ptrdiff_t csA,
+          const T* b, std::ptrdiff_t rsB, std::ptrdiff_t csB,
+          T beta, T* c, std::ptrdiff_t ldc) {
+    if (m <= 0 || n <= 0) {
+        return;
+    }
+    if (k <= 0 || alpha == static_cast<T>(0)) {
+        detail::scaleOutput(m, n, beta, c, ldc);
+        return;
+    }
+    if (static_cast<long long>(m) * n * k <= 32 * 32 * 32) {
+        detail::gemmSmall(m, n, k, alpha, a, rsA, csA, b, rsB, csB, beta, c, ldc);
+        return;
+    }
+
+    const detail::GemmKernel<T>& kernel = detail::gemmKernel<T>();
+    //Packed panels come from the thread's scratch arena and are sized to the operands;
+    //packing writes every slot, so the memory is never cleared
+    ScratchScope scope;
+    const std::size_t packed_cols = static_cast<std::size_t>((std::min(kernel.nc, n) + kernel.nr - 1) / kernel.nr) * kernel.nr;
+    T* packedB = scope.allocate<T>(static_cast<std::size_t>(std::min(kernel.kc, k)) * packed_cols);
+
+    ThreadPool& pool = ThreadPool::instance();
+    const bool parallel = pool.size() > 1 && static_cast<long long>(m) * n * k >= 96LL * 96 * 96;
+    const int blocks_m = (m + kernel.mc - 1) / kernel.mc;
+
+    for (int jc = 0; jc < n; jc += kernel.nc) {
+        const int nc = std::min(kernel.nc, n - jc);
+        const int slivers = (nc + kernel.nr - 1) / kernel.nr;
+
+        //Narrow the column tiles until there are enough tiles to keep every thread busy
+        int tile_n = slivers * kernel.nr;
+        while (parallel && tile_n > kernel.nr && blocks_m * ((nc + tile_n - 1) / tile_n) < 4 * pool.size()) {
+            tile_n = std::max(kernel.nr, (tile_n / 2 + kernel.nr - 1) / kernel.nr * kernel.nr);
+        }
+
+        for (int pc = 0; pc < k; pc += kernel.kc) {
+            const int kc = std::min(kernel.kc, k - pc);
+            const T beta_block = (pc == 0) ? beta : static_cast<T>(1);
+            const T* b_panel = b + pc * rsB + jc * csB;
+
+            auto pack_sliver = [&](int s) {
+                const int j0 = s * kernel.nr;
+                detail::packB(kc, std::min(kernel.nr, nc - j0), b_panel + j0 * csB, rsB, csB, kernel.nr,
+                              packedB + static_cast<std::size_t>(j0) * kc);
+            };
+            auto compute_tile = [&](int r0, int r1, int c0, int c1) {
+                //Tiles run on pool threads, so A is packed into the arena of whichever thread runs this one
+                ScratchScope tile_scope;
+                T* packedA = tile_scope.allocate<T>(static_cast<std::size_t>(r1 - r0 + kernel.mr - 1) / kernel.mr * kernel.mr * kc);
+                detail::packA(r1 - r0, kc, a + r0 * rsA + pc * csA, rsA, csA, kernel.mr, packedA);
+                detail::gemmMacroKernel(kernel, r1 - r0, c1 - c0, kc, alpha, packedA,
+                                        packedB + static_cast<std::size_t>(c0) * kc,
+                                        beta_block, c + r0 * ldc + jc + c0, ldc);
+            };
+
+            if (parallel) {
+                pool.parallelFor(slivers, pack_sliver, 8);
+                pool.parallelFor2D(m, nc, kernel.mc, tile_n, compute_tile);
+            } else {
+                for (int s = 0; s < slivers; s++) pack_sliver(s);
+                for (int ic = 0; ic < m; ic += kernel.mc) {
+                    compute_tile(ic, std::min(m, ic + kernel.mc), 0, nc);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Name of the micro-kernel gemm() uses for T on this CPU ("avx512", "avx2" or "generic").
+ * @note Example: std::cout << matrixlib::gemmKernelName<double>();
+ */
+template <typename T>
+const char* gemmKernelName() {
+    return detail::gemmKernel<T>().name;
+}
+
+} // namespace matrixlib
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <limits>
+#include "Instrumentation.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/**
+ * @class HugePageAllocator
+ * @brief Allocator for large matrices that asks the kernel to back them with 2 MiB pages.
+ * Buffers of at least one huge page are aligned to 2 MiB, rounded up to whole huge pages and
+ * marked with madvise(MADV_HUGEPAGE) before first touch, so transparent huge pages cut TLB misses
+ * on big GEMM and transpose sweeps. Smaller buffers are served 64-byte aligned like AlignedAllocator.
+ * On systems without transparent huge pages the hint is ignored and ordinary pages are used.
+ * @note Example: Matrix<double, HugePageAllocator<double>> big(20000, 20000);
+ */
+template <typename T>
+class HugePageAllocator
+{
+public:
+    using value_type = T;
+    static constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+    static constexpr std::size_t small_alignment = 64;
+
+    template <typename U>
+    struct rebind { using other = HugePageAllocator<U>; };
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    /**
+     * @brief Allocates uninitialized storage for n objects of type T.
+     * @throws std::bad_array_new_length if n is too large, std::bad_alloc on failure.
+     */
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T) - huge_page_size) {
+            throw std::bad_array_new_length();
+        }
+        const std::size_t bytes = n * sizeof(T);
+        MATRIXLIB_RECORD_ALLOCATION(bytes);
+        if (bytes < huge_page_size) {
+            return static_cast<T*>(::operator new(bytes, std::align_val_t{small_alignment}));
+        }
+        const std::size_t rounded = roundedSize(bytes);
+        void* p = ::operator new(rounded, std::align_val_t{huge_page_size});
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        ::madvise(p, rounded, MADV_HUGEPAGE);
+#endif
+        return static_cast<T*>(p);
+    }
+
+    /**
+     * @brief Releases storage obtained from allocate() with the same n.
+     */
+    void deallocate(T* p, std::size_t n) noexcept {
+        const std::size_t bytes = n * sizeof(T);
+        if (bytes < huge_page_size) {
+            ::operator delete(p, bytes, std::align_val_t{small_alignment});
+        } else {
+            ::operator delete(p, roundedSize(bytes), std::align_val_t{huge_page_size});
+        }
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+
+private:
+    static std::size_t roundedSize(std::size_t bytes) {
+        return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+};
@@ -0,0 +1,485 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * @file Instrumentation.hpp
+ * @brief Opt-in per-operation counters (calls, FLOPs, bytes, allocations, time) and trace events.
+ *
+ * Build with MATRIXLIB_INSTRUMENTATION=1 (CMake option of the same name) to record every call of
+ * the instrumented Matrix and Square_Matrix operations. Without it the hooks expand to nothing,
+ * so they cost nothing, and snapshots are empty. The flag must be the same in every translation
+ * unit of a program, since the instrumented functions are inline.
+ *
+ * Each thread owns a fixed table of counters keyed by operation and shape (rows, cols, inner
+ * dimension). Only the owning thread writes its table, with plain relaxed atomic stores, so
+ * recording never locks or contends; snapshot() reads all tables concurrently and merges them.
+ * When tracing is switched on, every call is also logged as a complete event into a per-thread
+ * buffer, written out in the Chrome trace format (chrome://tracing, Perfetto).
+ */
+#ifndef MATRIXLIB_INSTRUMENTATION
+#define MATRIXLIB_INSTRUMENTATION 0
+#endif
+
+namespace matrixlib::instrumentation {
+
+/**
+ * @brief Instrumented operations.
+ */
+enum class Operation : std::uint8_t {
+    MultiplyByMatrix,
+    MultiplyAdd,
+    AddMatrix,
+    SubtractMatrix,
+    MultiplyByConstant,
+    DivideByConstant,
+    AddScaled,
+    Reduce,
+    Expression,
+    Transpose,
+    Determinant,
+    Inverse,
+    RankUpdate,
+    Count
+};
+
+/**
+ * @brief Name of an operation as used in JSON, Prometheus labels and trace events.
+ */
+inline const char* operationName(Operation op) {
+    static constexpr const char* names[] = {
+        "multiplyByMatrix", "multiplyAdd", "addMatrix", "subtractMatrix", "multiplyByConstant",
+        "divideByConstant", "addScaled", "reduce", "expression", "transpose", "determinant", "inverse",
+        "rankUpdate"
+    };
+    const auto index = static_cast<std::size_t>(op);
+    return index < static_cast<std::size_t>(Operation::Count) ? names[index] : "unknown";
+}
+
+/**
+ * @struct ShapeStats
+ * @brief Totals for one operation at one shape, summed over all threads.
+ */
+struct ShapeStats {
+    Operation op;
+    int rows;  //Rows of the result (-1 for the overflow entry of the operation)
+    int cols;  //Columns of the result
+    int inner; //Inner dimension of products, 0 for the other operations
+    std::uint64_t calls = 0;
+    std::uint64_t flops = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t allocated_bytes = 0;
+    std::uint64_t nanoseconds = 0;
+};
+
+namespace detail {
+
+inline constexpr int table_slots = 1024;
+inline constexpr int trace_capacity = 1 << 16;
+
+/**
+ * @brief Counters of one (operation, shape) slot. The key is written once by the owning thread
+ * before used is published; counters are only ever written by the owning thread.
+ */
+struct Slot {
+    std::atomic<bool> used{false};
+    Operation op{};
+    int rows = 0;
+    int cols = 0;
+    int inner = 0;
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> flops{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> allocated_bytes{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+};
+
+/**
+ * @brief One complete trace event.
+ */
+struct TraceEvent {
+    Operation op;
+    int rows;
+    int cols;
+    int inner;
+    std::int64_t start_ns;
+    std::int64_t duration_ns;
+};
+
+/**
+ * @brief Single-writer add: only the owning thread updates a counter, so no RMW is needed.
+ */
+inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counters and trace buffer owned by one thread. Kept alive after the thread exits so
+ * its numbers stay in later snapshots.
+ */
+struct ThreadRecord {
+    int thread_id = 0;
+    Slot slots[table_slots];
+    Slot overflow[static_cast<std::size_t>(Operation::Count)];
+    std::atomic<std::uint64_t> allocations{0};      //Heap allocations made by this thread so far
+    std::atomic<std::uint64_t> allocated_bytes{0};
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<int> event_count{0};
+    std::atomic<std::uint64_t> events_dropped{0};
+
+    /**
+     * @brief Finds or claims the slot of a shape; falls back to the operation's overflow slot.
+     */
+    Slot& slot(Operation op, int rows, int cols, int inner) {
+        std::uint64_t hash = static_cast<std::uint64_t>(op) * 0x9E3779B97F4A7C15ULL;
+        hash = (hash ^ static_cast<std::uint32_t>(rows)) * 0xBF58476D1CE4E5B9ULL;
+        hash = (hash ^ static_cast<std::uint32_t>(cols)) * 0x94D049BB133111EBULL;
+        hash = (hash ^ static_cast<std::uint32_t>(inner)) * 0x9E3779B97F4A7C15ULL;
+        const int start = static_cast<int>((hash >> 32) % table_slots);
+        for (int probe = 0; probe < table_slots; probe++) {
+            Slot& s = slots[(start + probe) % table_slots];
+            if (!s.used.load(std::memory_order_relaxed)) {
+                s.op = op;
+                s.rows = rows;
+                s.cols = cols;
+                s.inner = inner;
+                s.used.store(true, std::memory_order_release);
+                return s;
+            }
+            if (s.op == op && s.rows == rows && s.cols == cols && s.inner == inner) {
+                return s;
+            }
+        }
+        Slot& s = overflow[static_cast<std::size_t>(op)];
+        if (!s.used.load(std::memory_order_relaxed)) {
+            s.op = op;
+            s.rows = -1;
+            s.cols = -1;
+            s.inner = -1;
+            s.used.store(true, std::memory_order_release);
+        }
+        return s;
+    }
+};
+
+/**
+ * @brief Every ThreadRecord ever created; locked only when a thread registers or a snapshot is taken.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadRecord>> records;
+    std::atomic<bool> tracing{false};
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    static Registry& instance() {
+        //Never destroyed, so threads still running at exit can keep recording
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+};
+
+/**
+ * @brief The calling thread's record, registered on first use.
+ */
+inline ThreadRecord& threadRecord() {
+    thread_local ThreadRecord* record = [] {
+        Registry& registry = Registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.records.push_back(std::make_unique<ThreadRecord>());
+        registry.records.back()->thread_id = static_cast<int>(registry.records.size());
+        return registry.records.back().get();
+    }();
+    return *record;
+}
+
+/**
+ * @brief Writes count / 10^decimals in fixed notation with every digit (no float rounding).
+ */
+inline void writeScaled(std::ostream& out, std::uint64_t count, int decimals) {
+    std::uint64_t scale = 1;
+    for (int i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+    out << count / scale << '.';
+    for (std::uint64_t digit = scale / 10; digit > 0; digit /= 10) {
+        out << static_cast<char>('0' + count / digit % 10);
+    }
+}
+
+inline std::int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - Registry::instance().epoch).count();
+}
+
+} // namespace detail
+
+/**
+ * @brief Counts one heap allocation of the calling thread (called by the library's allocators).
+ */
+inline void recordAllocation(std::size_t bytes) {
+    detail::ThreadRecord& record = detail::threadRecord();
+    detail::bump(record.allocations, 1);
+    detail::bump(record.allocated_bytes, bytes);
+}
+
+/**
+ * @class ScopedOperation
+ * @brief Records one call of an operation at a given shape. The call is counted on construction;
+ * the elapsed time and the allocations the calling thread made meanwhile are added on destruction.
+ * Use through MATRIXLIB_INSTRUMENT, which compiles to nothing when instrumentation is off.
+ */
+class ScopedOperation
+{
+private:
+    detail::ThreadRecord& m_record;
+    detail::Slot& m_slot;
+    std::int64_t m_start;
+    std::uint64_t m_allocations;
+    std::uint64_t m_allocated_bytes;
+
+public:
+    ScopedOperation(Operation op, int rows, int cols, int inner, double flops, double bytes)
+        : m_record(detail::threadRecord()), m_slot(m_record.slot(op, rows, cols, inner)),
+          m_start(detail::nowNanoseconds()),
+          m_allocations(m_record.allocations.load(std::memory_order_relaxed)),
+          m_allocated_bytes(m_record.allocated_bytes.load(std::memory_order_relaxed)) {
+        detail::bump(m_slot.calls, 1);
+        detail::bump(m_slot.flops, static_cast<std::uint64_t>(flops));
+        detail::bump(m_slot.bytes, static_cast<std::uint64_t>(bytes));
+    }
+
+    ~ScopedOperation() {
+        const std::int64_t end = detail::nowNanoseconds();
+        detail::bump(m_slot.nanoseconds, static_cast<std::uint64_t>(end - m_start));
+        detail::bump(m_slot.allocations, m_record.allocations.load(std::memory_order_relaxed) - m_allocations);
+        detail::bump(m_slot.allocated_bytes, m_record.allocated_bytes.load(std::memory_order_relaxed) - m_allocated_bytes);
+        if (!detail::Registry::instance().tracing.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (!m_record.events) {
+            m_record.events = std::make_unique<detail::TraceEvent[]>(detail::trace_capacity);
+        }
+        const int index = m_record.event_count.load(std::memory_order_relaxed);
+        if (index == detail::trace_capacity) {
+            detail::bump(m_record.events_dropped, 1);
+            return;
+        }
+        m_record.events[index] = {m_slot.op, m_slot.rows, m_slot.cols, m_slot.inner, m_start, end - m_start};
+        m_record.event_count.store(index + 1, std::memory_order_release);
+    }
+
+    ScopedOperation(const ScopedOperation&) = delete;
+    ScopedOperation& operator=(const ScopedOperation&) = delete;
+};
+
+/**
+ * @class Snapshot
+ * @brief Counters of all threads merged per operation and shape, heaviest (by time) first.
+ */
+class Snapshot
+{
+private:
+    std::vector<ShapeStats> m_entries;
+
+public:
+    explicit Snapshot(std::vector<ShapeStats> entries) : m_entries(std::move(entries)) {}
+
+    /**
+     * @brief Returns one entry per (operation, shape) seen, sorted by total time, largest first.
+     */
+    const std::vector<ShapeStats>& entries() const { return m_entries; }
+
+    /**
+     * @brief Writes the snapshot as a JSON document: {"operations": [{...}, ...]}.
+     * @note Example: matrixlib::instrumentation::snapshot().writeJson(std::cout);
+     */
+    void writeJson(std::ostream& out) const {
+        out << "{\"operations\": [";
+        for (std::size_t i = 0; i < m_entries.size(); i++) {
+            const ShapeStats& e = m_entries[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "  {\"op\": \"" << operationName(e.op) << "\", \"rows\": " << e.rows
+                << ", \"cols\": " << e.cols << ", \"inner\": " << e.inner
+                << ", \"calls\": " << e.calls << ", \"flops\": " << e.flops << ", \"bytes\": " << e.bytes
+                << ", \"allocations\": " << e.allocations << ", \"allocated_bytes\": " << e.allocated_bytes
+                << ", \"seconds\": ";
+            detail::writeScaled(out, e.nanoseconds, 9);
+            out << "}";
+        }
+        out << "\n]}\n";
+    }
+
+    /**
+     * @brief Writes the snapshot in the Prometheus text exposition format, one counter family
+     * per quantity, labelled by operation and shape.
+     * @note Example: matrixlib::instrumentation::snapshot().writePrometheus(response);
+     */
+    void writePrometheus(std::ostream& out) const {
+        struct Family {
+            const char* name;
+            const char* help;
+            std::uint64_t ShapeStats::*counter;
+        };
+        static const Family families[] = {
+            {"matrixlib_calls_total", "Calls per operation and shape.", &ShapeStats::calls},
+            {"matrixlib_flops_total", "Floating point operations per operation and shape.", &ShapeStats::flops},
+            {"matrixlib_bytes_total", "Bytes of matrix data touched per operation and shape.", &ShapeStats::bytes},
+            {"matrixlib_allocations_total", "Heap allocations made by the calling thread.", &ShapeStats::allocations},
+            {"matrixlib_allocated_bytes_total", "Heap bytes allocated by the calling thread.", &ShapeStats::allocated_bytes},
+            {"matrixlib_seconds_total", "Wall time spent per operation and shape.", &ShapeStats::nanoseconds},
+        };
+        for (const Family& family : families) {
+            out << "# HELP " << family.name << ' ' << family.help << '\n';
+            out << "# TYPE " << family.name << " counter\n";
+            for (const ShapeStats& e : m_entries) {
+                out << family.name << "{op=\"" << operationName(e.op) << "\",rows=\"" << e.rows
+                    << "\",cols=\"" << e.cols << "\",inner=\"" << e.inner << "\"} ";
+                if (family.counter == &ShapeStats::nanoseconds) {
+                    detail::writeScaled(out, e.nanoseconds, 9);
+                } else {
+                    out << e.*family.counter;
+                }
+                out << '\n';
+            }
+        }
+    }
+};
+
+/**
+ * @brief Merges the counters of every thread into a snapshot. Safe to call while operations run.
+ * @note Example: matrixlib::instrumentation::snapshot().writePrometheus(std::cout);
+ */
+inline Snapshot snapshot() {
+    std::map<std::tuple<Operation, int, int, int>, ShapeStats> merged;
+    detail::Registry& registry = detail::Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto merge = [&](const detail::Slot& s) {
+        if (!s.used.load(std::memory_order_acquire)) {
+            return;
+        }
+        auto [it, inserted] = merged.try_emplace(std::make_tuple(s.op, s.rows, s.cols, s.inner),
+                                                 ShapeStats{s.op, s.rows, s.cols, s.inner});
+        ShapeStats& e = it->second;
+        e.calls += s.calls.load(std::memory_order_relaxed);
+        e.flops += s.flops.load(std::memory_order_relaxed);
+        e.bytes += s.bytes.load(std::memory_order_relaxed);
+        e.allocations += s.allocations.load(std::memory_order_relaxed);
+        e.allocated_bytes += s.allocated_bytes.load(std::memory_order_relaxed);
+        e.nanoseconds += s.nanoseconds.load(std::memory_order_relaxed);
+    };
+    for (const auto& record : registry.records) {
+        for (const detail::Slot& s : record->slots) {
+            merge(s);
+        }
+        for (const detail::Slot& s : record->overflow) {
+            merge(s);
+        }
+    }
+    std::vector<ShapeStats> entries;
+    entries.reserve(merged.size());
+    for (const auto& [key, stats] : merged) {
+        entries.push_back(stats);
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const ShapeStats& a, const ShapeStats& b) {
+        return a.nanoseconds > b.nanoseconds;
+    });
+    return Snapshot(std::move(entries));
+}
+
+/**
+ * @brief Zeroes all counters and discards recorded trace events.
+ * @note Call while no instrumented operation is running; concurrent calls may keep counts
+ * from before the reset.
+ */
+inline void reset() {
+    detail::Registry& registry = detail::Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& record : registry.records) {
+        for (detail::Slot& s : record->slots) {
+            s.calls = 0;
+            s.flops = 0;
+            s.bytes = 0;
+            s.allocations = 0;
+            s.allocated_bytes = 0;
+            s.nanoseconds = 0;
+        }
+        for (detail::Slot& s : record->overflow) {
+            s.calls = 0;
+            s.flops = 0;
+            s.bytes = 0;
+            s.allocations = 0;
+            s.allocated_bytes = 0;
+            s.nanoseconds = 0;
+        }
+        record->event_count.store(0, std::memory_order_relaxed);
+        record->events_dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Switches recording of trace events on or off (off by default). Each thread keeps up to
+ * 65536 events; further events are dropped and counted.
+ * @note Example: matrixlib::instrumentation::setTracing(true);
+ */
+inline void setTracing(bool enabled) {
+    detail::Registry::instance().tracing.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Writes all recorded events in the Chrome trace event format (JSON object form).
+ * Timestamps are microseconds since the first instrumented call of the process.
+ * @note Example: std::ofstream out("matrixlib.trace.json"); matrixlib::instrumentation::writeChromeTrace(out);
+ */
+inline void writeChromeTrace(std::ostream& out) {
+    detail::Registry& registry = detail::Registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    out << "{\"traceEvents\": [";
+    bool first = true;
+    std::uint64_t dropped = 0;
+    for (const auto& record : registry.records) {
+        const int count = record->event_count.load(std::memory_order_acquire);
+        dropped += record->events_dropped.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; i++) {
+            const detail::TraceEvent& e = record->events[i];
+            out << (first ? "\n" : ",\n")
+                << "  {\"name\": \"" << operationName(e.op) << "\", \"cat\": \"matrixlib\", \"ph\": \"X\""
+                << ", \"ts\": ";
+            detail::writeScaled(out, static_cast<std::uint64_t>(e.start_ns), 3);
+            out << ", \"dur\": ";
+            detail::writeScaled(out, static_cast<std::uint64_t>(e.duration_ns), 3);
+            out << ", \"pid\": 1, \"tid\": " << record->thread_id
+                << ", \"args\": {\"rows\": " << e.rows << ", \"cols\": " << e.cols << ", \"inner\": " << e.inner << "}}";
+            first = false;
+        }
+    }
+    out << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+}
+
+} // namespace matrixlib::instrumentation
+
+/**
+ * @brief Records the enclosing scope as one call of an instrumented operation.
+ * @param op Name of a matrixlib::instrumentation::Operation enumerator.
+ * Arguments are not evaluated when instrumentation is compiled out.
+ */
+#if MATRIXLIB_INSTRUMENTATION
+#define MATRIXLIB_INSTRUMENT(op, rows, cols, inner, flops, bytes)                                  \
+    ::matrixlib::instrumentation::ScopedOperation matrixlib_instrumented_scope_(                   \
+        ::matrixlib::instrumentation::Operation::op, (rows), (cols), (inner), (flops), (bytes))
+#define MATRIXLIB_RECORD_ALLOCATION(bytes) ::matrixlib::instrumentation::recordAllocation(bytes)
+#else
+#define MATRIXLIB_INSTRUMENT(op, rows, cols, inner, flops, bytes) static_cast<void>(0)
+#define MATRIXLIB_RECORD_ALLOCATION(bytes) static_cast<void>(0)
+#endif
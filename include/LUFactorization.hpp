@@ -0,0 +1,261 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <memory>
+#include <utility>
+#include "Matrix.hpp"
+#include "Gemm.hpp"
+#include "TriangularSolve.hpp"
+
+/**
+ * @class LU_Factorization
+ * @brief LU factorization with partial pivoting, P * A = L * U, computed in O(n^3).
+ * L (unit lower triangle) and U (upper triangle) are stored packed in one n x n matrix together
+ * with the row pivots, so one factorization can be reused for many right-hand sides.
+ * The factorization is blocked: each panel of columns is factored unblocked, and the trailing
+ * submatrix is updated with one cache-blocked GEMM per panel.
+ * The factors and pivots are stored with Alloc, so a factorization of scratch data can live
+ * entirely in the thread's ScratchArena (LU_Factorization<T, matrixlib::ArenaAllocator<T>>).
+ * @note Intended for floating point types (float/double).
+ * @note Example: LU_Factorization<double> lu = sq.lu(); Matrix<double> x = lu.solve(b);
+ */
+template <typename T, typename Alloc = AlignedAllocator<T>>
+class LU_Factorization
+{
+public:
+    using pivot_vector = std::vector<int, typename std::allocator_traits<Alloc>::template rebind_alloc<int>>;
+
+private:
+    static constexpr int block_size = 64;
+
+    Matrix<T, Alloc> m_lu;
+    pivot_vector m_pivots; //Row i was swapped with row m_pivots[i] at step i
+    int m_sign = 1;            //Sign of the permutation, +1 or -1
+    bool m_singular = false;
+
+    /**
+     * @brief Factors columns [k0, k0 + kb) of the trailing rows without blocking.
+     * Row swaps are applied across the full width of the matrix.
+     */
+    void factorPanel(int k0, int kb) {
+        const int n = m_lu.getRows();
+        for (int j = k0; j < k0 + kb; j++) {
+            int pivot = j;
+            T best = std::abs(m_lu(j, j));
+            for (int i = j + 1; i < n; i++) {
+                T candidate = std::abs(m_lu(i, j));
+                if (candidate > best) {
+                    best = candidate;
+                    pivot = i;
+                }
+            }
+            m_pivots[j] = pivot;
+            if (pivot != j) {
+                std::swap_ranges(m_lu.rowData(j), m_lu.rowData(j) + n, m_lu.rowData(pivot));
+                m_sign = -m_sign;
+            }
+
+            const T diag = m_lu(j, j);
+            if (diag == static_cast<T>(0)) {
+                m_singular = true;
+                continue;
+            }
+            const T* row_j = m_lu.rowData(j);
+            for (int i = j + 1; i < n; i++) {
+                T* row_i = m_lu.rowData(i);
+                const T l = row_i[j] / diag;
+                row_i[j] = l;
+                for (int c = j + 1; c < k0 + kb; c++) {
+                    row_i[c] -= l * row_j[c];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Runs the blocked right-looking factorization over the whole matrix.
+     */
+    void factor() {
+        const int n = m_lu.getRows();
+        const std::ptrdiff_t ld = m_lu.getStride();
+        for (int k0 = 0; k0 < n; k0 += block_size) {
+            const int kb = std::min(block_size, n - k0);
+            const int rest = n - k0 - kb;
+            factorPanel(k0, kb);
+            if (rest == 0) {
+                continue;
+            }
+
+            //U12 = L11^-1 * A12 (L11 is unit lower triangular)
+            for (int i = k0 + 1; i < k0 + kb; i++) {
+                T* row_i = m_lu.rowData(i) + k0 + kb;
+                for (int p = k0; p < i; p++) {
+                    const T l = m_lu(i, p);
+                    const T* row_p = m_lu.rowData(p) + k0 + kb;
+                    for (int c = 0; c < rest; c++) {
+                        row_i[c] -= l * row_p[c];
+                    }
+                }
+            }
+
+            //A22 -= L21 * U12
+            matrixlib::gemm<T>(rest, rest, kb, static_cast<T>(-1),
+                               m_lu.rowData(k0 + kb) + k0, ld, 1,
+                               m_lu.rowData(k0) + k0 + kb, ld, 1,
+                               static_cast<T>(1), m_lu.rowData(k0 + kb) + k0 + kb, ld);
+        }
+    }
+
+public:
+    /**
+     * @brief Factors a square matrix.
+     * @param a The matrix to factor.
+     * @throws std::invalid_argument if the matrix is not square.
+     * @note Example: LU_Factorization<double> lu(mat);
+     */
+    explicit LU_Factorization(const Matrix<T, Alloc>& a) : m_lu(a), m_pivots(a.getRows()) {
+        if (a.getRows() != a.getCols()) {
+            throw std::invalid_argument("LU factorization requires a square matrix.\n");
+        }
+        factor();
+    }
+
+    /**
+     * @brief Factors a temporary square matrix in its own buffer, without copying it.
+     * @param a The matrix to factor (consumed).
+     * @throws std::invalid_argument if the matrix is not square.
+     * @note Example: LU_Factorization<double> lu(std::move(mat));
+     */
+    explicit LU_Factorization(Matrix<T, Alloc>&& a) : m_lu(std::move(a)), m_pivots(m_lu.getRows()) {
+        if (m_lu.getRows() != m_lu.getCols()) {
+            throw std::invalid_argument("LU factorization requires a square matrix.\n");
+        }
+        factor();
+    }
+
+    /**
+     * @brief Returns the dimension of the factored matrix.
+     */
+    int size() const { return m_lu.getRows(); }
+
+    /**
+     * @brief Returns L and U packed together: U on and above the diagonal, L (unit diagonal omitted) below.
+     */
+    const Matrix<T, Alloc>& packed() const { return m_lu; }
+
+    /**
+     * @brief Returns the pivot sequence: at step i, row i was exchanged with row pivots()[i].
+     */
+    const pivot_vector& pivots() const { return m_pivots; }
+
+    /**
+     * @brief Checks whether a zero pivot was met (the matrix is singular).
+     */
+    bool isSingular() const { return m_singular; }
+
+    /**
+     * @brief Calculates the determinant as the signed product of U's diagonal.
+     * @return The determinant value (zero for singular matrices).
+     * @note Example: double det = lu.determinant();
+     */
+    T determinant() const {
+        if (m_singular) {
+            return static_cast<T>(0);
+        }
+        T det = static_cast<T>(m_sign);
+        for (int i = 0; i < size(); i++) {
+            det *= m_lu(i, i);
+        }
+        return det;
+    }
+
+    /**
+     * @brief Solves A * X = B in place: B is overwritten with X, nothing is allocated.
+     * @param x Right-hand sides, one per column (n x k); receives the solution. Any allocator.
+     * @throws std::invalid_argument if B has the wrong number of rows or A is singular.
+     * @note Example: lu.solveInPlace(b);
+     */
+    template <typename XAlloc>
+    void solveInPlace(Matrix<T, XAlloc>& x) const {
+        const int n = size();
+        if (x.getRows() != n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        if (m_singular) {
+            throw std::invalid_argument("Cannot solve: matrix is singular.\n");
+        }
+        const int k = x.getCols();
+
+        for (int i = 0; i < n; i++) {
+            if (m_pivots[i] != i) {
+                std::swap_ranges(x.rowData(i), x.rowData(i) + k, x.rowData(m_pivots[i]));
+            }
+        }
+        //L * U * X = P * B: forward substitution with unit lower L, then back substitution with U
+        const std::ptrdiff_t ld = m_lu.getStride();
+        matrixlib::trsm<T>(matrixlib::Triangle::Lower, true, n, k, m_lu.rowData(0), ld, 1, x.rowData(0), x.getStride());
+        matrixlib::trsm<T>(matrixlib::Triangle::Upper, false, n, k, m_lu.rowData(0), ld, 1, x.rowData(0), x.getStride());
+    }
+
+    /**
+     * @brief Solves A * X = B for every column of B at once.
+     * @param b Right-hand sides, one per column (n x k).
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if B has the wrong number of rows or A is singular.
+     * @note Example: Matrix<double> x = lu.solve(b);
+     */
+    template <typename BAlloc>
+    Matrix<T, BAlloc> solve(const Matrix<T, BAlloc>& b) const {
+        Matrix<T, BAlloc> x(b);
+        solveInPlace(x);
+        return x;
+    }
+
+    /**
+     * @brief Solves A * X = B, reusing the buffer of a temporary B for the solution.
+     * @note Example: Matrix<double> x = lu.solve(a * y);
+     */
+    template <typename BAlloc>
+    Matrix<T, BAlloc> solve(Matrix<T, BAlloc>&& b) const {
+        solveInPlace(b);
+        return std::move(b);
+    }
+
+    /**
+     * @brief Solves A * x = b for a single right-hand side vector.
+     * @param b Right-hand side of length n.
+     * @return The solution vector x.
+     * @throws std::invalid_argument if b has the wrong length or A is singular.
+     * @note Example: std::vector<double> x = lu.solve({1.0, 2.0, 3.0});
+     */
+    std::vector<T> solve(const std::vector<T>& b) const {
+        if (static_cast<int>(b.size()) != size()) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        Matrix<T, Alloc> rhs(size(), 1);
+        rhs.setColVal(0, b);
+        solveInPlace(rhs);
+        return rhs.getCol(0);
+    }
+
+    /**
+     * @brief Calculates the inverse by solving against the identity.
+     * @return The inverse matrix, stored with ResultAlloc (the factorization's allocator by default).
+     * @throws std::invalid_argument if the matrix is singular.
+     * @note Example: Matrix<double> inv = lu.inverse();
+     */
+    template <typename ResultAlloc = Alloc>
+    Matrix<T, ResultAlloc> inverse() const {
+        if (m_singular) {
+            throw std::invalid_argument("Cannot calculate inverse: Determinant is 0.\n");
+        }
+        Matrix<T, ResultAlloc> identity(size(), size());
+        for (int i = 0; i < size(); i++) {
+            identity(i, i) = static_cast<T>(1);
+        }
+        solveInPlace(identity);
+        return identity;
+    }
+};
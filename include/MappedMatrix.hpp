@@ -0,0 +1,141 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include "BinaryFormat.hpp"
+#include "MatrixView.hpp"
+#include "Matrix.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @class MappedMatrix
+ * @brief Read-only matrix backed by a memory-mapped file written by Matrix::save().
+ * Opening is O(1): nothing is parsed or copied, pages are faulted in by the OS on first access
+ * and shared with the page cache. The object is a MatrixView<const T> over the mapping, so it
+ * takes part in element-wise expressions and is multiplied by GEMM in place.
+ * The mapping is released when the MappedMatrix is destroyed; views taken from it must not outlive it.
+ * @note Files written with the other byte order cannot be mapped; use Matrix::load() for those.
+ * @note Example: MappedMatrix<double> w("weights.mtx"); Matrix<double> y = w * x;
+ */
+template <typename T>
+class MappedMatrix : public MatrixView<const T>
+{
+private:
+    void* m_mapping = nullptr;
+    std::size_t m_length = 0;
+
+    void release() {
+        if (m_mapping != nullptr) {
+            ::munmap(m_mapping, m_length);
+            m_mapping = nullptr;
+            m_length = 0;
+        }
+    }
+
+public:
+    /**
+     * @brief Maps a matrix file into memory.
+     * @param path File written by Matrix<T>::save().
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     * @throws std::invalid_argument if the file is not a matrix of T in native byte order.
+     * @note Example: MappedMatrix<float> m("embeddings.mtx");
+     */
+    explicit MappedMatrix(const std::string& path) : MatrixView<const T>(nullptr, 0, 0, 0, 1) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path + " for reading.\n");
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(matrixlib::BinaryHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Cannot read matrix file.\n");
+        }
+        m_length = static_cast<std::size_t>(info.st_size);
+        m_mapping = ::mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (m_mapping == MAP_FAILED) {
+            m_mapping = nullptr;
+            throw std::runtime_error("Cannot map " + path + ".\n");
+        }
+
+        try {
+            matrixlib::BinaryHeader header = *static_cast<const matrixlib::BinaryHeader*>(m_mapping);
+            if (matrixlib::detail::normalizeHeader<T>(header)) {
+                throw std::invalid_argument("Matrix file has a different byte order, use Matrix::load().\n");
+            }
+            //Compared by division: rows * stride * sizeof(T) can wrap for a crafted header
+            const std::uint64_t row_bytes = header.stride * sizeof(T);
+            const std::uint64_t available = m_length - sizeof(matrixlib::BinaryHeader);
+            if (row_bytes != 0 && header.rows > available / row_bytes) {
+                throw std::runtime_error("Matrix file is truncated.\n");
+            }
+            this->m_data = reinterpret_cast<const T*>(static_cast<const char*>(m_mapping) + sizeof(matrixlib::BinaryHeader));
+            this->m_rows = static_cast<int>(header.rows);
+            this->m_cols = static_cast<int>(header.cols);
+            this->m_row_stride = static_cast<std::ptrdiff_t>(header.stride);
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+    /**
+     * @brief Takes over the mapping of other, which is left empty (0x0).
+     */
+    MappedMatrix(MappedMatrix&& other) noexcept : MatrixView<const T>(other) {
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_length = std::exchange(other.m_length, 0);
+        other.m_data = nullptr;
+        other.m_rows = 0;
+        other.m_cols = 0;
+    }
+
+    MappedMatrix& operator=(MappedMatrix&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+            m_length = std::exchange(other.m_length, 0);
+            this->m_data = std::exchange(other.m_data, nullptr);
+            this->m_rows = std::exchange(other.m_rows, 0);
+            this->m_cols = std::exchange(other.m_cols, 0);
+            this->m_row_stride = other.m_row_stride;
+        }
+        return *this;
+    }
+
+    ~MappedMatrix() { release(); }
+
+    /**
+     * @brief Returns a plain view of the mapped elements.
+     * @note Example: auto top = mapped.view().block(0, 0, 10, 10);
+     */
+    MatrixView<const T> view() const { return *this; }
+
+    /**
+     * @brief Copies the mapped elements into an owning Matrix.
+     * @note Example: Matrix<double> m = mapped.toMatrix();
+     */
+    Matrix<T> toMatrix() const { return Matrix<T>(view()); }
+
+    /**
+     * @brief Hints the OS to start reading the whole payload in the background.
+     * @note Example: mapped.prefetch();
+     */
+    void prefetch() const {
+        if (m_mapping != nullptr) {
+            ::madvise(m_mapping, m_length, MADV_WILLNEED);
+        }
+    }
+};
+
+#endif
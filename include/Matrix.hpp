@@ -1,362 +1,1473 @@
-#pragma once
-#include <iostream>
-#include <vector>
-#include <iomanip>
-#include <stdexcept>
-
-/**
- * @class Matrix
- * @brief A template class for mathematical matrix operations.
- * Supports basic arithmetic, resizing, and matrix multiplication.
- */
-template <typename T> class Matrix
-{
-protected:
-    int m_row{};
-    int m_col{};
-    std::vector<std::vector<T>> data;
-
-    int precision = 3; //Default value of precision
-
-public:
-
-    /**
-     * @brief Constructs a Matrix with specified dimensions initialized to zero.
-     * @param row Number of rows.
-     * @param column Number of columns.
-     * @throws std::invalid_argument if dimensions are negative.
-     * @note Example: Matrix<int> mat(3, 3); // Creates a 3x3 zero matrix
-     */
-    Matrix(int row, int column) : m_row(row), m_col(column), data(row, std::vector<T>(column)) {
-        if (row < 0 || column < 0) {
-            throw std::invalid_argument("Number of rows and columns shall be greater than 0.\n");
-        }
-    };
-
-    /**
-     * @brief Constructs a Matrix from a 2D vector.
-     * @param value A vector of vectors containing the initial data.
-     * @note Example: Matrix<int> mat({{1, 2}, {3, 4}});
-     */
-    Matrix(std::vector<std::vector<T>> value) : m_row(value.size()), m_col(value[0].size()), data{value} {};
-
-    /**
-     * @brief Retrieves a single element from the matrix.
-     * @param row The row index.
-     * @param col The column index.
-     * @return The value at the specified position.
-     * @throws std::invalid_argument if indices are out of bounds.
-     * @note Example: double val = mat.getVal(21, 37);
-     */
-    T getValue(int row, int col) const {
-        if (row < 0 || row >= m_row || col < 0 || col >= m_col) {
-            throw std::invalid_argument("Index out of bounds.\n");
-        }
-        return data[row][col];
-    }
-
-    /**
-     * @brief Retrieves an entire row as a vector.
-     * @param row Index of the row to retrieve.
-     * @return A std::vector containing the row values.
-     * @throws std::invalid_argument if row index is out of bounds.
-     * @note Example: double val = mat.getRow(1);
-     */
-    std::vector<T> getRow(int row) const {
-        if (row < 0 || row >= m_row) {
-            throw std::invalid_argument("Row index out of bounds.\n");
-        }
-        return data[row];
-    }
-
-    /**
-     * @brief Retrieves an entire column as a vector.
-     * @param col Index of the column to retrieve.
-     * @return A std::vector containing the column values.
-     * @throws std::invalid_argument if column index is out of bounds.
-     * @note Example: double val = mat.getCol(4);
-     */
-    std::vector<T> getCol(int col) const {
-        if (col < 0 || col >= m_col) {
-            throw std::invalid_argument("Column index out of bounds.\n");
-        }
-
-        std::vector<T> column_vector;
-
-        for (int i = 0; i < m_row; i++) {
-            column_vector.push_back(data[i][col]);
-        }
-        return column_vector;
-    }
-
-    /**
-     * @brief Overwrites a specific row with new values.
-     * @param row The index of the row to replace.
-     * @param vec_of_val Vector containing the new values.
-     * @throws std::invalid_argument if the index is out of bounds or vector size is incorrect.
-     * @note Example: mat.setRowVal(0, {1, 2, 3});
-     */
-    void setRowVal(int row, std::vector<T> vec_of_val){
-        if (row >= m_row || row < 0){
-            throw std::invalid_argument("Index out of bounds, try using addRow().\n");
-        }
-        if (vec_of_val.size() != m_col){
-            throw std::invalid_argument("Size of vector isn't equal to number of columns.\n");
-        }
-        data[row] = vec_of_val;
-    }
-
-    /**
-     * @brief Overwrites a specific column with new values.
-     * @param column The index of the column to replace.
-     * @param vec_of_val Vector containing the new values.
-     * @throws std::invalid_argument if the index is out of bounds or vector size is incorrect.
-     * @note Example: mat.setColVal(1, {5, 6, 7});
-     */
-    void setColVal(int column, std::vector<T> vec_of_val){
-        if (column >= m_col || column < 0){
-            throw std::invalid_argument("Index out of bounds, try using addColumn().\n");
-        }
-
-        if (vec_of_val.size() != m_row) {
-            throw std::invalid_argument("Size of vector is not equal to number of rows.\n");
-        }
-
-        for (int i = 0; i < m_row; i++){
-            data[i][column] = vec_of_val[i];
-        }
-    }
-
-    /**
-     * @brief Prints the matrix to the standard output with formatted spacing.
-     * Uses fixed point notation and precision of .
-     * @note Example: mat.printMatrix();
-     */
-    void printMatrix() const {
-        std::cout << std::fixed << std::setprecision(precision);
-
-        for (int r = 0; r < m_row; r++){
-            for (int c = 0; c < m_col; c++){
-                std::cout << std::setw(10) << data[r][c] << " ";
-            }
-            std::cout << std::endl;
-        }
-        std::cout << "--------------------------------\n";
-    } 
-
-    /**
-     * @brief Appends a new row to the bottom of the matrix.
-     * @param vec_of_val Values for the new row.
-     * @note Example: mat.addRow({10, 11, 12});
-     */
-    void addRow(std::vector<T> vec_of_val){
-        if(vec_of_val.size() != m_col) {
-            throw std::invalid_argument("Size of vector is not equal to number of columns.\n");
-        }
-
-        data.push_back(vec_of_val);
-        m_row += 1;
-    }
-
-    /**
-     * @brief Appends a new column to the right side of the matrix.
-     * @param vec_of_val Values for the new column.
-     * @note Example: mat.addColumn({10, 11, 12});
-     */
-    void addColumn(std::vector<T> vec_of_val){
-        if (vec_of_val.size() != m_row){
-            throw std::invalid_argument("Size of vector is not equal to number of rows.\n");
-        }
-
-        for (int r = 0; r < m_row; r++){
-            data[r].push_back(vec_of_val[r]);
-        }
-        m_col += 1;
-    }
-
-    /**
-     * @brief Checks if two matrices have the same dimensions.
-     * @param other The matrix to compare against.
-     * @return true if rows and columns match, false otherwise.
-     */
-    bool checkIfSameSize(const Matrix &other) const {
-        return (m_row == other.m_row && m_col == other.m_col);
-    }
-
-    /**
-     * @brief Adds another matrix to this one element-wise.
-     * Modifies the current object.
-     * @note Example: mat.addMatrix(otherMat);
-     */
-    void addMatrix(const Matrix &other){
-        if (!checkIfSameSize(other)){
-            throw std::invalid_argument("Both matrices must be the same size.\n");
-        }
-
-        for (int matA_row = 0; matA_row < m_row; matA_row++){
-            for (int matA_col = 0; matA_col < m_col; matA_col++){
-                data[matA_row][matA_col] += other.data[matA_row][matA_col];
-            }
-        }
-    }
-
-    /**
-     * @brief Subtracts another matrix from this one element-wise.
-     * Modifies the current object.
-     * @note Example: mat.subtractMatrix(otherMat);
-     */
-    void subtractMatrix(const Matrix &other){
-        if (!checkIfSameSize(other)){
-            throw std::invalid_argument("Both matrices must be the same size.\n");
-        }
-        for (int matA_row = 0; matA_row < m_row; matA_row++){
-            for (int matA_col = 0; matA_col < m_col; matA_col++){
-                data[matA_row][matA_col] -= other.data[matA_row][matA_col];
-            }
-        }
-    }
-
-    /**
-     * @brief Multiplies every element in the matrix by a scalar constant.
-     * Modifies the current object.
-     * @note Example: mat.multiplyByConstant(2.5);
-     */
-    void multiplyByConstant(T c){
-        for (int mat_row = 0; mat_row < m_row; mat_row++){
-            for (int mat_col = 0; mat_col < m_col; mat_col++){
-                data[mat_row][mat_col] *= c;
-            }
-        }
-    }
-
-    /**
-     * @brief Divides every element in the matrix by a scalar constant.
-     * Modifies the current object.
-     * @throws std::invalid_argument if dividing by zero.
-     * @note Example: mat.divideByConstant(2);
-     */
-    void divideByConstant(T c){
-        if (c == static_cast<T>(0)){
-            throw std::invalid_argument("Constant must be a nonzero value.\n");
-        }
-
-        for (int mat_row = 0; mat_row < m_row; mat_row++){
-            for (int mat_col = 0; mat_col < m_col; mat_col++){
-                data[mat_row][mat_col] /= c;
-            }
-        }
-    }
-
-    /**
-     * @brief Performs matrix multiplication (Dot Product).
-     * @param other The matrix to multiply by (Right-hand side).
-     * @return A new Matrix object containing the result.
-     * @throws std::invalid_argument if column count of A != row count of B.
-     * @note Example: Matrix result = matA.multiplyByMatrix(matB);
-     */
-    Matrix multiplyByMatrix(const Matrix &other) const {
-        if (m_col == other.m_row){
-            int rows_A = m_row;
-            int cols_A = m_col;
-            int cols_B = other.m_col;
-
-            Matrix result(rows_A, cols_B);
-
-            for(int r = 0; r < rows_A; r++){
-                for(int c = 0; c < cols_B; c++){
-                    for(int i = 0; i < cols_A; i++){
-                        result.data[r][c] += data[r][i] * other.data[i][c];
-                    }
-                }
-            }
-            return result;
-        } else {
-            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
-        }
-    }
-    
-
-    /**
-     * @brief Transposes the matrix (swaps rows and columns) in place.
-     * A matrix of size MxN becomes NxM.
-     * @note Example: mat.transpose();
-     */
-    void transpose(){
-        std::vector<std::vector<T>> temp(m_col, std::vector<T>(m_row));
-        for(int r = 0; r < m_row; r++){
-            for(int c = 0; c < m_col; c++){
-                temp[c][r] = data[r][c];
-            }
-        }
-        data = temp;
-        std::swap(m_row, m_col);
-    }
-
-    // --- OPERATORS ---
-
-    /**
-     * @brief Compound assignment operator for addition.
-     * @note Example: matA += matB;
-     */
-    Matrix& operator+=(const Matrix& other) {
-        addMatrix(other);
-        return *this;
-    }
-
-    /**
-     * @brief Binary operator for addition. Returns a new object.
-     * @note Example: Matrix matC = matA + matB;
-     */
-    Matrix operator+(const Matrix& other) const {
-        Matrix result = *this; 
-        result.addMatrix(other); 
-        return result;
-    }
-
-    /**
-     * @brief Compound assignment operator for subtraction.
-     * @note Example: matA -= matB;
-     */
-    Matrix& operator-=(const Matrix& other) {
-        subtractMatrix(other);
-        return *this;
-    }
-
-    /**
-     * @brief Binary operator for subtraction. Returns a new object.
-     * @note Example: Matrix matC = matA - matB;
-     */
-    Matrix operator-(const Matrix& other) const {
-        Matrix result = *this;
-        result.subtractMatrix(other);
-        return result;
-    }
-
-    /**
-     * @brief Binary operator for matrix multiplication. Returns a new object.
-     * @note Example: Matrix matC = matA * matB;
-     */
-    Matrix operator*(const Matrix& other) const {
-        return multiplyByMatrix(other);
-    }
-
-    /**
-     * @brief Binary operator for scalar multiplication. Returns a new object.
-     * @note Example: Matrix matB = matA * 5.0;
-     */
-    Matrix operator*(T constant) const {
-        Matrix result = *this;
-        result.multiplyByConstant(constant);
-        return result;
-    }
-    
-    /**
-     * @brief Binary operator for scalar division. Returns a new object.
-     * @note Example: Matrix matB = matA / 2.0;
-     */
-    Matrix operator/(T constant) const {
-        Matrix result = *this;
-        result.divideByConstant(constant);
-        return result;
-    }
-};
+#pragma once
+#include <iostream>
+#include <vector>
+#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <cmath>
+#include <limits>
+#include "AlignedAllocator.hpp"
+#include "BinaryFormat.hpp"
+#include "Gemm.hpp"
+#include "ThreadPool.hpp"
+#include "MatrixExpression.hpp"
+#include "MatrixView.hpp"
+#include "TextFormat.hpp"
+#include "Transpose.hpp"
+#include "Syrk.hpp"
+#include "Reduction.hpp"
+#include "ScratchArena.hpp"
+#include "Instrumentation.hpp"
+
+template <typename T, typename Alloc> class QR_Factorization;
+template <typename T, typename Alloc> class MatrixBuilder;
+
+/**
+ * @class Matrix
+ * @brief A template class for mathematical matrix operations.
+ * Supports basic arithmetic, resizing, and matrix multiplication.
+ * Elements are stored row-major in a single buffer obtained from Alloc (64-byte aligned by
+ * default; see also HugePageAllocator and matrixlib::ArenaAllocator). Consecutive rows are
+ * m_stride elements apart; rows wider than a cache line are padded so every row starts aligned.
+ * Element-wise operators return lazy expressions (see MatrixExpression.hpp) that are evaluated
+ * in a single fused pass when assigned to a Matrix.
+ */
+template <typename T, typename Alloc> class Matrix : public MatrixExpr<Matrix<T, Alloc>>
+{
+protected:
+    static constexpr std::size_t alignment = 64;
+
+    int m_row{};
+    int m_col{};
+    int m_stride{}; //Leading dimension: distance (in elements) between starts of consecutive rows
+    std::vector<T, Alloc> data;
+
+    int precision = 3; //Default value of precision
+
+    /**
+     * @brief Writes every element of a same-sized expression into this matrix in one pass.
+     * @param expr Source expression. It may read *this as a Matrix leaf (element (r, c) is read
+     * before it is written), but not through a view over this buffer; operator= routes those
+     * through a temporary.
+     */
+    template <typename E>
+    void assignExpr(const E& expr) {
+        MATRIXLIB_INSTRUMENT(Expression, m_row, m_col, 0, static_cast<double>(m_row) * m_col, 2 * static_cast<double>(m_row) * m_col * sizeof(T));
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int r = row_begin; r < row_end; r++) {
+                T* dst = rowData(r);
+                for (int c = 0; c < m_col; c++) {
+                    dst[c] = expr.coeff(r, c);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Computes the row stride used for a given number of columns.
+     * Rows spanning at least one cache line are padded up to a whole number of cache lines,
+     * narrower rows are stored densely so small matrices do not waste memory.
+     * @param column Number of columns.
+     * @return Row stride in elements.
+     */
+    static int paddedStride(int column) {
+        constexpr int lanes = (sizeof(T) <= alignment && alignment % sizeof(T) == 0)
+                              ? static_cast<int>(alignment / sizeof(T)) : 1;
+        if (column < lanes) {
+            return column;
+        }
+        return (column + lanes - 1) / lanes * lanes;
+    }
+
+    /**
+     * @brief Adopts a buffer holding row x column elements laid out with the given row stride.
+     * Used by MatrixBuilder to hand over its buffer without copying.
+     */
+    Matrix(std::vector<T, Alloc>&& buffer, int row, int column, int stride)
+        : m_row(row), m_col(column), m_stride(stride), data(std::move(buffer)) {}
+
+    template <typename, typename> friend class MatrixBuilder;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    /**
+     * @brief Constructs a Matrix with specified dimensions initialized to zero.
+     * @param row Number of rows.
+     * @param column Number of columns.
+     * @param alloc Allocator instance for the element buffer.
+     * @throws std::invalid_argument if dimensions are negative.
+     * @note Example: Matrix<int> mat(3, 3); // Creates a 3x3 zero matrix
+     */
+    Matrix(int row, int column, const Alloc& alloc = Alloc()) : m_row(row), m_col(column), data(alloc) {
+        if (row < 0 || column < 0) {
+            throw std::invalid_argument("Number of rows and columns shall be greater than 0.\n");
+        }
+        m_stride = paddedStride(column);
+        data.resize(static_cast<std::size_t>(row) * m_stride);
+    };
+
+    /**
+     * @brief Constructs a Matrix from a 2D vector.
+     * @param value A vector of vectors containing the initial data.
+     * @throws std::invalid_argument if the rows have different lengths.
+     * @note Example: Matrix<int> mat({{1, 2}, {3, 4}});
+     */
+    Matrix(const std::vector<std::vector<T>>& value)
+        : Matrix(static_cast<int>(value.size()), value.empty() ? 0 : static_cast<int>(value[0].size())) {
+        for (int r = 0; r < m_row; r++) {
+            if (static_cast<int>(value[r].size()) != m_col) {
+                throw std::invalid_argument("All rows must have the same number of columns.\n");
+            }
+            std::copy(value[r].begin(), value[r].end(), rowData(r));
+        }
+    };
+
+    Matrix(const Matrix&) = default;
+    Matrix& operator=(const Matrix&) = default;
+
+    /**
+     * @brief Move constructor. Takes over the buffer of other, which is left empty (0x0).
+     * @note Example: Matrix<double> b = std::move(a);
+     */
+    Matrix(Matrix&& other) noexcept
+        : m_row(std::exchange(other.m_row, 0)), m_col(std::exchange(other.m_col, 0)),
+          m_stride(std::exchange(other.m_stride, 0)), data(std::move(other.data)), precision(other.precision) {
+        other.data.clear();
+    }
+
+    /**
+     * @brief Move assignment. Takes over the buffer of other, which is left empty (0x0).
+     * @note Example: b = std::move(a);
+     */
+    Matrix& operator=(Matrix&& other) noexcept {
+        if (this != &other) {
+            m_row = std::exchange(other.m_row, 0);
+            m_col = std::exchange(other.m_col, 0);
+            m_stride = std::exchange(other.m_stride, 0);
+            data = std::move(other.data);
+            other.data.clear();
+            precision = other.precision;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Constructs a Matrix by evaluating an element-wise expression in a single pass.
+     * @param expr The expression, e.g. the result of matA + matB * 2.0.
+     * @note Example: Matrix<double> mat = matA + matB;
+     */
+    template <typename E>
+        requires (!std::is_same_v<E, Matrix>)
+    Matrix(const MatrixExpr<E>& expr) : Matrix(expr.self().getRows(), expr.self().getCols()) {
+        assignExpr(expr.self());
+    }
+
+    /**
+     * @brief Assigns the result of an element-wise expression, evaluated in a single pass.
+     * The matrix is resized if the expression has a different shape. A source that reads this
+     * matrix through a view (a block, a row or t()) is evaluated into a temporary first, so
+     * m = m.t() and m = m.block(...) + m are safe.
+     * @note Example: matC = matA + matB - matC;
+     */
+    template <typename E>
+        requires (!std::is_same_v<E, Matrix>)
+    Matrix& operator=(const MatrixExpr<E>& expr) {
+        const E& source = expr.self();
+        const bool same_shape = source.getRows() == m_row && source.getCols() == m_col;
+        if constexpr (matrixlib::detail::StridedExpr<E>) {
+            //m = m.t() on a square matrix: swap in place instead of copying
+            if (same_shape && m_row == m_col && source.stridedData() == data.data() && source.rowStride() == 1 && source.colStride() == m_stride) {
+                transpose();
+                return *this;
+            }
+        }
+        if (!same_shape || matrixlib::detail::readsThroughView(source, data.data(), data.data() + data.size())) {
+            Matrix result(source);
+            std::swap(m_row, result.m_row);
+            std::swap(m_col, result.m_col);
+            std::swap(m_stride, result.m_stride);
+            data.swap(result.data);
+        } else {
+            assignExpr(source);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns the number of rows.
+     * @note Example: int rows = mat.getRows();
+     */
+    int getRows() const { return m_row; }
+
+    /**
+     * @brief Returns the number of columns.
+     * @note Example: int cols = mat.getCols();
+     */
+    int getCols() const { return m_col; }
+
+    /**
+     * @brief Returns the row stride (leading dimension) of the underlying buffer, in elements.
+     * @note Example: int ld = mat.getStride();
+     */
+    int getStride() const { return m_stride; }
+
+    /**
+     * @brief Returns a copy of the allocator the buffer was allocated with.
+     * @note Example: Matrix<double, matrixlib::HugePageAllocator<double>> tmp(rows, cols, mat.getAllocator());
+     */
+    Alloc getAllocator() const { return data.get_allocator(); }
+
+    /**
+     * @brief Returns a pointer to the first element of a row in the contiguous buffer.
+     * No bounds checking is performed.
+     * @param row The row index.
+     * @note Example: double* r0 = mat.rowData(0);
+     */
+    T* rowData(int row) { return data.data() + static_cast<std::size_t>(row) * m_stride; }
+
+    /**
+     * @brief Returns a read-only pointer to the first element of a row.
+     * @param row The row index.
+     */
+    const T* rowData(int row) const { return data.data() + static_cast<std::size_t>(row) * m_stride; }
+
+    /**
+     * @brief Unchecked element access.
+     * @param row The row index.
+     * @param col The column index.
+     * @return Reference to the element.
+     * @note Use getValue() for bounds-checked reads. Example: mat(0, 1) = 5.0;
+     */
+    T& operator()(int row, int col) { return rowData(row)[col]; }
+
+    /**
+     * @brief Unchecked read-only element access.
+     * @param row The row index.
+     * @param col The column index.
+     */
+    const T& operator()(int row, int col) const { return rowData(row)[col]; }
+
+    /**
+     * @brief Unchecked element read used when the matrix appears inside an expression.
+     */
+    const T& coeff(int row, int col) const { return rowData(row)[col]; }
+
+    /**
+     * @brief Strided layout descriptor, lets GEMM read the matrix in place.
+     */
+    const T* stridedData() const { return data.data(); }
+    std::ptrdiff_t rowStride() const { return m_stride; }
+    std::ptrdiff_t colStride() const { return 1; }
+
+    /**
+     * @brief Returns a view of the whole matrix.
+     * @note Example: MatrixView<double> v = mat.view();
+     */
+    MatrixView<T> view() { return MatrixView<T>(data.data(), m_row, m_col, m_stride, 1); }
+    MatrixView<const T> view() const { return MatrixView<const T>(data.data(), m_row, m_col, m_stride, 1); }
+
+    /**
+     * @brief Returns a view of a rectangular block; reads and writes go to this matrix.
+     * @param row First row of the block.
+     * @param col First column of the block.
+     * @param rows Number of rows in the block.
+     * @param cols Number of columns in the block.
+     * @throws std::invalid_argument if the block does not fit inside the matrix.
+     * @note Example: mat.block(0, 0, 2, 2) = other.block(2, 2, 2, 2);
+     */
+    MatrixView<T> block(int row, int col, int rows, int cols) { return view().block(row, col, rows, cols); }
+    MatrixView<const T> block(int row, int col, int rows, int cols) const { return view().block(row, col, rows, cols); }
+
+    /**
+     * @brief Returns a view of one row, without copying it (see getRow() for a copy).
+     * @throws std::invalid_argument if row index is out of bounds.
+     * @note Example: mat.row(1) += mat.row(0) * 2.0;
+     */
+    RowView<T> row(int row) {
+        if (row < 0 || row >= m_row) {
+            throw std::invalid_argument("Row index out of bounds.\n");
+        }
+        return RowView<T>(rowData(row), m_col);
+    }
+
+    RowView<const T> row(int row) const {
+        if (row < 0 || row >= m_row) {
+            throw std::invalid_argument("Row index out of bounds.\n");
+        }
+        return RowView<const T>(rowData(row), m_col);
+    }
+
+    /**
+     * @brief Returns a strided view of one column, without copying it (see getCol() for a copy).
+     * @throws std::invalid_argument if column index is out of bounds.
+     * @note Example: double top = mat.col(2)[0];
+     */
+    ColView<T> col(int col) {
+        if (col < 0 || col >= m_col) {
+            throw std::invalid_argument("Column index out of bounds.\n");
+        }
+        return ColView<T>(data.data() + col, m_row, m_stride);
+    }
+
+    ColView<const T> col(int col) const {
+        if (col < 0 || col >= m_col) {
+            throw std::invalid_argument("Column index out of bounds.\n");
+        }
+        return ColView<const T>(data.data() + col, m_row, m_stride);
+    }
+
+    /**
+     * @brief Retrieves a single element from the matrix.
+     * @param row The row index.
+     * @param col The column index.
+     * @return The value at the specified position.
+     * @throws std::invalid_argument if indices are out of bounds.
+     * @note Example: double val = mat.getVal(21, 37);
+     */
+    T getValue(int row, int col) const {
+        if (row < 0 || row >= m_row || col < 0 || col >= m_col) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        return (*this)(row, col);
+    }
+
+    /**
+     * @brief Retrieves an entire row as a vector.
+     * @param row Index of the row to retrieve.
+     * @return A std::vector containing the row values.
+     * @throws std::invalid_argument if row index is out of bounds.
+     * @note Example: double val = mat.getRow(1);
+     */
+    std::vector<T> getRow(int row) const {
+        if (row < 0 || row >= m_row) {
+            throw std::invalid_argument("Row index out of bounds.\n");
+        }
+        return std::vector<T>(rowData(row), rowData(row) + m_col);
+    }
+
+    /**
+     * @brief Retrieves an entire column as a vector.
+     * @param col Index of the column to retrieve.
+     * @return A std::vector containing the column values.
+     * @throws std::invalid_argument if column index is out of bounds.
+     * @note Example: double val = mat.getCol(4);
+     */
+    std::vector<T> getCol(int col) const {
+        if (col < 0 || col >= m_col) {
+            throw std::invalid_argument("Column index out of bounds.\n");
+        }
+
+        std::vector<T> column_vector(m_row);
+
+        for (int i = 0; i < m_row; i++) {
+            column_vector[i] = (*this)(i, col);
+        }
+        return column_vector;
+    }
+
+    /**
+     * @brief Overwrites a specific row with new values.
+     * @param row The index of the row to replace.
+     * @param vec_of_val Vector containing the new values.
+     * @throws std::invalid_argument if the index is out of bounds or vector size is incorrect.
+     * @note Example: mat.setRowVal(0, {1, 2, 3});
+     */
+    void setRowVal(int row, const std::vector<T>& vec_of_val){
+        if (row >= m_row || row < 0){
+            throw std::invalid_argument("Index out of bounds, try using addRow().\n");
+        }
+        if (static_cast<int>(vec_of_val.size()) != m_col){
+            throw std::invalid_argument("Size of vector isn't equal to number of columns.\n");
+        }
+        std::copy(vec_of_val.begin(), vec_of_val.end(), rowData(row));
+    }
+
+    /**
+     * @brief Overwrites a specific column with new values.
+     * @param column The index of the column to replace.
+     * @param vec_of_val Vector containing the new values.
+     * @throws std::invalid_argument if the index is out of bounds or vector size is incorrect.
+     * @note Example: mat.setColVal(1, {5, 6, 7});
+     */
+    void setColVal(int column, const std::vector<T>& vec_of_val){
+        if (column >= m_col || column < 0){
+            throw std::invalid_argument("Index out of bounds, try using addColumn().\n");
+        }
+
+        if (static_cast<int>(vec_of_val.size()) != m_row) {
+            throw std::invalid_argument("Size of vector is not equal to number of rows.\n");
+        }
+
+        for (int i = 0; i < m_row; i++){
+            (*this)(i, column) = vec_of_val[i];
+        }
+    }
+
+    /**
+     * @brief Prints the matrix to the standard output with formatted spacing.
+     * Uses fixed point notation and precision of .
+     * @note Example: mat.printMatrix();
+     */
+    void printMatrix() const {
+        std::cout << std::fixed << std::setprecision(precision);
+        exportText(std::cout, matrixlib::TextFormat::Aligned);
+        std::cout << "--------------------------------\n";
+        std::cout.flush();
+    }
+
+    /**
+     * @brief Sets the number of digits after the decimal point used by printMatrix() and exportText().
+     * @throws std::invalid_argument if precision is negative.
+     * @note Example: mat.setPrecision(6);
+     */
+    void setPrecision(int digits) {
+        if (digits < 0) {
+            throw std::invalid_argument("Precision must not be negative.\n");
+        }
+        precision = digits;
+    }
+
+    /**
+     * @brief Writes the matrix as text to a stream in large buffered chunks.
+     * @param out Destination stream.
+     * @param format CSV, TSV or the aligned layout of printMatrix().
+     * @note Example: std::ofstream file("m.csv"); mat.exportText(file, matrixlib::TextFormat::CSV);
+     */
+    void exportText(std::ostream& out, matrixlib::TextFormat format = matrixlib::TextFormat::Aligned) const {
+        matrixlib::detail::formatText(*this, format, precision, [&](const char* text, std::size_t length) {
+            out.write(text, static_cast<std::streamsize>(length));
+        });
+    }
+
+    /**
+     * @brief Writes the matrix as text to a POSIX file descriptor (file, pipe or socket).
+     * @throws std::runtime_error if writing fails.
+     * @note Example: mat.exportText(STDOUT_FILENO, matrixlib::TextFormat::TSV);
+     */
+    void exportText(int fd, matrixlib::TextFormat format = matrixlib::TextFormat::Aligned) const {
+        matrixlib::detail::formatText(*this, format, precision, [&](const char* text, std::size_t length) {
+            matrixlib::detail::writeToDescriptor(fd, text, length);
+        });
+    }
+
+    /**
+     * @brief Writes the matrix as text into a caller-owned buffer (not null-terminated).
+     * Output beyond capacity is dropped, so calling with capacity 0 measures the required size.
+     * @return Total length of the text, which may exceed capacity.
+     * @note Example: std::size_t n = mat.exportText(buf, sizeof(buf), matrixlib::TextFormat::CSV);
+     */
+    std::size_t exportText(char* buffer, std::size_t capacity,
+                           matrixlib::TextFormat format = matrixlib::TextFormat::Aligned) const {
+        std::size_t total = 0;
+        matrixlib::detail::formatText(*this, format, precision, [&](const char* text, std::size_t length) {
+            if (total < capacity) {
+                std::memcpy(buffer + total, text, std::min(length, capacity - total));
+            }
+            total += length;
+        });
+        return total;
+    }
+
+    /**
+     * @brief Parses delimited text (one row per line) straight into a new matrix.
+     * Lines are located first, then row blocks are parsed in parallel with std::from_chars
+     * directly into the matrix buffer. Blank lines are skipped; CRLF line ends are accepted.
+     * @param text The whole input.
+     * @param delimiter Field separator, ',' for CSV or '\t' for TSV.
+     * @throws std::invalid_argument on ragged rows or fields that are not numbers.
+     * @note Example: Matrix<double> mat = Matrix<double>::parseCSV("1,2\n3,4\n");
+     */
+    static Matrix parseCSV(std::string_view text, char delimiter = ',') {
+        const auto lines = matrixlib::detail::splitLines(text);
+        if (lines.empty()) {
+            return Matrix(0, 0);
+        }
+        const std::string_view first = text.substr(lines[0].first, lines[0].second - lines[0].first);
+        const int cols = static_cast<int>(std::count(first.begin(), first.end(), delimiter)) + 1;
+        Matrix result(static_cast<int>(lines.size()), cols);
+
+        matrixlib::parallelRows(result.m_row, static_cast<long long>(result.m_row) * cols, [&](int row_begin, int row_end) {
+            for (int r = row_begin; r < row_end; r++) {
+                const char* cursor = text.data() + lines[r].first;
+                const char* line_end = text.data() + lines[r].second;
+                T* dst = result.rowData(r);
+                for (int c = 0; c < cols; c++) {
+                    const char* field_end = (c + 1 < cols) ? std::find(cursor, line_end, delimiter) : line_end;
+                    if (field_end == line_end && c + 1 < cols) {
+                        throw std::invalid_argument("All rows must have the same number of columns.\n");
+                    }
+                    if (c + 1 == cols && std::find(cursor, line_end, delimiter) != line_end) {
+                        throw std::invalid_argument("All rows must have the same number of columns.\n");
+                    }
+                    dst[c] = matrixlib::detail::parseNumber<T>(cursor, field_end);
+                    cursor = field_end + 1;
+                }
+            }
+        });
+        return result;
+    }
+
+    /**
+     * @brief Reads a delimited text file into a new matrix (see parseCSV()).
+     * @throws std::runtime_error if the file cannot be read.
+     * @note Example: Matrix<double> mat = Matrix<double>::loadCSV("data.csv");
+     */
+    static Matrix loadCSV(const std::string& path, char delimiter = ',') {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open " + path + " for reading.\n");
+        }
+        std::string text;
+        in.seekg(0, std::ios::end);
+        text.resize(static_cast<std::size_t>(in.tellg()));
+        in.seekg(0, std::ios::beg);
+        in.read(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!in) {
+            throw std::runtime_error("Cannot read " + path + ".\n");
+        }
+        return parseCSV(text, delimiter);
+    }
+
+    /**
+     * @brief Writes the matrix in the binary format of BinaryFormat.hpp (header + raw rows).
+     * @param out Destination stream, opened in binary mode.
+     * @throws std::runtime_error if writing fails.
+     * @note Example: mat.save(file);
+     */
+    void save(std::ostream& out) const {
+        const matrixlib::BinaryHeader header = matrixlib::detail::makeHeader<T>(m_row, m_col, m_stride);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(data.data()),
+                  static_cast<std::streamsize>(static_cast<std::size_t>(m_row) * m_stride * sizeof(T)));
+        if (!out) {
+            throw std::runtime_error("Cannot write matrix file.\n");
+        }
+    }
+
+    /**
+     * @brief Writes the matrix to a binary file.
+     * @param path File to create or overwrite.
+     * @throws std::runtime_error if the file cannot be written.
+     * @note Example: mat.save("weights.mtx");
+     */
+    void save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open " + path + " for writing.\n");
+        }
+        save(out);
+    }
+
+    /**
+     * @brief Reads a matrix written by save(). When the stored stride matches this build's
+     * row padding, the whole payload is read with a single call straight into the buffer.
+     * @param in Source stream, opened in binary mode.
+     * @return The loaded matrix.
+     * @throws std::invalid_argument if the data is not a matrix of element type T.
+     * @throws std::runtime_error if the stream ends early.
+     * @note Example: Matrix<double> mat = Matrix<double>::load(file);
+     */
+    static Matrix load(std::istream& in) {
+        matrixlib::BinaryHeader header;
+        const bool swapped = matrixlib::detail::readHeader<T>(in, header);
+        Matrix result(static_cast<int>(header.rows), static_cast<int>(header.cols));
+        const std::size_t file_stride = header.stride;
+        if (file_stride == static_cast<std::size_t>(result.m_stride)) {
+            in.read(reinterpret_cast<char*>(result.data.data()),
+                    static_cast<std::streamsize>(result.data.size() * sizeof(T)));
+        } else {
+            for (int r = 0; r < result.m_row && in; r++) {
+                in.read(reinterpret_cast<char*>(result.rowData(r)), static_cast<std::streamsize>(result.m_col * sizeof(T)));
+                in.ignore(static_cast<std::streamsize>((file_stride - result.m_col) * sizeof(T)));
+            }
+        }
+        if (!in) {
+            throw std::runtime_error("Cannot read matrix file.\n");
+        }
+        if (swapped) {
+            matrixlib::detail::byteswapBuffer(result.data.data(), result.data.size());
+        }
+        return result;
+    }
+
+    /**
+     * @brief Reads a matrix from a binary file written by save().
+     * @param path File to read.
+     * @throws std::invalid_argument if the file is not a matrix of element type T.
+     * @throws std::runtime_error if the file cannot be read.
+     * @note Example: Matrix<double> mat = Matrix<double>::load("weights.mtx");
+     */
+    static Matrix load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open " + path + " for reading.\n");
+        }
+        return load(in);
+    }
+
+    /**
+     * @brief Appends a new row to the bottom of the matrix.
+     * @param vec_of_val Values for the new row.
+     * @note Example: mat.addRow({10, 11, 12});
+     */
+    void addRow(const std::vector<T>& vec_of_val){
+        if(static_cast<int>(vec_of_val.size()) != m_col) {
+            throw std::invalid_argument("Size of vector is not equal to number of columns.\n");
+        }
+
+        data.resize(static_cast<std::size_t>(m_row + 1) * m_stride);
+        std::copy(vec_of_val.begin(), vec_of_val.end(), rowData(m_row));
+        m_row += 1;
+    }
+
+    /**
+     * @brief Appends a new column to the right side of the matrix.
+     * @param vec_of_val Values for the new column.
+     * @note Example: mat.addColumn({10, 11, 12});
+     */
+    void addColumn(const std::vector<T>& vec_of_val){
+        if (static_cast<int>(vec_of_val.size()) != m_row){
+            throw std::invalid_argument("Size of vector is not equal to number of rows.\n");
+        }
+
+        if (m_col == m_stride) {
+            //Doubling the stride makes appending k columns move the rows O(log k) times, not O(k)
+            restride(paddedStride(std::max(m_col + 1, 2 * m_stride)));
+        }
+        for (int r = 0; r < m_row; r++){
+            (*this)(r, m_col) = vec_of_val[r];
+        }
+        m_col += 1;
+    }
+
+    /**
+     * @brief Reserves room for a rows x cols matrix, so that addRow() and addColumn() do not
+     * reallocate until that size is exceeded. Never shrinks; the contents are kept.
+     * @throws std::invalid_argument if a dimension is negative.
+     * @note Example: mat.reserve(1000000, 64); // then stream rows in with addRow()
+     */
+    void reserve(int rows, int cols) {
+        if (rows < 0 || cols < 0) {
+            throw std::invalid_argument("Number of rows and columns shall be greater than 0.\n");
+        }
+        const int stride = std::max(m_stride, paddedStride(cols));
+        data.reserve(static_cast<std::size_t>(std::max(rows, m_row)) * stride);
+        if (stride > m_stride) {
+            restride(stride);
+        }
+    }
+
+    /**
+     * @brief Gives back the spare capacity left by reserve(), addRow() and addColumn(): rows are
+     * packed to the default stride and the buffer is reallocated to fit.
+     * @note Example: mat.shrinkToFit();
+     */
+    void shrinkToFit() {
+        const int stride = paddedStride(m_col);
+        if (stride < m_stride) {
+            for (int r = 1; r < m_row; r++) {
+                const T* src = data.data() + static_cast<std::size_t>(r) * m_stride;
+                std::copy(src, src + m_col, data.data() + static_cast<std::size_t>(r) * stride);
+            }
+            m_stride = stride;
+            for (int r = 0; r < m_row; r++) {
+                T* row = rowData(r);
+                std::fill(row + m_col, row + m_stride, T{});
+            }
+        }
+        data.resize(static_cast<std::size_t>(m_row) * m_stride);
+        data.shrink_to_fit();
+    }
+
+    /**
+     * @brief Checks if two matrices have the same dimensions.
+     * @param other The matrix to compare against.
+     * @return true if rows and columns match, false otherwise.
+     */
+    bool checkIfSameSize(const Matrix &other) const {
+        return (m_row == other.m_row && m_col == other.m_col);
+    }
+
+    /**
+     * @brief Adds another matrix to this one element-wise.
+     * Modifies the current object.
+     * @note Example: mat.addMatrix(otherMat);
+     */
+    void addMatrix(const Matrix &other){
+        if (!checkIfSameSize(other)){
+            throw std::invalid_argument("Both matrices must be the same size.\n");
+        }
+        MATRIXLIB_INSTRUMENT(AddMatrix, m_row, m_col, 0, static_cast<double>(m_row) * m_col, 3 * static_cast<double>(m_row) * m_col * sizeof(T));
+
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int matA_row = row_begin; matA_row < row_end; matA_row++){
+                T* dst = rowData(matA_row);
+                const T* src = other.rowData(matA_row);
+                for (int matA_col = 0; matA_col < m_col; matA_col++){
+                    dst[matA_col] += src[matA_col];
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Subtracts another matrix from this one element-wise.
+     * Modifies the current object.
+     * @note Example: mat.subtractMatrix(otherMat);
+     */
+    void subtractMatrix(const Matrix &other){
+        if (!checkIfSameSize(other)){
+            throw std::invalid_argument("Both matrices must be the same size.\n");
+        }
+        MATRIXLIB_INSTRUMENT(SubtractMatrix, m_row, m_col, 0, static_cast<double>(m_row) * m_col, 3 * static_cast<double>(m_row) * m_col * sizeof(T));
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int matA_row = row_begin; matA_row < row_end; matA_row++){
+                T* dst = rowData(matA_row);
+                const T* src = other.rowData(matA_row);
+                for (int matA_col = 0; matA_col < m_col; matA_col++){
+                    dst[matA_col] -= src[matA_col];
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Multiplies every element in the matrix by a scalar constant.
+     * Modifies the current object.
+     * @note Example: mat.multiplyByConstant(2.5);
+     */
+    void multiplyByConstant(T c){
+        MATRIXLIB_INSTRUMENT(MultiplyByConstant, m_row, m_col, 0, static_cast<double>(m_row) * m_col, 2 * static_cast<double>(m_row) * m_col * sizeof(T));
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int mat_row = row_begin; mat_row < row_end; mat_row++){
+                T* dst = rowData(mat_row);
+                for (int mat_col = 0; mat_col < m_col; mat_col++){
+                    dst[mat_col] *= c;
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Divides every element in the matrix by a scalar constant.
+     * Modifies the current object.
+     * @throws std::invalid_argument if dividing by zero.
+     * @note Example: mat.divideByConstant(2);
+     */
+    void divideByConstant(T c){
+        if (c == static_cast<T>(0)){
+            throw std::invalid_argument("Constant must be a nonzero value.\n");
+        }
+        MATRIXLIB_INSTRUMENT(DivideByConstant, m_row, m_col, 0, static_cast<double>(m_row) * m_col, 2 * static_cast<double>(m_row) * m_col * sizeof(T));
+
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int mat_row = row_begin; mat_row < row_end; mat_row++){
+                T* dst = rowData(mat_row);
+                for (int mat_col = 0; mat_col < m_col; mat_col++){
+                    dst[mat_col] /= c;
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Sum of all elements, computed blockwise in parallel.
+     * @param mode Reduction::Deterministic gives the same bits for any number of threads.
+     * @note Example: double total = mat.sum();
+     */
+    T sum(matrixlib::Reduction mode = matrixlib::Reduction::Fast) const {
+        if (m_row == 0 || m_col == 0) {
+            return T{};
+        }
+        MATRIXLIB_INSTRUMENT(Reduce, m_row, m_col, 0, static_cast<double>(m_row) * m_col, static_cast<double>(m_row) * m_col * sizeof(T));
+        return matrixlib::detail::reduceSegments<T>(m_row, m_col, mode,
+            [this](int r, int c0, int c1) { return matrixlib::detail::sumSpan(rowData(r) + c0, c1 - c0); },
+            [](T a, T b) { return a + b; });
+    }
+
+    /**
+     * @brief Smallest element. The result is unspecified if the matrix contains NaN.
+     * @throws std::invalid_argument if the matrix is empty.
+     * @note Example: double lo = mat.minCoeff();
+     */
+    T minCoeff() const {
+        if (m_row == 0 || m_col == 0) {
+            throw std::invalid_argument("Cannot reduce an empty matrix.\n");
+        }
+        MATRIXLIB_INSTRUMENT(Reduce, m_row, m_col, 0, static_cast<double>(m_row) * m_col, static_cast<double>(m_row) * m_col * sizeof(T));
+        return matrixlib::detail::reduceSegments<T>(m_row, m_col, matrixlib::Reduction::Fast,
+            [this](int r, int c0, int c1) { return matrixlib::detail::minSpan(rowData(r) + c0, c1 - c0); },
+            [](T a, T b) { return b < a ? b : a; });
+    }
+
+    /**
+     * @brief Largest element. The result is unspecified if the matrix contains NaN.
+     * @throws std::invalid_argument if the matrix is empty.
+     * @note Example: double hi = mat.maxCoeff();
+     */
+    T maxCoeff() const {
+        if (m_row == 0 || m_col == 0) {
+            throw std::invalid_argument("Cannot reduce an empty matrix.\n");
+        }
+        MATRIXLIB_INSTRUMENT(Reduce, m_row, m_col, 0, static_cast<double>(m_row) * m_col, static_cast<double>(m_row) * m_col * sizeof(T));
+        return matrixlib::detail::reduceSegments<T>(m_row, m_col, matrixlib::Reduction::Fast,
+            [this](int r, int c0, int c1) { return matrixlib::detail::maxSpan(rowData(r) + c0, c1 - c0); },
+            [](T a, T b) { return a < b ? b : a; });
+    }
+
+    /**
+     * @brief Frobenius norm, the square root of the sum of squared elements.
+     * Sums the squares directly; only if that overflows or underflows is the matrix scaled by its
+     * largest magnitude and summed again.
+     * @param mode Reduction::Deterministic gives the same bits for any number of threads.
+     * @note Example: double norm = mat.frobeniusNorm();
+     */
+    T frobeniusNorm(matrixlib::Reduction mode = matrixlib::Reduction::Fast) const
+        requires std::is_floating_point_v<T>
+    {
+        if (m_row == 0 || m_col == 0) {
+            return T{};
+        }
+        MATRIXLIB_INSTRUMENT(Reduce, m_row, m_col, 0, 2 * static_cast<double>(m_row) * m_col, static_cast<double>(m_row) * m_col * sizeof(T));
+        const auto add = [](T a, T b) { return a + b; };
+        const T squares = matrixlib::detail::reduceSegments<T>(m_row, m_col, mode,
+            [this](int r, int c0, int c1) { return matrixlib::detail::sumSquaresSpan(rowData(r) + c0, c1 - c0, static_cast<T>(1)); },
+            add);
+        if (squares >= std::numeric_limits<T>::min() && squares <= std::numeric_limits<T>::max()) {
+            return std::sqrt(squares);
+        }
+        const T largest = matrixlib::detail::reduceSegments<T>(m_row, m_col, mode,
+            [this](int r, int c0, int c1) { return matrixlib::detail::maxAbsSpan(rowData(r) + c0, c1 - c0); },
+            [](T a, T b) { return a < b ? b : a; });
+        if (largest == static_cast<T>(0) || !(largest <= std::numeric_limits<T>::max())) {
+            return largest;
+        }
+        const T scale = static_cast<T>(1) / largest;
+        const T scaled = matrixlib::detail::reduceSegments<T>(m_row, m_col, mode,
+            [this, scale](int r, int c0, int c1) { return matrixlib::detail::sumSquaresSpan(rowData(r) + c0, c1 - c0, scale); },
+            add);
+        return largest * std::sqrt(scaled);
+    }
+
+    /**
+     * @brief Sum of the element-wise products with other (the Frobenius inner product).
+     * @param mode Reduction::Deterministic gives the same bits for any number of threads.
+     * @throws std::invalid_argument if the sizes differ.
+     * @note Example: double d = a.dot(b);
+     */
+    T dot(const Matrix &other, matrixlib::Reduction mode = matrixlib::Reduction::Fast) const {
+        if (!checkIfSameSize(other)){
+            throw std::invalid_argument("Both matrices must be the same size.\n");
+        }
+        if (m_row == 0 || m_col == 0) {
+            return T{};
+        }
+        MATRIXLIB_INSTRUMENT(Reduce, m_row, m_col, 0, 2 * static_cast<double>(m_row) * m_col, 2 * static_cast<double>(m_row) * m_col * sizeof(T));
+        return matrixlib::detail::reduceSegments<T>(m_row, m_col, mode,
+            [this, &other](int r, int c0, int c1) { return matrixlib::detail::dotSpan(rowData(r) + c0, other.rowData(r) + c0, c1 - c0); },
+            [](T a, T b) { return a + b; });
+    }
+
+    /**
+     * @brief Sum of each row. Every row is summed by one thread, so the result does not depend
+     * on the number of threads.
+     * @return A vector with one entry per row.
+     * @note Example: std::vector<double> totals = mat.rowSums();
+     */
+    std::vector<T> rowSums() const {
+        std::vector<T> sums(m_row);
+        MATRIXLIB_INSTRUMENT(Reduce, m_row, m_col, 0, static_cast<double>(m_row) * m_col, static_cast<double>(m_row) * m_col * sizeof(T));
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int r = row_begin; r < row_end; r++) {
+                sums[r] = matrixlib::detail::sumSpan(rowData(r), m_col);
+            }
+        });
+        return sums;
+    }
+
+    /**
+     * @brief Sum of each column.
+     * @param mode Reduction::Deterministic gives the same bits for any number of threads.
+     * @return A vector with one entry per column.
+     * @note Example: std::vector<double> means = mat.colSums(); // then divide by getRows()
+     */
+    std::vector<T> colSums(matrixlib::Reduction mode = matrixlib::Reduction::Fast) const {
+        std::vector<T> sums(m_col);
+        MATRIXLIB_INSTRUMENT(Reduce, m_row, m_col, 0, static_cast<double>(m_row) * m_col, static_cast<double>(m_row) * m_col * sizeof(T));
+        matrixlib::detail::columnSums(m_row, m_col, data.data(), m_stride, mode, sums.data());
+        return sums;
+    }
+
+    /**
+     * @brief Performs matrix multiplication (Dot Product).
+     * Runs the packed, cache-blocked kernel from Gemm.hpp (SIMD for float/double).
+     * @param other The matrix to multiply by (Right-hand side).
+     * @return A new Matrix object containing the result.
+     * @throws std::invalid_argument if column count of A != row count of B.
+     * @note Example: Matrix result = matA.multiplyByMatrix(matB);
+     */
+    Matrix multiplyByMatrix(const Matrix &other) const {
+        if (m_col == other.m_row){
+            int rows_A = m_row;
+            int cols_A = m_col;
+            int cols_B = other.m_col;
+            MATRIXLIB_INSTRUMENT(MultiplyByMatrix, rows_A, cols_B, cols_A, 2.0 * rows_A * cols_B * cols_A,
+                                 (static_cast<double>(rows_A) * cols_A + static_cast<double>(cols_A) * cols_B +
+                                  static_cast<double>(rows_A) * cols_B) * sizeof(T));
+
+            Matrix result(rows_A, cols_B, data.get_allocator());
+            matrixlib::gemm<T>(rows_A, cols_B, cols_A, static_cast<T>(1),
+                               rowData(0), m_stride, 1,
+                               other.rowData(0), other.m_stride, 1,
+                               static_cast<T>(0), result.rowData(0), result.m_stride);
+            return result;
+        } else {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+    }
+    
+
+    /**
+     * @brief Transposes the matrix (swaps rows and columns) in place.
+     * A matrix of size MxN becomes NxM. Square matrices are transposed in their own buffer;
+     * rectangular ones are written into a new buffer that then replaces the old one. Both use a
+     * cache-oblivious recursive split, and large matrices run on the thread pool.
+     * @note To use the transpose in a product, prefer t(), which copies nothing.
+     * @note Example: mat.transpose();
+     */
+    void transpose(){
+        MATRIXLIB_INSTRUMENT(Transpose, m_col, m_row, 0, 0, 2 * static_cast<double>(m_row) * m_col * sizeof(T));
+        if (m_row == m_col) {
+            matrixlib::transposeInPlace(m_row, data.data(), m_stride);
+            return;
+        }
+        Matrix temp = transposedCopy();
+        data.swap(temp.data);
+        std::swap(m_row, m_col);
+        m_stride = temp.m_stride;
+    }
+
+    /**
+     * @brief Returns a physically transposed copy (NxM for an MxN matrix).
+     * @note Example: Matrix<double> at = a.transposed();
+     */
+    Matrix transposed() const {
+        MATRIXLIB_INSTRUMENT(Transpose, m_col, m_row, 0, 0, 2 * static_cast<double>(m_row) * m_col * sizeof(T));
+        return transposedCopy();
+    }
+
+    /**
+     * @brief Returns the transpose as a view, in O(1): only the strides are swapped.
+     * Products read the view directly with the matching access pattern, so a.t() * b never
+     * materializes the transpose.
+     * @note Example: Matrix<double> atb = a.t() * b;
+     */
+    MatrixView<T> t() { return view().transposed(); }
+    MatrixView<const T> t() const { return view().transposed(); }
+
+    /**
+     * @brief Returns a copy converted element by element to another type, e.g. double to float.
+     * Conversion runs in one parallel pass straight into the new buffer.
+     * @param alloc Allocator of the result (by default this matrix's allocator rebound to U).
+     * @return The converted matrix, same shape.
+     * @note Example: Matrix<float> single = mat.cast<float>();
+     */
+    template <typename U, typename UAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<U>>
+    Matrix<U, UAlloc> cast(const UAlloc& alloc = UAlloc()) const {
+        Matrix<U, UAlloc> result(m_row, m_col, alloc);
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int r = row_begin; r < row_end; r++) {
+                const T* src = rowData(r);
+                U* dst = result.rowData(r);
+                for (int c = 0; c < m_col; c++) {
+                    dst[c] = static_cast<U>(src[c]);
+                }
+            }
+        });
+        return result;
+    }
+
+    /**
+     * @brief Multiplies op(this) by op(other), where op is the identity or the transpose.
+     * Transposed operands are read in place with swapped strides; nothing is copied.
+     * @param other Right operand.
+     * @param op_this Transformation of this matrix.
+     * @param op_other Transformation of other.
+     * @return The product op(this) * op(other).
+     * @throws std::invalid_argument if the inner dimensions differ.
+     * @note Example: Matrix<double> c = a.multiplyByMatrix(b, matrixlib::Op::Trans, matrixlib::Op::NoTrans);
+     */
+    Matrix multiplyByMatrix(const Matrix& other, matrixlib::Op op_this, matrixlib::Op op_other) const {
+        const bool trans_a = (op_this == matrixlib::Op::Trans);
+        const bool trans_b = (op_other == matrixlib::Op::Trans);
+        const int m = trans_a ? m_col : m_row;
+        const int k = trans_a ? m_row : m_col;
+        const int k_other = trans_b ? other.m_col : other.m_row;
+        const int n = trans_b ? other.m_row : other.m_col;
+        if (k != k_other) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        MATRIXLIB_INSTRUMENT(MultiplyByMatrix, m, n, k, 2.0 * m * n * k,
+                             (static_cast<double>(m) * k + static_cast<double>(k) * n + static_cast<double>(m) * n) * sizeof(T));
+        Matrix result(m, n, data.get_allocator());
+        const std::ptrdiff_t rs_a = trans_a ? 1 : m_stride;
+        const std::ptrdiff_t cs_a = trans_a ? m_stride : 1;
+        const std::ptrdiff_t rs_b = trans_b ? 1 : other.m_stride;
+        const std::ptrdiff_t cs_b = trans_b ? other.m_stride : 1;
+        matrixlib::gemm<T>(m, n, k, static_cast<T>(1), data.data(), rs_a, cs_a, other.data.data(), rs_b, cs_b,
+                           static_cast<T>(0), result.data.data(), result.m_stride);
+        return result;
+    }
+
+    /**
+     * @brief Computes the Gram matrix A^T * A (op = Trans) or A * A^T (op = NoTrans).
+     * A is read in place. The result is symmetric, so only its upper triangle is computed (see
+     * rankUpdate()) and then mirrored: about half the work of a full product.
+     * @param op Which side the transpose is on.
+     * @return The symmetric Gram matrix (cols x cols for Trans, rows x rows for NoTrans).
+     * @note Example: Matrix<double> g = features.gram();
+     */
+    Matrix gram(matrixlib::Op op = matrixlib::Op::Trans) const {
+        const bool trans = (op == matrixlib::Op::Trans);
+        const int n = trans ? m_col : m_row;
+        const int k = trans ? m_row : m_col;
+        MATRIXLIB_INSTRUMENT(RankUpdate, n, n, k, static_cast<double>(n) * (n + 1) * k,
+                             (static_cast<double>(n) * k + static_cast<double>(n) * n) * sizeof(T));
+        Matrix result(n, n, data.get_allocator());
+        result.symmetricUpdate(static_cast<T>(1), *this, trans, k, static_cast<T>(0));
+        return result;
+    }
+
+    /**
+     * @brief Fused in-place product: this = alpha * op(A) * op(B) + beta * this.
+     * Operands are read in place through their strides (transposes included) and the product is
+     * accumulated straight into this matrix, so nothing is allocated and this matrix is read and
+     * written once. When beta is zero its old contents are not read.
+     * @param alpha Scale of the product.
+     * @param a Left operand: a Matrix (any allocator), a view or a FixedMatrix.
+     * @param op_a Transformation of a.
+     * @param b Right operand, same kinds as a.
+     * @param op_b Transformation of b.
+     * @param beta Scale of the current contents.
+     * @throws std::invalid_argument if the inner dimensions differ, this matrix is not
+     * op(A).rows x op(B).cols, or an operand shares memory with this matrix.
+     * @note Example: c.multiplyAdd(0.5, a, matrixlib::Op::NoTrans, b, matrixlib::Op::NoTrans, 1.0); // c += 0.5 * a * b
+     */
+    template <typename A, typename B>
+        requires matrixlib::detail::StridedExpr<A> && matrixlib::detail::StridedExpr<B>
+    Matrix& multiplyAdd(T alpha, const MatrixExpr<A>& a, matrixlib::Op op_a,
+                        const MatrixExpr<B>& b, matrixlib::Op op_b, T beta) {
+        const A& x = a.self();
+        const B& y = b.self();
+        static_assert(std::is_same_v<T, std::remove_const_t<typename A::value_type>> &&
+                      std::is_same_v<T, std::remove_const_t<typename B::value_type>>,
+                      "Operands must have the same element type.");
+        const bool trans_a = (op_a == matrixlib::Op::Trans);
+        const bool trans_b = (op_b == matrixlib::Op::Trans);
+        const int m = trans_a ? x.getCols() : x.getRows();
+        const int k = trans_a ? x.getRows() : x.getCols();
+        const int k_other = trans_b ? y.getCols() : y.getRows();
+        const int n = trans_b ? y.getRows() : y.getCols();
+        if (k != k_other) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        if (m != m_row || n != m_col) {
+            throw std::invalid_argument("Output matrix has the wrong dimensions.\n");
+        }
+        if (sharesMemoryWith(x) || sharesMemoryWith(y)) {
+            throw std::invalid_argument("Output matrix must not share memory with an operand.\n");
+        }
+        MATRIXLIB_INSTRUMENT(MultiplyAdd, m, n, k, 2.0 * m * n * k,
+                             (static_cast<double>(m) * k + static_cast<double>(k) * n + 2.0 * m * n) * sizeof(T));
+        matrixlib::gemm<T>(m, n, k, alpha,
+                           x.stridedData(), trans_a ? x.colStride() : x.rowStride(), trans_a ? x.rowStride() : x.colStride(),
+                           y.stridedData(), trans_b ? y.colStride() : y.rowStride(), trans_b ? y.rowStride() : y.colStride(),
+                           beta, data.data(), m_stride);
+        return *this;
+    }
+
+    /**
+     * @brief Scaled addition (AXPY / AXPBY): this = alpha * x + beta * this, in one pass.
+     * x may be any same-sized expression, including views and other allocators; it may also be
+     * this matrix itself. Nothing is allocated.
+     * @param alpha Scale of x.
+     * @param x Matrix or expression to add.
+     * @param beta Scale of the current contents (1 by default, i.e. this += alpha * x).
+     * @throws std::invalid_argument if sizes differ.
+     * @note Example: r.addScaled(-step, gradient); // r -= step * gradient
+     */
+    template <typename E>
+    Matrix& addScaled(T alpha, const MatrixExpr<E>& x, T beta = static_cast<T>(1)) {
+        const E& source = x.self();
+        matrixlib::detail::checkSameSize(*this, source);
+        MATRIXLIB_INSTRUMENT(AddScaled, m_row, m_col, 0, 2 * static_cast<double>(m_row) * m_col, 3 * static_cast<double>(m_row) * m_col * sizeof(T));
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int r = row_begin; r < row_end; r++) {
+                T* dst = rowData(r);
+                if (beta == static_cast<T>(1)) {
+                    for (int c = 0; c < m_col; c++) {
+                        dst[c] += alpha * source.coeff(r, c);
+                    }
+                } else {
+                    for (int c = 0; c < m_col; c++) {
+                        dst[c] = alpha * source.coeff(r, c) + beta * dst[c];
+                    }
+                }
+            }
+        });
+        return *this;
+    }
+
+    /**
+     * @brief Symmetric rank-k update: this = alpha * op(A) * op(A)^T + beta * this.
+     * With op = Trans the product is A^T * A, with NoTrans it is A * A^T. Only the upper
+     * triangle is computed (about half the work of multiplyAdd) and then mirrored, so this matrix
+     * must be symmetric on entry when beta is nonzero; its lower triangle is not read.
+     * @param alpha Scale of the product.
+     * @param a Operand: a Matrix (any allocator), a view or a FixedMatrix.
+     * @param op Which side the transpose is on.
+     * @param beta Scale of the current contents.
+     * @throws std::invalid_argument if this matrix has the wrong size or shares memory with a.
+     * @note Example: cov.rankUpdate(1.0 / samples, batch, matrixlib::Op::Trans, 1.0);
+     */
+    template <typename A>
+        requires matrixlib::detail::StridedExpr<A>
+    Matrix& rankUpdate(T alpha, const MatrixExpr<A>& a, matrixlib::Op op, T beta) {
+        const A& x = a.self();
+        static_assert(std::is_same_v<T, std::remove_const_t<typename A::value_type>>,
+                      "Operands must have the same element type.");
+        const bool trans = (op == matrixlib::Op::Trans);
+        const int n = trans ? x.getCols() : x.getRows();
+        const int k = trans ? x.getRows() : x.getCols();
+        if (m_row != n || m_col != n) {
+            throw std::invalid_argument("Output matrix has the wrong dimensions.\n");
+        }
+        if (sharesMemoryWith(x)) {
+            throw std::invalid_argument("Output matrix must not share memory with an operand.\n");
+        }
+        //Half of a k-inner product; A is read once and this matrix read (beta != 0) and written once
+        MATRIXLIB_INSTRUMENT(RankUpdate, n, n, k, static_cast<double>(n) * (n + 1) * k,
+                             (static_cast<double>(n) * k + 2.0 * n * n) * sizeof(T));
+        symmetricUpdate(alpha, x, trans, k, beta);
+        return *this;
+    }
+
+    /**
+     * @brief Computes the Householder QR factorization of the matrix (any shape).
+     * The returned object can be reused for any number of least squares solves.
+     * @return The factorization.
+     * @note Example: QR_Factorization<double> qr = mat.qr();
+     */
+    QR_Factorization<T, Alloc> qr() const {
+        return QR_Factorization<T, Alloc>(*this);
+    }
+
+    /**
+     * @brief Solves the least squares problem min ||A * X - B|| for all columns of B at once
+     * through Householder QR, without forming an inverse or the normal equations.
+     * The factorization lives in the scratch arena; only X is allocated.
+     * @param b Right-hand sides (rows x k).
+     * @return The solution X (cols x k).
+     * @throws std::invalid_argument if B has the wrong number of rows, the matrix has fewer rows
+     * than columns, or it is rank deficient.
+     * @note Example: Matrix<double> coeffs = design.solveLeastSquares(observations);
+     */
+    template <typename BAlloc>
+    Matrix<T, BAlloc> solveLeastSquares(const Matrix<T, BAlloc>& b) const {
+        Matrix<T, BAlloc> x(m_col, b.getCols());
+        matrixlib::ScratchScope scope;
+        QR_Factorization<T, matrixlib::ArenaAllocator<T>> factors{Matrix<T, matrixlib::ArenaAllocator<T>>(*this)};
+        factors.solve(b, x);
+        return x;
+    }
+
+private:
+    /**
+     * @brief Transposed copy shared by transpose() and transposed(), which record the call.
+     */
+    Matrix transposedCopy() const {
+        Matrix result(m_col, m_row, data.get_allocator());
+        matrixlib::transpose(m_row, m_col, data.data(), m_stride, result.data.data(), result.m_stride);
+        result.precision = precision;
+        return result;
+    }
+
+    /**
+     * @brief Upper-triangle SYRK into this (already validated) n x n matrix, then mirrored.
+     * Shared by rankUpdate() and gram(), which record the call.
+     */
+    template <typename A>
+    void symmetricUpdate(T alpha, const A& x, bool trans, int k, T beta) {
+        matrixlib::syrk<T>(matrixlib::Triangle::Upper, m_row, k, alpha, x.stridedData(),
+                           trans ? x.colStride() : x.rowStride(), trans ? x.rowStride() : x.colStride(),
+                           beta, data.data(), m_stride);
+        matrixlib::detail::mirrorTriangle(matrixlib::Triangle::Upper, m_row, data.data(), m_stride);
+    }
+
+    /**
+     * @brief Checks whether any element of a strided operand lies in this matrix's buffer.
+     */
+    template <typename E>
+    bool sharesMemoryWith(const E& operand) const {
+        if (operand.getRows() == 0 || operand.getCols() == 0 || data.empty()) {
+            return false;
+        }
+        //Address range spanned by the operand, whatever the signs of its strides
+        const std::ptrdiff_t row_span = (operand.getRows() - 1) * operand.rowStride();
+        const std::ptrdiff_t col_span = (operand.getCols() - 1) * operand.colStride();
+        const T* base = operand.stridedData();
+        const T* first = base + std::min<std::ptrdiff_t>(row_span, 0) + std::min<std::ptrdiff_t>(col_span, 0);
+        const T* last = base + std::max<std::ptrdiff_t>(row_span, 0) + std::max<std::ptrdiff_t>(col_span, 0);
+        std::less<const T*> before;
+        return !before(last, data.data()) && before(first, data.data() + data.size());
+    }
+
+    /**
+     * @brief Changes the row stride, keeping the element values.
+     * Rows are moved back-to-front inside the grown buffer, so no second buffer is allocated.
+     * @param new_stride New leading dimension, must not be smaller than m_stride.
+     */
+    void restride(int new_stride) {
+        int old_stride = m_stride;
+        data.resize(static_cast<std::size_t>(m_row) * new_stride);
+        for (int r = m_row - 1; r > 0; r--) {
+            T* src = data.data() + static_cast<std::size_t>(r) * old_stride;
+            std::copy_backward(src, src + old_stride, data.data() + static_cast<std::size_t>(r) * new_stride + old_stride);
+        }
+        for (int r = 0; r < m_row; r++) {
+            T* row = data.data() + static_cast<std::size_t>(r) * new_stride;
+            std::fill(row + old_stride, row + new_stride, T{});
+        }
+        m_stride = new_stride;
+    }
+
+public:
+    // --- OPERATORS ---
+
+    /**
+     * @brief Compound assignment operator for addition.
+     * @note Example: matA += matB;
+     */
+    Matrix& operator+=(const Matrix& other) {
+        addMatrix(other);
+        return *this;
+    }
+
+    /**
+     * @brief Compound assignment operator for subtraction.
+     * @note Example: matA -= matB;
+     */
+    Matrix& operator-=(const Matrix& other) {
+        subtractMatrix(other);
+        return *this;
+    }
+
+    /**
+     * @brief Compound assignment operator adding an element-wise expression in one pass.
+     * @throws std::invalid_argument if sizes differ.
+     * @note Example: matA += matB * 2.0;
+     */
+    template <typename E>
+        requires (!std::is_same_v<E, Matrix>)
+    Matrix& operator+=(const MatrixExpr<E>& expr) {
+        const E& source = expr.self();
+        matrixlib::detail::checkSameSize(*this, source);
+        if (matrixlib::detail::readsThroughView(source, data.data(), data.data() + data.size())) {
+            return *this = *this + source; //Reads this matrix shifted or transposed
+        }
+        MATRIXLIB_INSTRUMENT(Expression, m_row, m_col, 0, static_cast<double>(m_row) * m_col, 3 * static_cast<double>(m_row) * m_col * sizeof(T));
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int r = row_begin; r < row_end; r++) {
+                T* dst = rowData(r);
+                for (int c = 0; c < m_col; c++) {
+                    dst[c] += source.coeff(r, c);
+                }
+            }
+        });
+        return *this;
+    }
+
+    /**
+     * @brief Compound assignment operator subtracting an element-wise expression in one pass.
+     * @throws std::invalid_argument if sizes differ.
+     * @note Example: matA -= matB / 2.0;
+     */
+    template <typename E>
+        requires (!std::is_same_v<E, Matrix>)
+    Matrix& operator-=(const MatrixExpr<E>& expr) {
+        const E& source = expr.self();
+        matrixlib::detail::checkSameSize(*this, source);
+        if (matrixlib::detail::readsThroughView(source, data.data(), data.data() + data.size())) {
+            return *this = *this - source; //Reads this matrix shifted or transposed
+        }
+        MATRIXLIB_INSTRUMENT(Expression, m_row, m_col, 0, static_cast<double>(m_row) * m_col, 3 * static_cast<double>(m_row) * m_col * sizeof(T));
+        matrixlib::parallelRows(m_row, static_cast<long long>(m_row) * m_col, [&](int row_begin, int row_end) {
+            for (int r = row_begin; r < row_end; r++) {
+                T* dst = rowData(r);
+                for (int c = 0; c < m_col; c++) {
+                    dst[c] -= source.coeff(r, c);
+                }
+            }
+        });
+        return *this;
+    }
+
+    /**
+     * @brief Compound assignment operator for scalar multiplication.
+     * @note Example: matA *= 2.0;
+     */
+    Matrix& operator*=(T constant) {
+        multiplyByConstant(constant);
+        return *this;
+    }
+
+    /**
+     * @brief Compound assignment operator for scalar division.
+     * @throws std::invalid_argument if dividing by zero.
+     * @note Example: matA /= 2.0;
+     */
+    Matrix& operator/=(T constant) {
+        divideByConstant(constant);
+        return *this;
+    }
+};
+
+/**
+ * @brief Binary operator for matrix multiplication. Returns a new object.
+ * Matrices, views and FixedMatrix operands are read in place through their strides;
+ * other expressions are evaluated first.
+ * @throws std::invalid_argument if column count of A != row count of B.
+ * @note Example: Matrix matC = matA * matB.block(0, 0, 3, 3);
+ */
+template <typename L, typename R>
+matrixlib::detail::result_matrix_t<L> operator*(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    using T = typename L::value_type;
+    using Result = matrixlib::detail::result_matrix_t<L>;
+    static_assert(std::is_same_v<T, typename R::value_type>, "Operands must have the same element type.");
+    if constexpr (!matrixlib::detail::StridedExpr<L>) {
+        return Result(Matrix<T>(lhs.self()) * rhs.self());
+    } else if constexpr (!matrixlib::detail::StridedExpr<R>) {
+        return lhs.self() * Matrix<T>(rhs.self());
+    } else {
+        const L& a = lhs.self();
+        const R& b = rhs.self();
+        if (a.getCols() != b.getRows()) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        const int m = a.getRows();
+        const int n = b.getCols();
+        const int k = a.getCols();
+        MATRIXLIB_INSTRUMENT(MultiplyByMatrix, m, n, k, 2.0 * m * n * k,
+                             (static_cast<double>(m) * k + static_cast<double>(k) * n + static_cast<double>(m) * n) * sizeof(T));
+        //A Matrix on the left keeps its allocator, so the product lands on the same heap
+        Result result = [&] {
+            if constexpr (std::is_same_v<L, Result>) {
+                return Result(m, n, a.getAllocator());
+            } else {
+                return Result(m, n);
+            }
+        }();
+        matrixlib::gemm<T>(m, n, k, static_cast<T>(1),
+                           a.stridedData(), a.rowStride(), a.colStride(),
+                           b.stridedData(), b.rowStride(), b.colStride(),
+                           static_cast<T>(0), result.rowData(0), result.getStride());
+        return result;
+    }
+}
+
+/**
+ * @brief Addition reusing the buffer of a temporary left operand.
+ * @note Example: Matrix matD = matA * matB + matC; // no second allocation
+ */
+template <typename T, typename A, typename R>
+Matrix<T, A> operator+(Matrix<T, A>&& lhs, const MatrixExpr<R>& rhs) {
+    lhs += rhs.self();
+    return std::move(lhs);
+}
+
+/**
+ * @brief Addition reusing the buffer of a temporary right operand.
+ */
+template <typename L, typename T, typename A>
+Matrix<T, A> operator+(const MatrixExpr<L>& lhs, Matrix<T, A>&& rhs) {
+    rhs += lhs.self();
+    return std::move(rhs);
+}
+
+/**
+ * @brief Addition of two temporaries, reusing the left buffer.
+ */
+template <typename T, typename A>
+Matrix<T, A> operator+(Matrix<T, A>&& lhs, Matrix<T, A>&& rhs) {
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+/**
+ * @brief Subtraction reusing the buffer of a temporary left operand.
+ */
+template <typename T, typename A, typename R>
+Matrix<T, A> operator-(Matrix<T, A>&& lhs, const MatrixExpr<R>& rhs) {
+    lhs -= rhs.self();
+    return std::move(lhs);
+}
+
+/**
+ * @brief Subtraction reusing the buffer of a temporary right operand.
+ */
+template <typename L, typename T, typename A>
+Matrix<T, A> operator-(const MatrixExpr<L>& lhs, Matrix<T, A>&& rhs) {
+    rhs = lhs.self() - rhs;
+    return std::move(rhs);
+}
+
+/**
+ * @brief Subtraction of two temporaries, reusing the left buffer.
+ */
+template <typename T, typename A>
+Matrix<T, A> operator-(Matrix<T, A>&& lhs, Matrix<T, A>&& rhs) {
+    lhs -= rhs;
+    return std::move(lhs);
+}
+
+/**
+ * @brief Scalar multiplication reusing the buffer of a temporary operand.
+ */
+template <typename T, typename A>
+Matrix<T, A> operator*(Matrix<T, A>&& lhs, typename Matrix<T, A>::value_type constant) {
+    lhs.multiplyByConstant(constant);
+    return std::move(lhs);
+}
+
+/**
+ * @brief Scalar multiplication (scalar on the left) reusing the buffer of a temporary operand.
+ */
+template <typename T, typename A>
+Matrix<T, A> operator*(typename Matrix<T, A>::value_type constant, Matrix<T, A>&& rhs) {
+    rhs = constant * rhs;
+    return std::move(rhs);
+}
+
+/**
+ * @brief Scalar division reusing the buffer of a temporary operand.
+ * @throws std::invalid_argument if dividing by zero.
+ */
+template <typename T, typename A>
+Matrix<T, A> operator/(Matrix<T, A>&& lhs, typename Matrix<T, A>::value_type constant) {
+    lhs.divideByConstant(constant);
+    return std::move(lhs);
+}
+
+//Defines the factorization returned by Matrix::qr()
+#include "QRFactorization.hpp"
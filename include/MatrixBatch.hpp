@@ -0,0 +1,445 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AlignedAllocator.hpp"
+#include "ThreadPool.hpp"
+#include "Matrix.hpp"
+#include "SquareMatrix.hpp"
+#include "FixedMatrix.hpp"
+
+/**
+ * @class MatrixBatch
+ * @brief Many independent matrices of one shape, stored interleaved (structure of arrays).
+ * Element (r, c) of every matrix in the batch is contiguous: matrix i keeps it at
+ * plane(r, c)[i]. Batched operations loop over matrices in the innermost loop, so SIMD lanes
+ * run across matrices and a 4x4 multiply costs a handful of vector instructions per 8 or 16
+ * matrices, with no per-matrix allocation or dispatch. Large batches are split across the
+ * shared thread pool. Determinant and inverse use closed-form expressions for sizes up to 4
+ * and fall back to Square_Matrix one matrix at a time for larger sizes.
+ * @note Example: MatrixBatch<float> a(100000, 4, 4), b(100000, 4, 4); MatrixBatch<float> c = a * b;
+ */
+template <typename T>
+class MatrixBatch
+{
+private:
+    static constexpr std::size_t alignment = 64;
+    static constexpr int lane_chunk = 256;
+
+    int m_count{};
+    int m_row{};
+    int m_col{};
+    std::size_t m_plane{}; //Distance between planes: m_count rounded up to a whole cache line
+    std::vector<T, AlignedAllocator<T, alignment>> data;
+
+    static std::size_t paddedCount(int count) {
+        constexpr std::size_t lanes = (sizeof(T) <= alignment && alignment % sizeof(T) == 0) ? alignment / sizeof(T) : 1;
+        return (static_cast<std::size_t>(count) + lanes - 1) / lanes * lanes;
+    }
+
+    void checkIndex(int index) const {
+        if (index < 0 || index >= m_count) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+    }
+
+    void checkSameShape(const MatrixBatch& other) const {
+        if (m_count != other.m_count) {
+            throw std::invalid_argument("Batches must hold the same number of matrices.\n");
+        }
+        if (m_row != other.m_row || m_col != other.m_col) {
+            throw std::invalid_argument("Both matrices must be the same size.\n");
+        }
+    }
+
+    /**
+     * @brief Runs fn(begin, end) over ranges of matrices, in parallel when the batch is large.
+     * @param work_per_matrix Approximate operations per matrix, used to decide on splitting.
+     */
+    template <typename F>
+    void forRanges(long long work_per_matrix, const F& fn) const {
+        matrixlib::parallelRows(m_count, static_cast<long long>(m_count) * work_per_matrix, fn);
+    }
+
+    static constexpr unsigned singular_lane = 1;   //closedFormRange(): a determinant was 0
+    static constexpr unsigned fractional_lane = 2; //closedFormRange(): an integer inverse would truncate
+
+    /**
+     * @brief Closed-form determinant or inverse over lanes [begin, end) for fixed N.
+     * Lanes are staged through small local tiles of width W, so the formulas run on fixed-size
+     * arrays the compiler can vectorize across matrices.
+     * When out is non-null it receives the inverses; the return value flags lanes that were
+     * singular or, for integral T, whose inverse has non-integer entries.
+     */
+    template <int N>
+    unsigned closedFormRange(int begin, int end, T* det, MatrixBatch* out) const {
+        constexpr int W = static_cast<int>(alignment / sizeof(T)) > 0 ? static_cast<int>(alignment / sizeof(T)) : 1;
+        alignas(alignment) T a[N * N][W];
+        alignas(alignment) T adj[N * N][W];
+        alignas(alignment) T d[W];
+        unsigned failed = 0;
+        for (int chunk = begin; chunk < end; chunk += W) {
+            const int width = std::min(W, end - chunk);
+            for (int e = 0; e < N * N; e++) {
+                std::copy(plane(e / N, e % N) + chunk, plane(e / N, e % N) + chunk + width, a[e]);
+                std::fill(a[e] + width, a[e] + W, static_cast<T>(e % (N + 1) == 0));
+            }
+            if (out == nullptr) {
+                for (int w = 0; w < W; w++) {
+                    d[w] = matrixlib::detail::closedFormDeterminant<N, T>([&](int r, int c) { return a[r * N + c][w]; });
+                }
+                std::copy(d, d + width, det + chunk);
+                continue;
+            }
+            for (int w = 0; w < W; w++) {
+                d[w] = matrixlib::detail::closedFormAdjugate<N, T>(
+                    [&](int r, int c) { return a[r * N + c][w]; },
+                    [&](int r, int c) -> T& { return adj[r * N + c][w]; });
+            }
+            for (int w = 0; w < width; w++) {
+                failed |= (d[w] == static_cast<T>(0)) ? singular_lane : 0u;
+                d[w] = (d[w] == static_cast<T>(0)) ? static_cast<T>(1) : d[w];
+            }
+            if constexpr (std::is_integral_v<T>) {
+                //Integer division would truncate: the adjugate must be divisible by the determinant
+                for (int e = 0; e < N * N; e++) {
+                    for (int w = 0; w < width; w++) {
+                        failed |= (adj[e][w] % d[w] != 0) ? fractional_lane : 0u;
+                    }
+                }
+            }
+            for (int e = 0; e < N * N; e++) {
+                T* dst = out->plane(e / N, e % N) + chunk;
+                for (int w = 0; w < width; w++) {
+                    dst[w] = adj[e][w] / d[w];
+                }
+            }
+        }
+        return failed;
+    }
+
+    /**
+     * @brief Gives the batch a new shape; the buffer is only reallocated when it is too small.
+     * Element values are unspecified afterwards.
+     */
+    void reshape(int count, int rows, int cols) {
+        m_count = count;
+        m_row = rows;
+        m_col = cols;
+        m_plane = paddedCount(count);
+        const std::size_t needed = m_plane * rows * cols;
+        if (data.size() < needed) {
+            data.resize(needed);
+        }
+    }
+
+    void requireSquare() const {
+        if (m_row != m_col) {
+            throw std::invalid_argument("Matrices in the batch must be square.\n");
+        }
+    }
+
+public:
+    using value_type = T;
+
+    /**
+     * @brief Constructs a batch of count zero matrices of size rows x cols.
+     * @throws std::invalid_argument if any dimension is negative.
+     * @note Example: MatrixBatch<double> batch(1024, 3, 3);
+     */
+    MatrixBatch(int count, int rows, int cols) : m_count(count), m_row(rows), m_col(cols) {
+        if (count < 0 || rows < 0 || cols < 0) {
+            throw std::invalid_argument("Number of rows and columns shall be greater than 0.\n");
+        }
+        m_plane = paddedCount(count);
+        data.resize(m_plane * rows * cols);
+    }
+
+    /**
+     * @brief Builds a batch from same-sized matrices.
+     * @throws std::invalid_argument if the matrices differ in size.
+     * @note Example: MatrixBatch<double> batch(std::vector<Matrix<double>>{a, b, c});
+     */
+    explicit MatrixBatch(const std::vector<Matrix<T>>& matrices)
+        : MatrixBatch(static_cast<int>(matrices.size()),
+                      matrices.empty() ? 0 : matrices[0].getRows(), matrices.empty() ? 0 : matrices[0].getCols()) {
+        for (int i = 0; i < m_count; i++) {
+            set(i, matrices[i]);
+        }
+    }
+
+    int size() const { return m_count; }
+    int getRows() const { return m_row; }
+    int getCols() const { return m_col; }
+
+    /**
+     * @brief Element (row, col) of every matrix: plane(row, col)[i] belongs to matrix i.
+     */
+    T* plane(int row, int col) { return data.data() + (static_cast<std::size_t>(row) * m_col + col) * m_plane; }
+    const T* plane(int row, int col) const { return data.data() + (static_cast<std::size_t>(row) * m_col + col) * m_plane; }
+
+    /**
+     * @brief Unchecked access to element (row, col) of matrix index.
+     * @note Example: batch(7, 0, 1) = 2.0;
+     */
+    T& operator()(int index, int row, int col) { return plane(row, col)[index]; }
+    const T& operator()(int index, int row, int col) const { return plane(row, col)[index]; }
+
+    /**
+     * @brief Copies a matrix into slot index of the batch.
+     * @throws std::invalid_argument if index is out of bounds or the size differs.
+     * @note Example: batch.set(0, rotation);
+     */
+    void set(int index, const Matrix<T>& mat) {
+        checkIndex(index);
+        if (mat.getRows() != m_row || mat.getCols() != m_col) {
+            throw std::invalid_argument("Both matrices must be the same size.\n");
+        }
+        for (int r = 0; r < m_row; r++) {
+            for (int c = 0; c < m_col; c++) {
+                (*this)(index, r, c) = mat(r, c);
+            }
+        }
+    }
+
+    /**
+     * @brief Copies matrix index out of the batch.
+     * @throws std::invalid_argument if index is out of bounds.
+     * @note Example: Matrix<double> m = batch.get(3);
+     */
+    Matrix<T> get(int index) const {
+        checkIndex(index);
+        Matrix<T> mat(m_row, m_col);
+        for (int r = 0; r < m_row; r++) {
+            for (int c = 0; c < m_col; c++) {
+                mat(r, c) = (*this)(index, r, c);
+            }
+        }
+        return mat;
+    }
+
+    /**
+     * @brief Multiplies matrix i of this batch by matrix i of other, for every i.
+     * @throws std::invalid_argument if the batches differ in length or the inner dimensions differ.
+     * @note Example: MatrixBatch<float> c = a.multiply(b);
+     */
+    MatrixBatch multiply(const MatrixBatch& other) const {
+        MatrixBatch result(0, 0, 0);
+        multiply(other, result);
+        return result;
+    }
+
+    /**
+     * @brief Multiplies batch-wise into an existing batch, reusing its buffer when the shape fits.
+     * Repeated per-frame products then neither allocate nor fault in fresh pages.
+     * @param other Right operands.
+     * @param result Receives the products; must not be one of the operands.
+     * @throws std::invalid_argument if the shapes do not match or result aliases an operand.
+     * @note Example: a.multiply(b, c);
+     */
+    void multiply(const MatrixBatch& other, MatrixBatch& result) const {
+        if (m_count != other.m_count) {
+            throw std::invalid_argument("Batches must hold the same number of matrices.\n");
+        }
+        if (m_col != other.m_row) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        if (&result == this || &result == &other) {
+            throw std::invalid_argument("Result must not alias an operand.\n");
+        }
+        result.reshape(m_count, m_row, other.m_col);
+        forRanges(2LL * m_row * m_col * other.m_col, [&](int begin, int end) {
+            //Short lane chunks keep every plane touched by the chunk resident in L1
+            for (int chunk = begin; chunk < end; chunk += lane_chunk) {
+                const int chunk_end = std::min(end, chunk + lane_chunk);
+                for (int r = 0; r < m_row; r++) {
+                    for (int c = 0; c < other.m_col; c++) {
+                        T* out = result.plane(r, c);
+                        std::fill(out + chunk, out + chunk_end, static_cast<T>(0));
+                        for (int k = 0; k < m_col; k++) {
+                            const T* a = plane(r, k);
+                            const T* b = other.plane(k, c);
+#pragma GCC ivdep
+                            for (int i = chunk; i < chunk_end; i++) {
+                                out[i] += a[i] * b[i];
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Adds matrix i of other to matrix i of this batch, for every i.
+     * @throws std::invalid_argument if the batches differ in length or shape.
+     * @note Example: a.addBatch(b);
+     */
+    void addBatch(const MatrixBatch& other) {
+        checkSameShape(other);
+        forRanges(static_cast<long long>(m_row) * m_col, [&](int begin, int end) {
+            for (int e = 0; e < m_row * m_col; e++) {
+                T* dst = data.data() + e * m_plane;
+                const T* src = other.data.data() + e * m_plane;
+#pragma GCC ivdep
+                for (int i = begin; i < end; i++) {
+                    dst[i] += src[i];
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Subtracts matrix i of other from matrix i of this batch, for every i.
+     * @throws std::invalid_argument if the batches differ in length or shape.
+     * @note Example: a.subtractBatch(b);
+     */
+    void subtractBatch(const MatrixBatch& other) {
+        checkSameShape(other);
+        forRanges(static_cast<long long>(m_row) * m_col, [&](int begin, int end) {
+            for (int e = 0; e < m_row * m_col; e++) {
+                T* dst = data.data() + e * m_plane;
+                const T* src = other.data.data() + e * m_plane;
+#pragma GCC ivdep
+                for (int i = begin; i < end; i++) {
+                    dst[i] -= src[i];
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Returns the batch of transposed matrices. Whole planes are moved, so no
+     * element-wise shuffling within a matrix is needed.
+     * @note Example: MatrixBatch<double> t = batch.transposed();
+     */
+    MatrixBatch transposed() const {
+        MatrixBatch result(m_count, m_col, m_row);
+        forRanges(static_cast<long long>(m_row) * m_col, [&](int begin, int end) {
+            for (int r = 0; r < m_row; r++) {
+                for (int c = 0; c < m_col; c++) {
+                    std::copy(plane(r, c) + begin, plane(r, c) + end, result.plane(c, r) + begin);
+                }
+            }
+        });
+        return result;
+    }
+
+    /**
+     * @brief Calculates the determinant of every matrix in the batch.
+     * @return Determinants, one per matrix.
+     * @throws std::invalid_argument if the matrices are not square.
+     * @note Example: std::vector<double> dets = batch.determinant();
+     */
+    std::vector<T> determinant() const {
+        requireSquare();
+        std::vector<T> det(m_count);
+        const int n = m_row;
+        forRanges(static_cast<long long>(n) * n * n, [&](int begin, int end) {
+            switch (n) {
+            case 0: std::fill(det.begin() + begin, det.begin() + end, static_cast<T>(1)); break;
+            case 1: closedFormRange<1>(begin, end, det.data(), nullptr); break;
+            case 2: closedFormRange<2>(begin, end, det.data(), nullptr); break;
+            case 3: closedFormRange<3>(begin, end, det.data(), nullptr); break;
+            case 4: closedFormRange<4>(begin, end, det.data(), nullptr); break;
+            default:
+                for (int i = begin; i < end; i++) {
+                    det[i] = Square_Matrix<T>(get(i)).determinant();
+                }
+            }
+        });
+        return det;
+    }
+
+    /**
+     * @brief Calculates the inverse of every matrix in the batch.
+     * @return The batch of inverses.
+     * @throws std::invalid_argument if the matrices are not square or any of them is singular.
+     * @note Recommended to use with floating point types (float/double).
+     * @note Example: MatrixBatch<float> inv = batch.inverse();
+     */
+    MatrixBatch inverse() const {
+        MatrixBatch result(0, 0, 0);
+        inverse(result);
+        return result;
+    }
+
+    /**
+     * @brief Inverts every matrix into an existing batch, reusing its buffer when the shape fits.
+     * result may be this batch (in-place inversion); the inverses are then built in a scratch
+     * batch and moved in only when all of them exist, so a singular matrix leaves this batch
+     * unchanged.
+     * @param result Receives the inverses; unspecified if an exception is thrown (unless it is this batch).
+     * @throws std::invalid_argument if the matrices are not square, any of them is singular or,
+     * for integral T, any inverse is not an integer matrix.
+     * @note Example: batch.inverse(batch);
+     */
+    void inverse(MatrixBatch& result) const {
+        requireSquare();
+        if (&result == this) {
+            MatrixBatch inverted(0, 0, 0);
+            inverse(inverted);
+            result = std::move(inverted);
+            return;
+        }
+        const int n = m_row;
+        result.reshape(m_count, n, n);
+        std::atomic<unsigned> failed{0};
+        forRanges(static_cast<long long>(n) * n * n, [&](int begin, int end) {
+            unsigned any = 0;
+            switch (n) {
+            case 0: break;
+            case 1: any = closedFormRange<1>(begin, end, nullptr, &result); break;
+            case 2: any = closedFormRange<2>(begin, end, nullptr, &result); break;
+            case 3: any = closedFormRange<3>(begin, end, nullptr, &result); break;
+            case 4: any = closedFormRange<4>(begin, end, nullptr, &result); break;
+            default:
+                for (int i = begin; i < end; i++) {
+                    result.set(i, Square_Matrix<T>(get(i)).inverse());
+                }
+            }
+            if (any != 0) {
+                failed.fetch_or(any, std::memory_order_relaxed);
+            }
+        });
+        if (failed.load() & singular_lane) {
+            throw std::invalid_argument("Cannot calculate inverse: Determinant is 0.\n");
+        }
+        if (failed.load() & fractional_lane) {
+            throw std::invalid_argument("Inverse is not an integer matrix.\n");
+        }
+    }
+};
+
+/**
+ * @brief Batched multiplication: matrix i of the result is lhs[i] * rhs[i].
+ * @note Example: MatrixBatch<float> c = a * b;
+ */
+template <typename T>
+MatrixBatch<T> operator*(const MatrixBatch<T>& lhs, const MatrixBatch<T>& rhs) {
+    return lhs.multiply(rhs);
+}
+
+/**
+ * @brief Batched addition: matrix i of the result is lhs[i] + rhs[i].
+ * @note Example: MatrixBatch<float> c = a + b;
+ */
+template <typename T>
+MatrixBatch<T> operator+(MatrixBatch<T> lhs, const MatrixBatch<T>& rhs) {
+    lhs.addBatch(rhs);
+    return lhs;
+}
+
+/**
+ * @brief Batched subtraction: matrix i of the result is lhs[i] - rhs[i].
+ * @note Example: MatrixBatch<float> c = a - b;
+ */
+template <typename T>
+MatrixBatch<T> operator-(MatrixBatch<T> lhs, const MatrixBatch<T>& rhs) {
+    lhs.subtractBatch(rhs);
+    return lhs;
+}
@@ -0,0 +1,211 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "AlignedAllocator.hpp"
+#include "Matrix.hpp"
+
+/**
+ * @class MatrixBuilder
+ * @brief Collects rows from one or more producer threads into a single buffer and hands that
+ * buffer to a Matrix without copying.
+ * The buffer has the same layout as a Matrix (padded row stride, allocator Alloc). Its row
+ * capacity doubles whenever it runs out, so appending n rows costs O(n) overall. Producers only
+ * take the lock to claim a range of rows and then copy (or write) their rows concurrently; a
+ * producer that needs more capacity waits for the copies in flight before the buffer moves.
+ * Each chunk lands in consecutive rows; chunks from different threads appear in the order they
+ * claimed their rows, which the return values report.
+ * @note Example:
+ * MatrixBuilder<double> builder(64);
+ * builder.reserve(1000000);
+ * // on any number of threads:
+ * builder.addRows(chunk);
+ * Matrix<double> table = builder.build();
+ */
+template <typename T, typename Alloc = AlignedAllocator<T>>
+class MatrixBuilder
+{
+private:
+    int m_cols;
+    int m_stride;
+    int m_rows = 0;
+    int m_capacity = 0; //Rows that fit in m_data
+    int m_writers = 0;  //Producers copying into m_data outside the lock
+    std::vector<T, Alloc> m_data;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_idle;
+
+    /**
+     * @brief Makes room for rows rows. Requires the lock and no writers.
+     */
+    void grow(int rows) {
+        const int capacity = std::max(rows, std::max(2 * m_capacity, 16));
+        m_data.resize(static_cast<std::size_t>(capacity) * m_stride);
+        m_capacity = capacity;
+    }
+
+    /**
+     * @brief Claims count rows at the end, growing the buffer if needed, and registers a writer.
+     * @return Index of the first claimed row.
+     */
+    int claim(std::unique_lock<std::mutex>& lock, int count) {
+        while (m_rows + count > m_capacity) {
+            if (m_writers == 0) {
+                grow(m_rows + count);
+            } else {
+                m_idle.wait(lock);
+            }
+        }
+        const int first = m_rows;
+        m_rows += count;
+        m_writers++;
+        return first;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_writers == 0) {
+            m_idle.notify_all();
+        }
+    }
+
+public:
+    /**
+     * @brief Creates an empty builder for rows of cols elements.
+     * @param cols Number of columns of every row.
+     * @param alloc Allocator of the buffer (and of the Matrix built from it).
+     * @throws std::invalid_argument if cols is negative.
+     * @note Example: MatrixBuilder<float> builder(128);
+     */
+    explicit MatrixBuilder(int cols, const Alloc& alloc = Alloc())
+        : m_cols(cols), m_stride(0), m_data(alloc) {
+        if (cols < 0) {
+            throw std::invalid_argument("Number of rows and columns shall be greater than 0.\n");
+        }
+        m_stride = Matrix<T, Alloc>::paddedStride(cols);
+    }
+
+    MatrixBuilder(const MatrixBuilder&) = delete;
+    MatrixBuilder& operator=(const MatrixBuilder&) = delete;
+
+    /**
+     * @brief Number of rows appended so far.
+     */
+    int getRows() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_rows;
+    }
+
+    /**
+     * @brief Number of columns of every row.
+     */
+    int getCols() const { return m_cols; }
+
+    /**
+     * @brief Makes room for rows rows in total, so appending up to that many does not reallocate.
+     * @note Example: builder.reserve(1000000);
+     */
+    void reserve(int rows) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [&] { return m_capacity >= rows || m_writers == 0; });
+        if (rows > m_capacity) {
+            m_data.resize(static_cast<std::size_t>(rows) * m_stride);
+            m_capacity = rows;
+        }
+    }
+
+    /**
+     * @brief Appends count rows, letting fill write them in place: fill(i, row) must store the
+     * m_cols elements of the i-th new row at row. Runs concurrently with other producers.
+     * If fill throws, the claimed rows stay in the matrix with whatever was written (zeros
+     * otherwise).
+     * @return Index of the first new row.
+     * @note Example: builder.appendRows(n, [&](int i, double* row) { parse(lines[i], row); });
+     */
+    template <typename F>
+    int appendRows(int count, const F& fill) {
+        if (count < 0) {
+            throw std::invalid_argument("Number of rows and columns shall be greater than 0.\n");
+        }
+        int first;
+        T* base;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            first = claim(lock, count);
+            base = m_data.data() + static_cast<std::size_t>(first) * m_stride;
+        }
+        try {
+            for (int i = 0; i < count; i++) {
+                fill(i, base + static_cast<std::size_t>(i) * m_stride);
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+        release();
+        return first;
+    }
+
+    /**
+     * @brief Appends count rows stored row-major at values, consecutive rows ld elements apart.
+     * @return Index of the first new row.
+     * @note Example: builder.addRows(chunk, 1000, 64);
+     */
+    int addRows(const T* values, int count, std::ptrdiff_t ld) {
+        return appendRows(count, [&](int i, T* row) {
+            const T* src = values + i * ld;
+            std::copy(src, src + m_cols, row);
+        });
+    }
+
+    /**
+     * @brief Appends all rows of chunk.
+     * @return Index of the first new row.
+     * @throws std::invalid_argument if chunk has a different number of columns.
+     * @note Example: builder.addRows(chunk);
+     */
+    template <typename ChunkAlloc>
+    int addRows(const Matrix<T, ChunkAlloc>& chunk) {
+        if (chunk.getCols() != m_cols) {
+            throw std::invalid_argument("Size of vector is not equal to number of columns.\n");
+        }
+        return appendRows(chunk.getRows(), [&](int i, T* row) {
+            std::copy(chunk.rowData(i), chunk.rowData(i) + m_cols, row);
+        });
+    }
+
+    /**
+     * @brief Appends one row.
+     * @return Index of the new row.
+     * @throws std::invalid_argument if values does not have one element per column.
+     * @note Example: builder.addRow({1.0, 2.0, 3.0});
+     */
+    int addRow(const std::vector<T>& values) {
+        if (static_cast<int>(values.size()) != m_cols) {
+            throw std::invalid_argument("Size of vector is not equal to number of columns.\n");
+        }
+        return addRows(values.data(), 1, m_cols);
+    }
+
+    /**
+     * @brief Moves the collected rows into a Matrix without copying and leaves the builder empty.
+     * Waits for producers that are still writing. Spare capacity stays with the Matrix; call
+     * Matrix::shrinkToFit() to release it.
+     * @note Example: Matrix<double> table = builder.build();
+     */
+    Matrix<T, Alloc> build() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [&] { return m_writers == 0; });
+        std::vector<T, Alloc> buffer(m_data.get_allocator());
+        buffer.swap(m_data);
+        buffer.resize(static_cast<std::size_t>(m_rows) * m_stride);
+        const int rows = m_rows;
+        m_rows = 0;
+        m_capacity = 0;
+        return Matrix<T, Alloc>(std::move(buffer), rows, m_cols, m_stride);
+    }
+};
@@ -0,0 +1,217 @@
+#pragma once
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include "AlignedAllocator.hpp"
+
+template <typename T, typename Alloc = AlignedAllocator<T>> class Matrix;
+
+/**
+ * @class MatrixExpr
+ * @brief CRTP base of every object that can appear in element-wise Matrix arithmetic.
+ * Derived types provide getRows(), getCols() and coeff(row, col). Matrix itself is a leaf
+ * expression; operators +, -, * (scalar) and / (scalar) build lightweight nodes that are
+ * evaluated in one fused pass when assigned to a Matrix.
+ * @note Expression nodes reference their Matrix operands, so store results in a Matrix
+ * (or call eval()) rather than in an `auto` variable that outlives those operands.
+ * @note Example: Matrix<double> r = a + b - c * 2.0; // one pass, one allocation
+ */
+template <typename E>
+class MatrixExpr
+{
+public:
+    /**
+     * @brief Returns the derived expression.
+     */
+    const E& self() const { return static_cast<const E&>(*this); }
+
+    /**
+     * @brief Evaluates the expression into a new Matrix.
+     * @note Example: (a + b).eval().printMatrix();
+     */
+    template <typename U = E>
+    Matrix<typename U::value_type> eval() const {
+        return Matrix<typename U::value_type>(self());
+    }
+};
+
+namespace matrixlib::detail {
+
+/**
+ * @brief Leaves (matrices) are held by reference, intermediate nodes by value.
+ */
+template <typename E>
+struct is_expression_leaf : std::false_type {};
+
+template <typename T, typename Alloc>
+struct is_expression_leaf<Matrix<T, Alloc>> : std::true_type {};
+
+template <typename E>
+using expr_storage = std::conditional_t<is_expression_leaf<E>::value, const E&, const E>;
+
+/**
+ * @brief Whether evaluating expr reads the buffer [begin, end) through a view, i.e. possibly at
+ * an element other than the one being written. Owning leaves are only read element-wise, so
+ * they never count; views and nodes over views answer through their readsThroughView() member.
+ */
+template <typename E>
+bool readsThroughView(const E& expr, const void* begin, const void* end) {
+    if constexpr (requires { expr.readsThroughView(begin, end); }) {
+        return expr.readsThroughView(begin, end);
+    } else {
+        return false;
+    }
+}
+
+/**
+ * @brief Matrix type produced from an expression: a Matrix operand keeps its allocator,
+ * anything else evaluates into a Matrix with the default allocator.
+ */
+template <typename E>
+struct result_matrix { using type = Matrix<typename E::value_type>; };
+
+template <typename T, typename Alloc>
+struct result_matrix<Matrix<T, Alloc>> { using type = Matrix<T, Alloc>; };
+
+template <typename E>
+using result_matrix_t = typename result_matrix<E>::type;
+
+/**
+ * @brief Element-wise combination of two same-sized expressions.
+ */
+template <typename L, typename R, typename Op>
+class BinaryExpr : public MatrixExpr<BinaryExpr<L, R, Op>>
+{
+private:
+    expr_storage<L> m_lhs;
+    expr_storage<R> m_rhs;
+
+public:
+    using value_type = typename L::value_type;
+    static_assert(std::is_same_v<value_type, typename R::value_type>, "Operands must have the same element type.");
+
+    BinaryExpr(const L& lhs, const R& rhs) : m_lhs(lhs), m_rhs(rhs) {}
+
+    int getRows() const { return m_lhs.getRows(); }
+    int getCols() const { return m_lhs.getCols(); }
+    value_type coeff(int row, int col) const { return Op{}(m_lhs.coeff(row, col), m_rhs.coeff(row, col)); }
+    bool readsThroughView(const void* begin, const void* end) const {
+        return detail::readsThroughView(m_lhs, begin, end) || detail::readsThroughView(m_rhs, begin, end);
+    }
+};
+
+/**
+ * @brief Element-wise combination of an expression with a scalar (expr op scalar).
+ */
+template <typename E, typename Op>
+class ScalarExpr : public MatrixExpr<ScalarExpr<E, Op>>
+{
+public:
+    using value_type = typename E::value_type;
+
+private:
+    expr_storage<E> m_expr;
+    value_type m_scalar;
+
+public:
+    ScalarExpr(const E& expr, value_type scalar) : m_expr(expr), m_scalar(scalar) {}
+
+    int getRows() const { return m_expr.getRows(); }
+    int getCols() const { return m_expr.getCols(); }
+    value_type coeff(int row, int col) const { return Op{}(m_expr.coeff(row, col), m_scalar); }
+    bool readsThroughView(const void* begin, const void* end) const { return detail::readsThroughView(m_expr, begin, end); }
+};
+
+/**
+ * @brief Scalar on the left (scalar * expr), kept separate so non-commutative T stay correct.
+ */
+template <typename E>
+class ScaledExpr : public MatrixExpr<ScaledExpr<E>>
+{
+public:
+    using value_type = typename E::value_type;
+
+private:
+    value_type m_scalar;
+    expr_storage<E> m_expr;
+
+public:
+    ScaledExpr(value_type scalar, const E& expr) : m_scalar(scalar), m_expr(expr) {}
+
+    int getRows() const { return m_expr.getRows(); }
+    int getCols() const { return m_expr.getCols(); }
+    value_type coeff(int row, int col) const { return m_scalar * m_expr.coeff(row, col); }
+    bool readsThroughView(const void* begin, const void* end) const { return detail::readsThroughView(m_expr, begin, end); }
+};
+
+/**
+ * @brief Expressions backed by a strided buffer; GEMM reads them in place instead of copying.
+ */
+template <typename E>
+concept StridedExpr = requires(const E& e) {
+    e.stridedData();
+    e.rowStride();
+    e.colStride();
+};
+
+template <typename L, typename R>
+void checkSameSize(const L& lhs, const R& rhs) {
+    if (lhs.getRows() != rhs.getRows() || lhs.getCols() != rhs.getCols()) {
+        throw std::invalid_argument("Both matrices must be the same size.\n");
+    }
+}
+
+} // namespace matrixlib::detail
+
+/**
+ * @brief Binary operator for addition. Returns a lazy expression.
+ * @throws std::invalid_argument if the operands differ in size.
+ * @note Example: Matrix matC = matA + matB;
+ */
+template <typename L, typename R>
+auto operator+(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    matrixlib::detail::checkSameSize(lhs.self(), rhs.self());
+    return matrixlib::detail::BinaryExpr<L, R, std::plus<>>(lhs.self(), rhs.self());
+}
+
+/**
+ * @brief Binary operator for subtraction. Returns a lazy expression.
+ * @throws std::invalid_argument if the operands differ in size.
+ * @note Example: Matrix matC = matA - matB;
+ */
+template <typename L, typename R>
+auto operator-(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    matrixlib::detail::checkSameSize(lhs.self(), rhs.self());
+    return matrixlib::detail::BinaryExpr<L, R, std::minus<>>(lhs.self(), rhs.self());
+}
+
+/**
+ * @brief Binary operator for scalar multiplication. Returns a lazy expression.
+ * @note Example: Matrix matB = matA * 5.0;
+ */
+template <typename E>
+auto operator*(const MatrixExpr<E>& expr, typename E::value_type constant) {
+    return matrixlib::detail::ScalarExpr<E, std::multiplies<>>(expr.self(), constant);
+}
+
+/**
+ * @brief Binary operator for scalar multiplication with the scalar on the left.
+ * @note Example: Matrix matB = 0.5 * matA;
+ */
+template <typename E>
+auto operator*(typename E::value_type constant, const MatrixExpr<E>& expr) {
+    return matrixlib::detail::ScaledExpr<E>(constant, expr.self());
+}
+
+/**
+ * @brief Binary operator for scalar division. Returns a lazy expression.
+ * @throws std::invalid_argument if dividing by zero.
+ * @note Example: Matrix matB = matA / 2.0;
+ */
+template <typename E>
+auto operator/(const MatrixExpr<E>& expr, typename E::value_type constant) {
+    if (constant == static_cast<typename E::value_type>(0)) {
+        throw std::invalid_argument("Constant must be a nonzero value.\n");
+    }
+    return matrixlib::detail::ScalarExpr<E, std::divides<>>(expr.self(), constant);
+}
@@ -1,4 +1,33 @@
 #pragma once 
 
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+#include "ScratchArena.hpp"
+#include "HugePageAllocator.hpp"
+#include "Gemm.hpp"
+#include "MatrixExpression.hpp"
+#include "MatrixView.hpp"
+#include "TextFormat.hpp"
+#include "Transpose.hpp"
+#include "BinaryFormat.hpp"
 #include "Matrix.hpp"
+#include "MatrixBuilder.hpp"
+#include "TriangularSolve.hpp"
+#include "Syrk.hpp"
+#include "Reduction.hpp"
+#include "Strassen.hpp"
+#include "LUFactorization.hpp"
+#include "CholeskyFactorization.hpp"
+#include "QRFactorization.hpp"
+#include "MixedPrecision.hpp"
+#include "TaskGraph.hpp"
+#include "Fraction.hpp"
+#include "Bareiss.hpp"
 #include "SquareMatrix.hpp"
+#include "FixedMatrix.hpp"
+#include "MatrixBatch.hpp"
+#include "SparseMatrix.hpp"
+#include "SymmetricMatrix.hpp"
+#include "TriangularMatrix.hpp"
+#include "BandedMatrix.hpp"
+#include "MappedMatrix.hpp"
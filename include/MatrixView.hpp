@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "MatrixExpression.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @class MatrixView
+ * @brief Non-owning window onto elements of a Matrix (or any strided buffer).
+ * Element (r, c) lives at data[r * rowStride + c * colStride], so submatrices, single rows,
+ * strided columns and transposed layouts are all views without copying. Reads and writes go
+ * straight to the parent matrix, which must outlive the view. Views are MatrixExpr leaves, so they
+ * can be used in all element-wise arithmetic, and they are passed to GEMM with their strides.
+ * Use MatrixView<const T> for read-only access.
+ * @note Assigning to a view writes through element by element; if the source overlaps the view
+ * in a shifted or transposed way, evaluate it into a Matrix first (e.g. with eval()).
+ * @note Example: mat.block(0, 0, 2, 2) += other.block(1, 1, 2, 2);
+ */
+template <typename T>
+class MatrixView : public MatrixExpr<MatrixView<T>>
+{
+protected:
+    T* m_data = nullptr;
+    int m_rows = 0;
+    int m_cols = 0;
+    std::ptrdiff_t m_row_stride = 0;
+    std::ptrdiff_t m_col_stride = 1;
+
+    template <typename E>
+    void assignFrom(const E& expr) {
+        matrixlib::parallelRows(m_rows, static_cast<long long>(m_rows) * m_cols, [&](int row_begin, int row_end) {
+            for (int r = row_begin; r < row_end; r++) {
+                for (int c = 0; c < m_cols; c++) {
+                    (*this)(r, c) = expr.coeff(r, c);
+                }
+            }
+        });
+    }
+
+public:
+    using value_type = std::remove_const_t<T>;
+
+    /**
+     * @brief Creates a view over a strided buffer.
+     * @param data Address of element (0, 0).
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param row_stride Distance in elements between consecutive rows.
+     * @param col_stride Distance in elements between consecutive columns.
+     * @note Example: MatrixView<double> v(buffer, 3, 4, 4, 1);
+     */
+    MatrixView(T* data, int rows, int cols, std::ptrdiff_t row_stride, std::ptrdiff_t col_stride = 1)
+        : m_data(data), m_rows(rows), m_cols(cols), m_row_stride(row_stride), m_col_stride(col_stride) {}
+
+    MatrixView(const MatrixView&) = default;
+
+    /**
+     * @brief Allows a mutable view wherever a read-only view is expected.
+     */
+    operator MatrixView<const T>() const requires (!std::is_const_v<T>) {
+        return MatrixView<const T>(m_data, m_rows, m_cols, m_row_stride, m_col_stride);
+    }
+
+    int getRows() const { return m_rows; }
+    int getCols() const { return m_cols; }
+    std::ptrdiff_t rowStride() const { return m_row_stride; }
+    std::ptrdiff_t colStride() const { return m_col_stride; }
+    T* stridedData() const { return m_data; }
+
+    /**
+     * @brief Unchecked element access into the parent matrix.
+     * @note Example: view(0, 1) = 5.0;
+     */
+    T& operator()(int row, int col) const { return m_data[row * m_row_stride + col * m_col_stride]; }
+
+    /**
+     * @brief Element read used when the view appears inside an expression.
+     */
+    const T& coeff(int row, int col) const { return m_data[row * m_row_stride + col * m_col_stride]; }
+
+    /**
+     * @brief Whether any viewed element lies in [begin, end); used by Matrix assignment to
+     * detect a source that reads the destination in a shifted or transposed way.
+     */
+    bool readsThroughView(const void* begin, const void* end) const {
+        if (m_rows == 0 || m_cols == 0) {
+            return false;
+        }
+        const std::ptrdiff_t row_span = (m_rows - 1) * m_row_stride;
+        const std::ptrdiff_t col_span = (m_cols - 1) * m_col_stride;
+        const T* first = m_data + std::min<std::ptrdiff_t>(row_span, 0) + std::min<std::ptrdiff_t>(col_span, 0);
+        const T* last = m_data + std::max<std::ptrdiff_t>(row_span, 0) + std::max<std::ptrdiff_t>(col_span, 0);
+        const std::less<const void*> less;
+        return less(first, end) && !less(last, begin);
+    }
+
+    /**
+     * @brief Retrieves a single element with bounds checking.
+     * @throws std::invalid_argument if indices are out of bounds.
+     * @note Example: double val = view.getValue(1, 2);
+     */
+    value_type getValue(int row, int col) const {
+        if (row < 0 || row >= m_rows || col < 0 || col >= m_cols) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        return (*this)(row, col);
+    }
+
+    /**
+     * @brief Returns a view of a rectangular block of this view.
+     * @throws std::invalid_argument if the block does not fit.
+     * @note Example: auto inner = view.block(1, 1, 2, 2);
+     */
+    MatrixView block(int row, int col, int rows, int cols) const {
+        if (row < 0 || col < 0 || rows < 0 || cols < 0 || row + rows > m_rows || col + cols > m_cols) {
+            throw std::invalid_argument("Block out of bounds.\n");
+        }
+        return MatrixView(m_data + row * m_row_stride + col * m_col_stride, rows, cols, m_row_stride, m_col_stride);
+    }
+
+    /**
+     * @brief Returns the transposed view (strides swapped, nothing copied).
+     * @note Example: Matrix<double> gram = a.view().transposed() * a;
+     */
+    MatrixView transposed() const {
+        return MatrixView(m_data, m_cols, m_rows, m_col_stride, m_row_stride);
+    }
+
+    /**
+     * @brief Copies the viewed elements into a new std::vector, row by row.
+     */
+    std::vector<value_type> toVector() const {
+        std::vector<value_type> values;
+        values.reserve(static_cast<std::size_t>(m_rows) * m_cols);
+        for (int r = 0; r < m_rows; r++) {
+            for (int c = 0; c < m_cols; c++) {
+                values.push_back((*this)(r, c));
+            }
+        }
+        return values;
+    }
+
+    /**
+     * @brief Writes the elements of another view of the same size into this one.
+     * @throws std::invalid_argument if sizes differ.
+     */
+    MatrixView& operator=(const MatrixView& other) requires (!std::is_const_v<T>) {
+        matrixlib::detail::checkSameSize(*this, other);
+        assignFrom(other);
+        return *this;
+    }
+
+    /**
+     * @brief Writes an element-wise expression into the viewed elements.
+     * @throws std::invalid_argument if sizes differ.
+     * @note Example: mat.row(0) = other.row(1) * 2.0;
+     */
+    template <typename E>
+    MatrixView& operator=(const MatrixExpr<E>& expr) requires (!std::is_const_v<T>) {
+        matrixlib::detail::checkSameSize(*this, expr.self());
+        assignFrom(expr.self());
+        return *this;
+    }
+
+    /**
+     * @brief Fills every viewed element with a value.
+     * @note Example: mat.col(2).fill(0.0);
+     */
+    void fill(value_type value) const requires (!std::is_const_v<T>) {
+        for (int r = 0; r < m_rows; r++) {
+            for (int c = 0; c < m_cols; c++) {
+                (*this)(r, c) = value;
+            }
+        }
+    }
+
+    template <typename E>
+    MatrixView& operator+=(const MatrixExpr<E>& expr) requires (!std::is_const_v<T>) {
+        return *this = *this + expr.self();
+    }
+
+    template <typename E>
+    MatrixView& operator-=(const MatrixExpr<E>& expr) requires (!std::is_const_v<T>) {
+        return *this = *this - expr.self();
+    }
+
+    MatrixView& operator*=(value_type constant) requires (!std::is_const_v<T>) {
+        return *this = *this * constant;
+    }
+
+    /**
+     * @throws std::invalid_argument if dividing by zero.
+     */
+    MatrixView& operator/=(value_type constant) requires (!std::is_const_v<T>) {
+        return *this = *this / constant;
+    }
+};
+
+/**
+ * @class RowView
+ * @brief View of a single matrix row (1 x n, contiguous) with vector-style indexing.
+ * @note Example: for (int i = 0; i < r.size(); i++) r[i] *= 2;
+ */
+template <typename T>
+class RowView : public MatrixView<T>
+{
+public:
+    using MatrixView<T>::operator=;
+
+    RowView(T* data, int cols) : MatrixView<T>(data, 1, cols, cols, 1) {}
+
+    RowView& operator=(const RowView& other) requires (!std::is_const_v<T>) {
+        MatrixView<T>::operator=(other);
+        return *this;
+    }
+
+    int size() const { return this->m_cols; }
+    T& operator[](int i) const { return this->m_data[i]; }
+};
+
+/**
+ * @class ColView
+ * @brief View of a single matrix column (n x 1, strided by the row stride).
+ * @note Example: double top = mat.col(3)[0];
+ */
+template <typename T>
+class ColView : public MatrixView<T>
+{
+public:
+    using MatrixView<T>::operator=;
+
+    ColView(T* data, int rows, std::ptrdiff_t stride) : MatrixView<T>(data, rows, 1, stride, 1) {}
+
+    ColView& operator=(const ColView& other) requires (!std::is_const_v<T>) {
+        MatrixView<T>::operator=(other);
+        return *this;
+    }
+
+    int size() const { return this->m_rows; }
+    T& operator[](int i) const { return this->m_data[i * this->m_row_stride]; }
+};
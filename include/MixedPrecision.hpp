@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "Matrix.hpp"
+#include "LUFactorization.hpp"
+#include "ScratchArena.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @file MixedPrecision.hpp
+ * @brief Linear solves that factor in low precision and refine to working precision.
+ *
+ * The O(n^3) LU factorization runs in a narrower type (float), whose SIMD kernels process twice
+ * as many elements per instruction. The solution is then corrected with classical iterative
+ * refinement: the residual R = B - A * X is computed in the working precision (double) with one
+ * GEMM, the correction is solved with the low precision factors in O(n^2) and added back. For
+ * reasonably conditioned systems a few steps reach the accuracy of a full double solve. When
+ * refinement stalls or diverges (condition number near 1 / eps of the low type, or entries out
+ * of its range) the system is solved again with a working precision factorization.
+ */
+namespace matrixlib {
+
+/**
+ * @brief Default limit on refinement steps before falling back to a full precision solve.
+ */
+inline constexpr int refinement_max_iterations = 30;
+
+/**
+ * @struct RefinementInfo
+ * @brief What a mixed precision solve did.
+ */
+struct RefinementInfo {
+    int iterations = 0;     //Refinement steps run after the initial low precision solve
+    bool converged = false; //Refinement reached working precision accuracy
+    bool fallback = false;  //The system was solved again with a working precision factorization
+};
+
+/**
+ * @brief Solves A * X = B in place with a Low precision LU factorization and iterative
+ * refinement in T; falls back to an LU factorization in T if refinement fails.
+ * A column is accepted once ||r||_inf <= ||x||_inf * ||A||_inf * eps * sqrt(n), the stopping
+ * test of LAPACK's dsgesv. All workspace comes from the calling thread's scratch arena.
+ * @param a Square matrix A (n x n).
+ * @param x Right-hand sides on entry (n x k), the solution on exit.
+ * @param max_iterations Refinement steps allowed before falling back. Refinement also stops
+ * early when a step fails to halve the relative residual.
+ * @return How many steps ran, whether they converged and whether the fallback was used.
+ * @throws std::invalid_argument if sizes do not match, or the fallback finds A singular.
+ * @note Example: RefinementInfo info = matrixlib::solveRefinedInPlace<float>(a, x);
+ */
+template <typename Low, typename T, typename AAlloc, typename XAlloc>
+RefinementInfo solveRefinedInPlace(const Matrix<T, AAlloc>& a, Matrix<T, XAlloc>& x,
+                                   int max_iterations = refinement_max_iterations) {
+    const int n = a.getRows();
+    const int k = x.getCols();
+    if (a.getCols() != n) {
+        throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
+    }
+    if (x.getRows() != n) {
+        throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+    }
+    RefinementInfo info;
+    ScratchScope scope;
+    const Matrix<T, ArenaAllocator<T>> b(x);
+
+    T a_norm = static_cast<T>(0);
+    for (int r = 0; r < n; r++) {
+        const T* row = a.rowData(r);
+        T sum = static_cast<T>(0);
+        for (int c = 0; c < n; c++) {
+            sum += std::abs(row[c]);
+        }
+        a_norm = std::max(a_norm, sum);
+    }
+    //Entries beyond the range of Low would turn into infinities when converted
+    bool refine = a_norm <= static_cast<T>(std::numeric_limits<Low>::max());
+
+    if (refine) {
+        LU_Factorization<Low, ArenaAllocator<Low>> low_lu(a.template cast<Low, ArenaAllocator<Low>>());
+        refine = !low_lu.isSingular();
+        if (refine) {
+            const T tolerance = a_norm * std::numeric_limits<T>::epsilon() * std::sqrt(static_cast<T>(n));
+            Matrix<Low, ArenaAllocator<Low>> correction = b.template cast<Low, ArenaAllocator<Low>>();
+            Matrix<T, ArenaAllocator<T>> residual(n, k);
+            T* residual_max = scope.allocate<T>(static_cast<std::size_t>(k));
+            T* x_max = scope.allocate<T>(static_cast<std::size_t>(k));
+            T previous_worst = static_cast<T>(0);
+            for (int step = 0;; step++) {
+                //Step 0 initializes X from the first low precision solve, later steps correct it
+                low_lu.solveInPlace(correction);
+                parallelRows(n, static_cast<long long>(n) * k, [&](int r0, int r1) {
+                    for (int r = r0; r < r1; r++) {
+                        T* x_row = x.rowData(r);
+                        const Low* d_row = correction.rowData(r);
+                        for (int c = 0; c < k; c++) {
+                            x_row[c] = (step == 0) ? static_cast<T>(d_row[c]) : x_row[c] + static_cast<T>(d_row[c]);
+                        }
+                    }
+                });
+                info.iterations = step;
+
+                //R = B - A * X in working precision
+                for (int r = 0; r < n; r++) {
+                    std::copy(b.rowData(r), b.rowData(r) + k, residual.rowData(r));
+                }
+                residual.multiplyAdd(static_cast<T>(-1), a, Op::NoTrans, x, Op::NoTrans, static_cast<T>(1));
+
+                std::fill(residual_max, residual_max + k, static_cast<T>(0));
+                std::fill(x_max, x_max + k, static_cast<T>(0));
+                bool finite = true;
+                for (int r = 0; r < n; r++) {
+                    const T* r_row = residual.rowData(r);
+                    const T* x_row = x.rowData(r);
+                    for (int c = 0; c < k; c++) {
+                        finite = finite && std::isfinite(r_row[c]);
+                        residual_max[c] = std::max(residual_max[c], std::abs(r_row[c]));
+                        x_max[c] = std::max(x_max[c], std::abs(x_row[c]));
+                    }
+                }
+                if (!finite) {
+                    break;
+                }
+                bool converged = true;
+                T worst = static_cast<T>(0);
+                for (int c = 0; c < k; c++) {
+                    converged = converged && residual_max[c] <= x_max[c] * tolerance;
+                    worst = std::max(worst, residual_max[c] / std::max(x_max[c], std::numeric_limits<T>::min()));
+                }
+                if (converged) {
+                    info.converged = true;
+                    return info;
+                }
+                //Each step should shrink the residual by about cond(A) * eps of Low; when it does
+                //not even halve, the low precision factors are too inaccurate to get there
+                if (step == max_iterations || (step > 0 && !(worst < previous_worst / 2))) {
+                    break;
+                }
+                previous_worst = worst;
+                parallelRows(n, static_cast<long long>(n) * k, [&](int r0, int r1) {
+                    for (int r = r0; r < r1; r++) {
+                        const T* r_row = residual.rowData(r);
+                        Low* d_row = correction.rowData(r);
+                        for (int c = 0; c < k; c++) {
+                            d_row[c] = static_cast<Low>(r_row[c]);
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+    //Refinement failed: solve from scratch in working precision
+    info.fallback = true;
+    for (int r = 0; r < n; r++) {
+        std::copy(b.rowData(r), b.rowData(r) + k, x.rowData(r));
+    }
+    LU_Factorization<T, ArenaAllocator<T>> full_lu{Matrix<T, ArenaAllocator<T>>(a)};
+    full_lu.solveInPlace(x);
+    return info;
+}
+
+} // namespace matrixlib
@@ -0,0 +1,318 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "Matrix.hpp"
+#include "Gemm.hpp"
+#include "ScratchArena.hpp"
+#include "ThreadPool.hpp"
+#include "TriangularSolve.hpp"
+
+/**
+ * @class QR_Factorization
+ * @brief Householder QR factorization A = Q * R of an m x n matrix, used for least squares.
+ * R is stored on and above the diagonal; the Householder vectors (unit leading entry omitted)
+ * are stored below it, with their scalar factors in tau(). Q is never formed explicitly.
+ * The factorization is blocked: a panel of columns is factored one reflector at a time, then its
+ * reflectors are applied to the rest of the matrix at once in the compact WY form
+ * I - V * T * V^T, which turns the update into two GEMMs. Q^T is applied to right-hand sides
+ * the same way.
+ * @note Intended for floating point types (float/double).
+ * @note Example: QR_Factorization<double> qr = a.qr(); Matrix<double> x = qr.solve(b);
+ */
+template <typename T, typename Alloc = AlignedAllocator<T>>
+class QR_Factorization
+{
+private:
+    static constexpr int block_size = 32;
+
+    Matrix<T, Alloc> m_qr;
+    std::vector<T, Alloc> m_tau;
+
+    int reflectors() const { return std::min(m_qr.getRows(), m_qr.getCols()); }
+
+    /**
+     * @brief Factors columns [j0, j0 + jb) one reflector at a time, updating only the panel.
+     */
+    void factorPanel(int j0, int jb) {
+        const int m = m_qr.getRows();
+        for (int j = j0; j < j0 + jb; j++) {
+            //Reflector H = I - tau * v * v^T with v[0] = 1 that maps A[j:m, j] onto beta * e1
+            T sigma = 0;
+            for (int i = j + 1; i < m; i++) {
+                sigma += m_qr(i, j) * m_qr(i, j);
+            }
+            const T alpha = m_qr(j, j);
+            if (sigma == static_cast<T>(0)) {
+                m_tau[j] = 0;
+                continue;
+            }
+            const T norm = std::sqrt(alpha * alpha + sigma);
+            const T beta = (alpha >= static_cast<T>(0)) ? -norm : norm;
+            m_tau[j] = (beta - alpha) / beta;
+            const T scale = static_cast<T>(1) / (alpha - beta);
+            for (int i = j + 1; i < m; i++) {
+                m_qr(i, j) *= scale;
+            }
+            m_qr(j, j) = beta;
+
+            //Apply H to the remaining panel columns
+            for (int c = j + 1; c < j0 + jb; c++) {
+                T w = m_qr(j, c);
+                for (int i = j + 1; i < m; i++) {
+                    w += m_qr(i, j) * m_qr(i, c);
+                }
+                w *= m_tau[j];
+                m_qr(j, c) -= w;
+                for (int i = j + 1; i < m; i++) {
+                    m_qr(i, c) -= w * m_qr(i, j);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Expands the reflectors of panel [j0, j0 + jb) into V ((m - j0) x jb, unit lower
+     * trapezoidal) and builds the upper triangular jb x jb T with H_j0 ... H_(j0+jb-1) = I - V T V^T.
+     */
+    void buildWY(int j0, int jb, T* v, T* t) const {
+        const int rows = m_qr.getRows() - j0;
+        for (int i = 0; i < rows; i++) {
+            const T* src = m_qr.rowData(j0 + i) + j0;
+            T* dst = v + static_cast<std::size_t>(i) * jb;
+            for (int c = 0; c < jb; c++) {
+                dst[c] = (c < i) ? src[c] : ((c == i) ? static_cast<T>(1) : static_cast<T>(0));
+            }
+        }
+        std::fill(t, t + static_cast<std::size_t>(jb) * jb, static_cast<T>(0));
+        for (int c = 0; c < jb; c++) {
+            const T tau = m_tau[j0 + c];
+            t[c * jb + c] = tau;
+            if (c == 0 || tau == static_cast<T>(0)) {
+                continue;
+            }
+            //T[0:c, c] = -tau * T[0:c, 0:c] * (V[:, 0:c]^T * v_c)
+            T* z = t + c; //Column c of T, stride jb
+            for (int i = c; i < rows; i++) {
+                const T* vi = v + static_cast<std::size_t>(i) * jb;
+                for (int p = 0; p < c; p++) {
+                    z[p * jb] += vi[p] * vi[c];
+                }
+            }
+            for (int p = 0; p < c; p++) {
+                T sum = 0;
+                for (int q = p; q < c; q++) {
+                    sum += t[p * jb + q] * z[q * jb];
+                }
+                z[p * jb] = sum;
+            }
+            for (int p = 0; p < c; p++) {
+                z[p * jb] *= -tau;
+            }
+        }
+    }
+
+    /**
+     * @brief Applies (I - V T V^T)^T = I - V T^T V^T to rows [j0, m) of a row-major block C.
+     * @param c First element of row j0 of C; cols columns with row stride ldc.
+     */
+    void applyWYTransposed(int j0, int jb, const T* v, const T* t, int cols, T* c, std::ptrdiff_t ldc) const {
+        const int rows = m_qr.getRows() - j0;
+        matrixlib::ScratchScope scope;
+        T* w = scope.allocate<T>(static_cast<std::size_t>(jb) * cols);
+        T* tw = scope.allocate<T>(static_cast<std::size_t>(jb) * cols);
+        //W = V^T * C
+        matrixlib::gemm<T>(jb, cols, rows, static_cast<T>(1), v, 1, jb, c, ldc, 1, static_cast<T>(0), w, cols);
+        //TW = T^T * W (T^T is lower triangular)
+        matrixlib::parallelRows(jb, static_cast<long long>(jb) * jb * cols, [&](int r0, int r1) {
+            for (int r = r0; r < r1; r++) {
+                T* dst = tw + static_cast<std::size_t>(r) * cols;
+                std::fill(dst, dst + cols, static_cast<T>(0));
+                for (int p = 0; p <= r; p++) {
+                    const T coef = t[p * jb + r];
+                    const T* src = w + static_cast<std::size_t>(p) * cols;
+                    for (int col = 0; col < cols; col++) {
+                        dst[col] += coef * src[col];
+                    }
+                }
+            }
+        });
+        //C -= V * TW
+        matrixlib::gemm<T>(rows, cols, jb, static_cast<T>(-1), v, jb, 1, tw, cols, 1, static_cast<T>(1), c, ldc);
+    }
+
+    /**
+     * @brief Runs the blocked factorization over the whole matrix.
+     */
+    void factor() {
+        const int n = m_qr.getCols();
+        const int steps = reflectors();
+        for (int j0 = 0; j0 < steps; j0 += block_size) {
+            const int jb = std::min(block_size, steps - j0);
+            factorPanel(j0, jb);
+            const int rest = n - j0 - jb;
+            if (rest == 0) {
+                continue;
+            }
+            matrixlib::ScratchScope scope;
+            T* v = scope.allocate<T>(static_cast<std::size_t>(m_qr.getRows() - j0) * jb);
+            T* t = scope.allocate<T>(static_cast<std::size_t>(jb) * jb);
+            buildWY(j0, jb, v, t);
+            applyWYTransposed(j0, jb, v, t, rest, m_qr.rowData(j0) + j0 + jb, m_qr.getStride());
+        }
+    }
+
+public:
+    /**
+     * @brief Factors an m x n matrix.
+     * @param a The matrix to factor.
+     * @note Example: QR_Factorization<double> qr(mat);
+     */
+    explicit QR_Factorization(const Matrix<T, Alloc>& a) : m_qr(a), m_tau(std::min(a.getRows(), a.getCols())) {
+        factor();
+    }
+
+    /**
+     * @brief Factors a temporary matrix in its own buffer, without copying it.
+     * @param a The matrix to factor (consumed).
+     * @note Example: QR_Factorization<double> qr(std::move(mat));
+     */
+    explicit QR_Factorization(Matrix<T, Alloc>&& a)
+        : m_qr(std::move(a)), m_tau(std::min(m_qr.getRows(), m_qr.getCols())) {
+        factor();
+    }
+
+    int getRows() const { return m_qr.getRows(); }
+    int getCols() const { return m_qr.getCols(); }
+
+    /**
+     * @brief Returns R and the Householder vectors packed together: R on and above the diagonal,
+     * the vectors (unit leading entry omitted) below it.
+     */
+    const Matrix<T, Alloc>& packed() const { return m_qr; }
+
+    /**
+     * @brief Returns the scalar factors of the Householder reflectors.
+     */
+    const auto& tau() const { return m_tau; }
+
+    /**
+     * @brief Returns the upper triangular (or trapezoidal) factor R, min(m, n) x n.
+     * @note Example: Matrix<double> r = qr.R();
+     */
+    Matrix<T, Alloc> R() const {
+        const int k = reflectors();
+        const int n = getCols();
+        Matrix<T, Alloc> r(k, n);
+        for (int i = 0; i < k; i++) {
+            std::copy(m_qr.rowData(i) + i, m_qr.rowData(i) + n, r.rowData(i) + i);
+        }
+        return r;
+    }
+
+    /**
+     * @brief Checks whether R has a zero on its diagonal (A does not have full column rank).
+     */
+    bool isRankDeficient() const {
+        for (int i = 0; i < reflectors(); i++) {
+            if (m_qr(i, i) == static_cast<T>(0)) {
+                return true;
+            }
+        }
+        return reflectors() < getCols();
+    }
+
+    /**
+     * @brief Overwrites B (m x k) with Q^T * B.
+     * @param b Right-hand sides, one per column; any allocator.
+     * @throws std::invalid_argument if B does not have m rows.
+     * @note Example: qr.applyQTranspose(b);
+     */
+    template <typename BAlloc>
+    void applyQTranspose(Matrix<T, BAlloc>& b) const {
+        if (b.getRows() != getRows()) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        const int k = b.getCols();
+        if (k == 0) {
+            return;
+        }
+        const int steps = reflectors();
+        for (int j0 = 0; j0 < steps; j0 += block_size) {
+            const int jb = std::min(block_size, steps - j0);
+            matrixlib::ScratchScope scope;
+            T* v = scope.allocate<T>(static_cast<std::size_t>(getRows() - j0) * jb);
+            T* t = scope.allocate<T>(static_cast<std::size_t>(jb) * jb);
+            buildWY(j0, jb, v, t);
+            applyWYTransposed(j0, jb, v, t, k, b.rowData(j0), b.getStride());
+        }
+    }
+
+    /**
+     * @brief Solves the least squares problem min ||A * X - B|| into a preallocated X.
+     * Workspace comes from the scratch arena; only X is written.
+     * @param b Right-hand sides, one per column (m x k).
+     * @param x Receives the solution; must be n x k.
+     * @throws std::invalid_argument if the shapes do not match, m < n, or A is rank deficient.
+     * @note Example: qr.solve(b, x);
+     */
+    template <typename BAlloc, typename XAlloc>
+    void solve(const Matrix<T, BAlloc>& b, Matrix<T, XAlloc>& x) const {
+        const int n = getCols();
+        const int k = b.getCols();
+        if (b.getRows() != getRows()) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        if (x.getRows() != n || x.getCols() != k) {
+            throw std::invalid_argument("Solution must have as many rows as the matrix has columns.\n");
+        }
+        if (getRows() < n) {
+            throw std::invalid_argument("Least squares requires at least as many rows as columns.\n");
+        }
+        if (isRankDeficient()) {
+            throw std::invalid_argument("Cannot solve: matrix is rank deficient.\n");
+        }
+        matrixlib::ScratchScope scope;
+        Matrix<T, matrixlib::ArenaAllocator<T>> qtb(b);
+        applyQTranspose(qtb);
+        for (int i = 0; i < n; i++) {
+            std::copy(qtb.rowData(i), qtb.rowData(i) + k, x.rowData(i));
+        }
+        //R * X = (Q^T * B)[0:n]
+        matrixlib::trsm<T>(matrixlib::Triangle::Upper, false, n, k, m_qr.rowData(0), m_qr.getStride(), 1,
+                           x.rowData(0), x.getStride());
+    }
+
+    /**
+     * @brief Solves the least squares problem min ||A * X - B|| for every column of B at once.
+     * For a square full-rank A this is the exact solution of A * X = B.
+     * @param b Right-hand sides, one per column (m x k).
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if B has the wrong number of rows, m < n, or A is rank deficient.
+     * @note Example: Matrix<double> x = qr.solve(b);
+     */
+    template <typename BAlloc>
+    Matrix<T, BAlloc> solve(const Matrix<T, BAlloc>& b) const {
+        Matrix<T, BAlloc> x(getCols(), b.getCols());
+        solve(b, x);
+        return x;
+    }
+
+    /**
+     * @brief Solves the least squares problem for a single right-hand side vector.
+     * @param b Right-hand side of length m.
+     * @return The solution vector x of length n.
+     * @throws std::invalid_argument if b has the wrong length, m < n, or A is rank deficient.
+     * @note Example: std::vector<double> x = qr.solve(observations);
+     */
+    std::vector<T> solve(const std::vector<T>& b) const {
+        if (static_cast<int>(b.size()) != getRows()) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        Matrix<T> rhs(getRows(), 1);
+        rhs.setColVal(0, b);
+        return solve(rhs).getCol(0);
+    }
+};
@@ -0,0 +1,211 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include "ScratchArena.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @file Reduction.hpp
+ * @brief Blocked, parallel reductions over row-major matrices (sum, min/max, dot, row and
+ * column sums).
+ *
+ * Each row is cut into segments of at most reduce_block elements and consecutive segments are
+ * grouped into blocks; blocks run on the shared pool and their partial results are combined in
+ * block order. Inside a segment the kernels keep reduce_lanes independent accumulators, which
+ * breaks the serial dependency of a floating point sum so the compiler can keep them in SIMD
+ * registers and the loop runs at memory bandwidth rather than at the latency of one add.
+ */
+namespace matrixlib {
+
+/**
+ * @brief How a floating point reduction may be ordered.
+ * Deterministic splits the matrix into blocks by its shape alone and combines them in a fixed
+ * order, so the result is bit for bit the same for any number of threads. Fast lets the split
+ * follow the pool size (one pass on a single thread, a few large blocks per worker otherwise),
+ * so the last bits may change with MATRIXLIB_NUM_THREADS.
+ */
+enum class Reduction {
+    Fast,
+    Deterministic
+};
+
+namespace detail {
+
+inline constexpr int reduce_lanes = 8;
+inline constexpr int reduce_block = 1 << 14;
+inline constexpr long long reduce_parallel_min = 1 << 16;
+inline constexpr int reduce_max_row_blocks = 64;
+
+/**
+ * @brief Folds indices 0..n-1 into reduce_lanes accumulators with acc = step(acc, i), index i
+ * going to lane i % reduce_lanes, then combines the lanes pairwise in a fixed order.
+ */
+template <typename T, typename Step, typename Combine>
+T foldLanes(int n, T init, const Step& step, const Combine& combine) {
+    T acc[reduce_lanes];
+    for (int j = 0; j < reduce_lanes; j++) {
+        acc[j] = init;
+    }
+    int c = 0;
+    for (; c + reduce_lanes <= n; c += reduce_lanes) {
+        for (int j = 0; j < reduce_lanes; j++) {
+            acc[j] = step(acc[j], c + j);
+        }
+    }
+    for (int j = 0; c < n; c++, j++) {
+        acc[j] = step(acc[j], c);
+    }
+    for (int width = reduce_lanes / 2; width > 0; width /= 2) {
+        for (int j = 0; j < width; j++) {
+            acc[j] = combine(acc[j], acc[j + width]);
+        }
+    }
+    return acc[0];
+}
+
+template <typename T>
+T sumSpan(const T* x, int n) {
+    const auto add = [](T a, T b) { return a + b; };
+    return foldLanes<T>(n, T{}, [x](T acc, int i) { return acc + x[i]; }, add);
+}
+
+template <typename T>
+T sumSquaresSpan(const T* x, int n, T scale) {
+    const auto add = [](T a, T b) { return a + b; };
+    return foldLanes<T>(n, T{}, [x, scale](T acc, int i) { const T v = x[i] * scale; return acc + v * v; }, add);
+}
+
+template <typename T>
+T dotSpan(const T* x, const T* y, int n) {
+    const auto add = [](T a, T b) { return a + b; };
+    return foldLanes<T>(n, T{}, [x, y](T acc, int i) { return acc + x[i] * y[i]; }, add);
+}
+
+template <typename T>
+T minSpan(const T* x, int n) {
+    const auto pick = [](T a, T b) { return b < a ? b : a; };
+    return foldLanes<T>(n, x[0], [x, pick](T acc, int i) { return pick(acc, x[i]); }, pick);
+}
+
+template <typename T>
+T maxSpan(const T* x, int n) {
+    const auto pick = [](T a, T b) { return a < b ? b : a; };
+    return foldLanes<T>(n, x[0], [x, pick](T acc, int i) { return pick(acc, x[i]); }, pick);
+}
+
+template <typename T>
+T maxAbsSpan(const T* x, int n) {
+    const auto pick = [](T a, T b) { return a < b ? b : a; };
+    return foldLanes<T>(n, T{}, [x, pick](T acc, int i) { return pick(acc, x[i] < T{} ? -x[i] : x[i]); }, pick);
+}
+
+/**
+ * @brief Reduces a rows x cols index space: span(row, c0, c1) reduces one segment of a row and
+ * combine merges two partial results. rows and cols must be positive.
+ */
+template <typename T, typename Span, typename Combine>
+T reduceSegments(int rows, int cols, Reduction mode, const Span& span, const Combine& combine) {
+    const int width = std::min(cols, reduce_block);
+    const int chunks = (cols + width - 1) / width;
+    const long long units = static_cast<long long>(rows) * chunks;
+    ThreadPool& pool = ThreadPool::instance();
+    const bool parallel = static_cast<long long>(rows) * cols >= reduce_parallel_min && pool.size() > 1;
+
+    long long per_block;
+    if (mode == Reduction::Deterministic) {
+        per_block = std::max(1, reduce_block / width);
+    } else if (parallel) {
+        const long long target = 4LL * pool.size();
+        per_block = (units + target - 1) / target;
+    } else {
+        per_block = units;
+    }
+    const long long blocks = (units + per_block - 1) / per_block;
+
+    const auto runBlock = [&](long long b) {
+        const long long u0 = b * per_block;
+        const long long u1 = std::min(units, u0 + per_block);
+        T acc{};
+        for (long long u = u0; u < u1; u++) {
+            const int r = static_cast<int>(u / chunks);
+            const int c0 = static_cast<int>(u % chunks) * width;
+            const T value = span(r, c0, std::min(cols, c0 + width));
+            acc = (u == u0) ? value : combine(acc, value);
+        }
+        return acc;
+    };
+    if (blocks == 1) {
+        return runBlock(0);
+    }
+    ScratchScope scope;
+    T* partial = scope.allocate<T>(static_cast<std::size_t>(blocks));
+    if (parallel) {
+        pool.parallelFor(static_cast<int>(blocks), [&](int b) { partial[b] = runBlock(b); });
+    } else {
+        for (long long b = 0; b < blocks; b++) {
+            partial[b] = runBlock(b);
+        }
+    }
+    T result = partial[0];
+    for (long long b = 1; b < blocks; b++) {
+        result = combine(result, partial[b]);
+    }
+    return result;
+}
+
+/**
+ * @brief Writes the sum of every column of a rows x cols matrix to sums.
+ * Rows are split into blocks whose partial sums are added in block order; each block walks its
+ * rows top to bottom, so the inner loop runs across contiguous columns and vectorizes.
+ */
+template <typename T>
+void columnSums(int rows, int cols, const T* a, std::ptrdiff_t lda, Reduction mode, T* sums) {
+    std::fill(sums, sums + cols, T{});
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+    ThreadPool& pool = ThreadPool::instance();
+    const bool parallel = static_cast<long long>(rows) * cols >= reduce_parallel_min && pool.size() > 1;
+    int per_block;
+    if (mode == Reduction::Deterministic) {
+        per_block = std::max(std::max(1, reduce_block / cols), (rows + reduce_max_row_blocks - 1) / reduce_max_row_blocks);
+    } else if (parallel) {
+        const int target = 4 * pool.size();
+        per_block = (rows + target - 1) / target;
+    } else {
+        per_block = rows;
+    }
+    const int blocks = (rows + per_block - 1) / per_block;
+
+    ScratchScope scope;
+    T* partial = scope.allocate<T>(static_cast<std::size_t>(blocks) * cols);
+    const auto runBlock = [&](int b) {
+        T* acc = partial + static_cast<std::size_t>(b) * cols;
+        const int r0 = b * per_block;
+        const int r1 = std::min(rows, r0 + per_block);
+        std::copy(a + r0 * lda, a + r0 * lda + cols, acc);
+        for (int r = r0 + 1; r < r1; r++) {
+            const T* row = a + r * lda;
+            for (int c = 0; c < cols; c++) {
+                acc[c] += row[c];
+            }
+        }
+    };
+    if (parallel && blocks > 1) {
+        pool.parallelFor(blocks, runBlock);
+    } else {
+        for (int b = 0; b < blocks; b++) {
+            runBlock(b);
+        }
+    }
+    for (int b = 0; b < blocks; b++) {
+        const T* acc = partial + static_cast<std::size_t>(b) * cols;
+        for (int c = 0; c < cols; c++) {
+            sums[c] += acc[c];
+        }
+    }
+}
+
+} // namespace detail
+
+} // namespace matrixlib
@@ -0,0 +1,208 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include "Instrumentation.hpp"
+
+/**
+ * @file ScratchArena.hpp
+ * @brief Thread-local bump allocator for short-lived workspace.
+ *
+ * Every thread owns one ScratchArena: a list of 64-byte aligned blocks that is only ever grown.
+ * A ScratchScope records the current position on entry and rewinds to it on exit, releasing
+ * everything allocated inside the scope at once. Blocks are kept for the lifetime of the thread,
+ * so once the arena has grown to the working set of a computation, repeating that computation
+ * performs no heap allocation and takes no allocator lock. Library kernels (GEMM packing, LU and
+ * cofactor temporaries) draw their workspace from the arena of the thread they run on.
+ */
+namespace matrixlib {
+
+class ScratchArena
+{
+private:
+    static constexpr std::size_t block_alignment = 64;
+    static constexpr std::size_t min_block_size = std::size_t(1) << 20;
+
+    struct Block {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+    std::size_t m_block = 0;  //Index of the block being filled
+    std::size_t m_offset = 0; //Bytes used in that block
+    int m_depth = 0;          //Number of open ScratchScopes
+
+    ScratchArena() = default;
+
+    std::byte* newBlock(std::size_t size, std::size_t position) {
+        MATRIXLIB_RECORD_ALLOCATION(size);
+        std::byte* data = static_cast<std::byte*>(::operator new(size, std::align_val_t{block_alignment}));
+        m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(position), Block{data, size});
+        return data;
+    }
+
+public:
+    /**
+     * @brief Position of the arena, used to release everything allocated after it.
+     */
+    struct Marker {
+        std::size_t block;
+        std::size_t offset;
+    };
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    ~ScratchArena() {
+        for (const Block& block : m_blocks) {
+            ::operator delete(block.data, block.size, std::align_val_t{block_alignment});
+        }
+    }
+
+    /**
+     * @brief Returns the arena of the calling thread.
+     */
+    static ScratchArena& local() {
+        thread_local ScratchArena arena;
+        return arena;
+    }
+
+    /**
+     * @brief Allocates bytes with the given alignment (at most 64) from the current block,
+     * moving on to the next block, or adding one, when it does not fit.
+     * @throws std::logic_error if no ScratchScope is open on this thread.
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = block_alignment) {
+        if (m_depth == 0) {
+            throw std::logic_error("Scratch memory requested outside of a ScratchScope.\n");
+        }
+        alignment = std::max<std::size_t>(1, std::min(alignment, block_alignment));
+        bytes = std::max<std::size_t>(1, bytes);
+        while (m_block < m_blocks.size()) {
+            const std::size_t start = (m_offset + alignment - 1) / alignment * alignment;
+            if (start + bytes <= m_blocks[m_block].size) {
+                m_offset = start + bytes;
+                return m_blocks[m_block].data + start;
+            }
+            if (m_block + 1 < m_blocks.size() && m_blocks[m_block + 1].size >= bytes) {
+                m_block++;
+                m_offset = 0;
+                continue;
+            }
+            break;
+        }
+        //Grow geometrically; the new block goes right after the current one so rewinding stays LIFO
+        const std::size_t last = m_blocks.empty() ? 0 : m_blocks.back().size;
+        const std::size_t size = std::max({min_block_size, 2 * last, (bytes + block_alignment - 1) / block_alignment * block_alignment});
+        const std::size_t position = m_blocks.empty() ? 0 : m_block + 1;
+        std::byte* data = newBlock(size, position);
+        m_block = position;
+        m_offset = bytes;
+        return data;
+    }
+
+    /**
+     * @brief Allocates uninitialized storage for count objects of type T, aligned to a cache line.
+     * @throws std::logic_error if no ScratchScope is open on this thread.
+     */
+    template <typename T>
+    T* allocate(std::size_t count) {
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        static_assert(alignof(T) <= block_alignment, "Scratch memory is aligned to at most 64 bytes.");
+        return static_cast<T*>(allocate(count * sizeof(T), block_alignment));
+    }
+
+    Marker mark() const { return Marker{m_block, m_offset}; }
+
+    /**
+     * @brief Releases everything allocated since marker was taken.
+     */
+    void rewind(Marker marker) {
+        m_block = marker.block;
+        m_offset = marker.offset;
+    }
+
+    /**
+     * @brief Total bytes held by the arena (its high-water mark).
+     */
+    std::size_t capacity() const {
+        std::size_t total = 0;
+        for (const Block& block : m_blocks) total += block.size;
+        return total;
+    }
+
+    friend class ScratchScope;
+};
+
+/**
+ * @class ScratchScope
+ * @brief RAII region of the calling thread's ScratchArena.
+ * Everything allocated from the arena (directly or through ArenaAllocator) while the scope is
+ * open is released when it closes. Scopes nest and must close in reverse order of opening,
+ * which automatic (stack) objects guarantee.
+ * @note Example: { matrixlib::ScratchScope scope; double* tmp = scope.allocate<double>(n); }
+ */
+class ScratchScope
+{
+private:
+    ScratchArena& m_arena;
+    ScratchArena::Marker m_marker;
+
+public:
+    ScratchScope() : m_arena(ScratchArena::local()), m_marker(m_arena.mark()) {
+        m_arena.m_depth++;
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    ~ScratchScope() {
+        m_arena.rewind(m_marker);
+        m_arena.m_depth--;
+    }
+
+    /**
+     * @brief Allocates uninitialized storage for count objects of type T inside this scope.
+     */
+    template <typename T>
+    T* allocate(std::size_t count) { return m_arena.allocate<T>(count); }
+};
+
+/**
+ * @class ArenaAllocator
+ * @brief Standard allocator drawing from the calling thread's ScratchArena.
+ * deallocate() is a no-op: memory comes back when the enclosing ScratchScope closes, so
+ * containers using this allocator must not outlive that scope. Intended for temporaries,
+ * e.g. Matrix<double, ArenaAllocator<double>> workspace inside a hot loop.
+ * @throws std::logic_error from allocate() if no ScratchScope is open on the calling thread.
+ * @note Example: matrixlib::ScratchScope scope; Matrix<double, matrixlib::ArenaAllocator<double>> tmp(n, n);
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = ArenaAllocator<U>; };
+
+    ArenaAllocator() noexcept = default;
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) { return ScratchArena::local().allocate<T>(n); }
+
+    void deallocate(T*, std::size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const noexcept { return true; }
+};
+
+} // namespace matrixlib
@@ -0,0 +1,539 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <stdexcept>
+#include "Matrix.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Compressed storage orientation of a SparseMatrix.
+ */
+enum class SparseFormat {
+    CSR, //Compressed sparse rows: offsets per row, column indices
+    CSC  //Compressed sparse columns: offsets per column, row indices
+};
+
+/**
+ * @struct SparseTriplet
+ * @brief One COO entry: value stored at (row, col). Shared by both sparse formats.
+ */
+template <typename T>
+struct SparseTriplet {
+    int row;
+    int col;
+    T value;
+};
+
+namespace matrixlib::detail {
+
+/**
+ * @brief Compressed arrays shared by both formats. "Major" is the compressed dimension
+ * (rows for CSR, columns for CSC), "minor" the one stored in the index array.
+ */
+template <typename T>
+struct CompressedStorage {
+    std::vector<int> offsets; //major + 1 entries
+    std::vector<int> indices; //minor index of every stored value
+    std::vector<T> values;
+};
+
+/**
+ * @brief Transposes compressed storage (CSR <-> CSC of the same matrix) with a counting sort.
+ * Minor indices of the result come out sorted.
+ */
+template <typename T>
+CompressedStorage<T> transposeStorage(const CompressedStorage<T>& src, int major, int minor) {
+    CompressedStorage<T> dst;
+    dst.offsets.assign(minor + 1, 0);
+    dst.indices.resize(src.indices.size());
+    dst.values.resize(src.values.size());
+    for (int idx : src.indices) {
+        dst.offsets[idx + 1]++;
+    }
+    std::partial_sum(dst.offsets.begin(), dst.offsets.end(), dst.offsets.begin());
+    std::vector<int> next(dst.offsets.begin(), dst.offsets.end() - 1);
+    for (int i = 0; i < major; i++) {
+        for (int p = src.offsets[i]; p < src.offsets[i + 1]; p++) {
+            const int slot = next[src.indices[p]]++;
+            dst.indices[slot] = i;
+            dst.values[slot] = src.values[p];
+        }
+    }
+    return dst;
+}
+
+/**
+ * @brief Gustavson sparse product on compressed storage: C = A * B, where A is
+ * m x k and B is k x n, both compressed along their rows. Rows of C are computed in parallel
+ * in chunks of rows; a symbolic pass sizes each row before the numeric pass.
+ * Each worker allocates its dense marker and accumulator (n entries) once and claims chunks until
+ * none are left, so the workspace costs O(workers * n) rather than O(m * n / chunk) and the
+ * rest of the work follows the number of multiplications.
+ */
+template <typename T>
+CompressedStorage<T> gustavson(const CompressedStorage<T>& a, const CompressedStorage<T>& b, int m, int n) {
+    CompressedStorage<T> c;
+    c.offsets.assign(m + 1, 0);
+    ThreadPool& pool = ThreadPool::instance();
+    constexpr int rows_per_task = 256;
+    const int tasks = (m + rows_per_task - 1) / rows_per_task;
+    const int workers = std::max(1, std::min(tasks, pool.size()));
+    std::atomic<int> next_task{0};
+
+    pool.parallelFor(workers, [&](int) {
+        std::vector<int> marker(n, -1);
+        for (int t = next_task++; t < tasks; t = next_task++) {
+            for (int i = t * rows_per_task; i < std::min(m, (t + 1) * rows_per_task); i++) {
+                int count = 0;
+                for (int p = a.offsets[i]; p < a.offsets[i + 1]; p++) {
+                    const int k = a.indices[p];
+                    for (int q = b.offsets[k]; q < b.offsets[k + 1]; q++) {
+                        if (marker[b.indices[q]] != i) {
+                            marker[b.indices[q]] = i;
+                            count++;
+                        }
+                    }
+                }
+                c.offsets[i + 1] = count;
+            }
+        }
+    });
+    std::partial_sum(c.offsets.begin(), c.offsets.end(), c.offsets.begin());
+    c.indices.resize(c.offsets[m]);
+    c.values.resize(c.offsets[m]);
+
+    next_task = 0;
+    pool.parallelFor(workers, [&](int) {
+        std::vector<int> marker(n, -1);
+        std::vector<T> accumulator(n);
+        for (int t = next_task++; t < tasks; t = next_task++) {
+            for (int i = t * rows_per_task; i < std::min(m, (t + 1) * rows_per_task); i++) {
+                int* row_indices = c.indices.data() + c.offsets[i];
+                int count = 0;
+                for (int p = a.offsets[i]; p < a.offsets[i + 1]; p++) {
+                    const int k = a.indices[p];
+                    const T a_ik = a.values[p];
+                    for (int q = b.offsets[k]; q < b.offsets[k + 1]; q++) {
+                        const int j = b.indices[q];
+                        if (marker[j] != i) {
+                            marker[j] = i;
+                            accumulator[j] = a_ik * b.values[q];
+                            row_indices[count++] = j;
+                        } else {
+                            accumulator[j] += a_ik * b.values[q];
+                        }
+                    }
+                }
+                std::sort(row_indices, row_indices + count);
+                for (int p = 0; p < count; p++) {
+                    c.values[c.offsets[i] + p] = accumulator[row_indices[p]];
+                }
+            }
+        }
+    });
+    return c;
+}
+
+} // namespace matrixlib::detail
+
+/**
+ * @class SparseMatrix
+ * @brief A sparse matrix in compressed row (CSR) or compressed column (CSC) format.
+ * Memory and multiply time scale with the number of stored nonzeros, not with rows x columns.
+ * Built from COO triplets (duplicates are summed) or from a dense Matrix, and converted back
+ * with toDense(). Supports sparse x vector, sparse x dense, dense x sparse and sparse x sparse
+ * (Gustavson) products, all parallelized over the shared thread pool.
+ * @note Example: auto s = SparseMatrix<double>::fromTriplets(3, 3, {{0, 0, 1.0}, {2, 1, 4.0}});
+ */
+template <typename T, SparseFormat Format = SparseFormat::CSR>
+class SparseMatrix
+{
+    template <typename U, SparseFormat F> friend class SparseMatrix;
+
+private:
+    int m_row{};
+    int m_col{};
+    matrixlib::detail::CompressedStorage<T> m_storage;
+
+    int majorSize() const { return Format == SparseFormat::CSR ? m_row : m_col; }
+    int minorSize() const { return Format == SparseFormat::CSR ? m_col : m_row; }
+
+    /**
+     * @brief Storage of the same matrix compressed along its rows: m_storage itself for CSR, a
+     * transposed copy built in scratch for CSC.
+     */
+    const matrixlib::detail::CompressedStorage<T>& rowStorage(matrixlib::detail::CompressedStorage<T>& scratch) const {
+        if constexpr (Format == SparseFormat::CSR) {
+            return m_storage;
+        } else {
+            scratch = matrixlib::detail::transposeStorage(m_storage, m_col, m_row);
+            return scratch;
+        }
+    }
+
+    static SparseMatrix fromRowStorage(int rows, int cols, matrixlib::detail::CompressedStorage<T>&& storage) {
+        SparseMatrix result(rows, cols);
+        if constexpr (Format == SparseFormat::CSR) {
+            result.m_storage = std::move(storage);
+        } else {
+            result.m_storage = matrixlib::detail::transposeStorage(storage, rows, cols);
+        }
+        return result;
+    }
+
+public:
+    using value_type = T;
+
+    using Triplet = SparseTriplet<T>;
+
+    /**
+     * @brief Constructs an empty (all-zero) sparse matrix.
+     * @throws std::invalid_argument if dimensions are negative.
+     * @note Example: SparseMatrix<double> s(1000, 1000);
+     */
+    SparseMatrix(int rows, int cols) : m_row(rows), m_col(cols) {
+        if (rows < 0 || cols < 0) {
+            throw std::invalid_argument("Number of rows and columns shall be greater than 0.\n");
+        }
+        m_storage.offsets.assign(majorSize() + 1, 0);
+    }
+
+    /**
+     * @brief Compresses a dense matrix, keeping only its nonzero elements.
+     * @note Example: SparseMatrix<double, SparseFormat::CSC> s(dense);
+     */
+    explicit SparseMatrix(const Matrix<T>& dense) : SparseMatrix(dense.getRows(), dense.getCols()) {
+        for (int i = 0; i < majorSize(); i++) {
+            for (int j = 0; j < minorSize(); j++) {
+                const T value = (Format == SparseFormat::CSR) ? dense(i, j) : dense(j, i);
+                if (value != static_cast<T>(0)) {
+                    m_storage.indices.push_back(j);
+                    m_storage.values.push_back(value);
+                }
+            }
+            m_storage.offsets[i + 1] = static_cast<int>(m_storage.values.size());
+        }
+    }
+
+    /**
+     * @brief Builds a sparse matrix from COO triplets; duplicate positions are summed.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param triplets Entries in any order.
+     * @throws std::invalid_argument if an entry lies outside the matrix.
+     * @note Example: auto s = SparseMatrix<double>::fromTriplets(2, 2, {{0, 1, 3.0}, {1, 0, 4.0}});
+     */
+    static SparseMatrix fromTriplets(int rows, int cols, const std::vector<Triplet>& triplets) {
+        SparseMatrix result(rows, cols);
+        auto& st = result.m_storage;
+        const bool csr = (Format == SparseFormat::CSR);
+        for (const Triplet& t : triplets) {
+            if (t.row < 0 || t.row >= rows || t.col < 0 || t.col >= cols) {
+                throw std::invalid_argument("Index out of bounds.\n");
+            }
+            st.offsets[(csr ? t.row : t.col) + 1]++;
+        }
+        std::partial_sum(st.offsets.begin(), st.offsets.end(), st.offsets.begin());
+        std::vector<int> next(st.offsets.begin(), st.offsets.end() - 1);
+        st.indices.resize(triplets.size());
+        st.values.resize(triplets.size());
+        for (const Triplet& t : triplets) {
+            const int slot = next[csr ? t.row : t.col]++;
+            st.indices[slot] = csr ? t.col : t.row;
+            st.values[slot] = t.value;
+        }
+
+        //Sort each major slice by minor index and merge duplicates in input order
+        std::vector<std::pair<int, T>> slice;
+        int out = 0;
+        for (int i = 0; i < result.majorSize(); i++) {
+            const int begin = st.offsets[i];
+            const int end = st.offsets[i + 1];
+            slice.clear();
+            for (int p = begin; p < end; p++) {
+                slice.emplace_back(st.indices[p], st.values[p]);
+            }
+            std::stable_sort(slice.begin(), slice.end(), [](const auto& x, const auto& y) { return x.first < y.first; });
+            st.offsets[i] = out;
+            for (std::size_t p = 0; p < slice.size(); p++) {
+                if (p > 0 && slice[p].first == slice[p - 1].first) {
+                    st.values[out - 1] += slice[p].second;
+                } else {
+                    st.indices[out] = slice[p].first;
+                    st.values[out] = slice[p].second;
+                    out++;
+                }
+            }
+        }
+        st.offsets[result.majorSize()] = out;
+        st.indices.resize(out);
+        st.values.resize(out);
+        return result;
+    }
+
+    int getRows() const { return m_row; }
+    int getCols() const { return m_col; }
+
+    /**
+     * @brief Returns the number of stored (structurally nonzero) elements.
+     */
+    int nonZeros() const { return static_cast<int>(m_storage.values.size()); }
+
+    /**
+     * @brief Compressed offsets (rows for CSR, columns for CSC), one more than the compressed dimension.
+     */
+    const std::vector<int>& offsets() const { return m_storage.offsets; }
+
+    /**
+     * @brief Minor index (column for CSR, row for CSC) of every stored value.
+     */
+    const std::vector<int>& indices() const { return m_storage.indices; }
+
+    /**
+     * @brief Stored values, in the same order as indices().
+     */
+    const std::vector<T>& values() const { return m_storage.values; }
+
+    /**
+     * @brief Retrieves a single element (zero if it is not stored).
+     * @throws std::invalid_argument if indices are out of bounds.
+     * @note Example: double v = s.getValue(3, 4);
+     */
+    T getValue(int row, int col) const {
+        if (row < 0 || row >= m_row || col < 0 || col >= m_col) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        const int major = (Format == SparseFormat::CSR) ? row : col;
+        const int minor = (Format == SparseFormat::CSR) ? col : row;
+        auto first = m_storage.indices.begin() + m_storage.offsets[major];
+        auto last = m_storage.indices.begin() + m_storage.offsets[major + 1];
+        auto it = std::lower_bound(first, last, minor);
+        if (it == last || *it != minor) {
+            return static_cast<T>(0);
+        }
+        return m_storage.values[it - m_storage.indices.begin()];
+    }
+
+    /**
+     * @brief Expands to a dense Matrix.
+     * @note Example: Matrix<double> d = s.toDense();
+     */
+    Matrix<T> toDense() const {
+        Matrix<T> dense(m_row, m_col);
+        for (int i = 0; i < majorSize(); i++) {
+            for (int p = m_storage.offsets[i]; p < m_storage.offsets[i + 1]; p++) {
+                if constexpr (Format == SparseFormat::CSR) {
+                    dense(i, m_storage.indices[p]) = m_storage.values[p];
+                } else {
+                    dense(m_storage.indices[p], i) = m_storage.values[p];
+                }
+            }
+        }
+        return dense;
+    }
+
+    /**
+     * @brief Converts to compressed row format.
+     */
+    SparseMatrix<T, SparseFormat::CSR> toCSR() const {
+        if constexpr (Format == SparseFormat::CSR) {
+            return *this;
+        } else {
+            return SparseMatrix<T, SparseFormat::CSR>::fromRowStorage(m_row, m_col,
+                matrixlib::detail::transposeStorage(m_storage, m_col, m_row));
+        }
+    }
+
+    /**
+     * @brief Converts to compressed column format.
+     */
+    SparseMatrix<T, SparseFormat::CSC> toCSC() const {
+        if constexpr (Format == SparseFormat::CSC) {
+            return *this;
+        } else {
+            SparseMatrix<T, SparseFormat::CSC> result(m_row, m_col);
+            result.m_storage = matrixlib::detail::transposeStorage(m_storage, m_row, m_col);
+            return result;
+        }
+    }
+
+    /**
+     * @brief Returns the transpose: the compressed arrays are copied and reinterpreted in the
+     * other format, so no index is moved.
+     * @note Example: SparseMatrix<double, SparseFormat::CSC> t = s.transposed();
+     */
+    auto transposed() const& {
+        constexpr SparseFormat other = (Format == SparseFormat::CSR) ? SparseFormat::CSC : SparseFormat::CSR;
+        SparseMatrix<T, other> result(m_col, m_row);
+        result.m_storage = m_storage;
+        return result;
+    }
+
+    /**
+     * @brief Transpose of a temporary: its compressed arrays are moved into the result.
+     * @note Example: auto t = std::move(s).transposed();
+     */
+    auto transposed() && {
+        constexpr SparseFormat other = (Format == SparseFormat::CSR) ? SparseFormat::CSC : SparseFormat::CSR;
+        SparseMatrix<T, other> result(m_col, m_row);
+        result.m_storage = std::move(m_storage);
+        return result;
+    }
+
+    /**
+     * @brief Sparse matrix times dense vector (SpMV).
+     * CSR runs rows in parallel; CSC scatters every column into y in one serial pass, so both
+     * cost O(nnz) time and need no memory beyond y.
+     * @throws std::invalid_argument if x.size() != number of columns.
+     * @note Example: std::vector<double> y = s.multiply(x);
+     */
+    std::vector<T> multiply(const std::vector<T>& x) const {
+        if (static_cast<int>(x.size()) != m_col) {
+            throw std::invalid_argument("Vector length must be equal to the number of columns.\n");
+        }
+        std::vector<T> y(m_row);
+        const auto& st = m_storage;
+        if constexpr (Format == SparseFormat::CSR) {
+            matrixlib::parallelRows(m_row, nonZeros(), [&](int row_begin, int row_end) {
+                for (int i = row_begin; i < row_end; i++) {
+                    T sum{};
+                    for (int p = st.offsets[i]; p < st.offsets[i + 1]; p++) {
+                        sum += st.values[p] * x[st.indices[p]];
+                    }
+                    y[i] = sum;
+                }
+            });
+        } else {
+            //Columns write to arbitrary rows; per-thread copies of y would cost O(threads * rows)
+            for (int j = 0; j < m_col; j++) {
+                const T xj = x[j];
+                for (int p = st.offsets[j]; p < st.offsets[j + 1]; p++) {
+                    y[st.indices[p]] += st.values[p] * xj;
+                }
+            }
+        }
+        return y;
+    }
+
+    /**
+     * @brief Sparse matrix times dense matrix. Each output row is a sparse combination of rows of b.
+     * @throws std::invalid_argument if column count of A != row count of B.
+     * @note Example: Matrix<double> c = s.multiply(dense);
+     */
+    Matrix<T> multiply(const Matrix<T>& b) const {
+        if (m_col != b.getRows()) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        matrixlib::detail::CompressedStorage<T> scratch;
+        const auto& st = rowStorage(scratch);
+        const int n = b.getCols();
+        Matrix<T> c(m_row, n);
+        matrixlib::parallelRows(m_row, static_cast<long long>(nonZeros()) * n, [&](int row_begin, int row_end) {
+            for (int i = row_begin; i < row_end; i++) {
+                T* ci = c.rowData(i);
+                for (int p = st.offsets[i]; p < st.offsets[i + 1]; p++) {
+                    const T a = st.values[p];
+                    const T* bk = b.rowData(st.indices[p]);
+                    for (int j = 0; j < n; j++) {
+                        ci[j] += a * bk[j];
+                    }
+                }
+            }
+        });
+        return c;
+    }
+
+    /**
+     * @brief Sparse times sparse product (Gustavson's row-by-row algorithm).
+     * The result has the format of the left operand.
+     * @throws std::invalid_argument if column count of A != row count of B.
+     * @note Example: SparseMatrix<double> c = a.multiply(b);
+     */
+    template <SparseFormat OtherFormat>
+    SparseMatrix multiply(const SparseMatrix<T, OtherFormat>& b) const {
+        if (m_col != b.m_row) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        if constexpr (Format == SparseFormat::CSC && OtherFormat == SparseFormat::CSC) {
+            //(A * B)^T = B^T * A^T, and CSC arrays are the CSR arrays of the transpose
+            SparseMatrix result(m_row, b.m_col);
+            result.m_storage = matrixlib::detail::gustavson(b.m_storage, m_storage, b.m_col, m_row);
+            return result;
+        } else {
+            matrixlib::detail::CompressedStorage<T> scratch_a;
+            matrixlib::detail::CompressedStorage<T> scratch_b;
+            auto product = matrixlib::detail::gustavson(rowStorage(scratch_a), b.rowStorage(scratch_b), m_row, b.m_col);
+            return fromRowStorage(m_row, b.m_col, std::move(product));
+        }
+    }
+};
+
+/**
+ * @brief Sparse matrix times dense vector.
+ * @note Example: std::vector<double> y = s * x;
+ */
+template <typename T, SparseFormat F>
+std::vector<T> operator*(const SparseMatrix<T, F>& lhs, const std::vector<T>& rhs) {
+    return lhs.multiply(rhs);
+}
+
+/**
+ * @brief Sparse matrix times dense matrix.
+ * @note Example: Matrix<double> c = s * dense;
+ */
+template <typename T, SparseFormat F>
+Matrix<T> operator*(const SparseMatrix<T, F>& lhs, const Matrix<T>& rhs) {
+    return lhs.multiply(rhs);
+}
+
+/**
+ * @brief Dense matrix times sparse matrix; rows of the dense operand are processed in parallel.
+ * @throws std::invalid_argument if column count of A != row count of B.
+ * @note Example: Matrix<double> c = dense * s;
+ */
+template <typename T, SparseFormat F>
+Matrix<T> operator*(const Matrix<T>& lhs, const SparseMatrix<T, F>& rhs) {
+    if (lhs.getCols() != rhs.getRows()) {
+        throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+    }
+    //A CSR operand is read in place; only a CSC one is converted
+    SparseMatrix<T, SparseFormat::CSR> converted(0, 0);
+    if constexpr (F == SparseFormat::CSC) {
+        converted = rhs.toCSR();
+    }
+    const SparseMatrix<T, SparseFormat::CSR>& b = [&]() -> const SparseMatrix<T, SparseFormat::CSR>& {
+        if constexpr (F == SparseFormat::CSR) {
+            return rhs;
+        } else {
+            return converted;
+        }
+    }();
+    const int k = lhs.getCols();
+    Matrix<T> c(lhs.getRows(), rhs.getCols());
+    const long long work = static_cast<long long>(lhs.getRows()) * (b.nonZeros() + k);
+    matrixlib::parallelRows(lhs.getRows(), work, [&](int row_begin, int row_end) {
+        for (int i = row_begin; i < row_end; i++) {
+            T* ci = c.rowData(i);
+            const T* ai = lhs.rowData(i);
+            for (int p = 0; p < k; p++) {
+                const T a = ai[p];
+                for (int q = b.offsets()[p]; q < b.offsets()[p + 1]; q++) {
+                    ci[b.indices()[q]] += a * b.values()[q];
+                }
+            }
+        }
+    });
+    return c;
+}
+
+/**
+ * @brief Sparse times sparse product; the result has the format of the left operand.
+ * @note Example: SparseMatrix<double> c = a * b;
+ */
+template <typename T, SparseFormat F, SparseFormat G>
+SparseMatrix<T, F> operator*(const SparseMatrix<T, F>& lhs, const SparseMatrix<T, G>& rhs) {
+    return lhs.multiply(rhs);
+}
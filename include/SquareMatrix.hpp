@@ -1,145 +1,538 @@
-#pragma once
-#include <iostream>
-#include <vector>
-#include <stdexcept>
-#include "Matrix.hpp"
-
-/**
- * @class Square_Matrix
- * @brief A specialized Matrix class for square matrices (NxN).
- * Inherits from Matrix<T> and adds functionality for determinant and inverse calculation.
- */
-template <typename T>
-class Square_Matrix : public Matrix<T> {
-private:
-    /**
-     * @brief Helper function to get the cofactor matrix (submatrix excluding row p and col q).
-     * Used internally for determinant and adjugate calculations.
-     * @param mat Source matrix.
-     * @param temp Destination matrix for the cofactor.
-     * @param p Row to exclude.
-     * @param q Column to exclude.
-     * @param n Current dimension.
-     */
-    void getCofactor(const std::vector<std::vector<T>>& mat, std::vector<std::vector<T>>& temp, int p, int q, int n) const {
-        int i = 0, j = 0;
-        for (int row = 0; row < n; row++) {
-            for (int col = 0; col < n; col++) {
-                if (row != p && col != q) {
-                    temp[i][j++] = mat[row][col];
-                    if (j == n - 1) {
-                        j = 0;
-                        i++;
-                    }
-                }
-            }
-        }
-    }
-
-    /**
-     * @brief Recursive helper function to calculate the determinant using Laplace expansion.
-     * @param mat The matrix to calculate.
-     * @param n Current dimension of the matrix.
-     * @return The calculated determinant value.
-     */
-    T determinantRecursive(const std::vector<std::vector<T>>& mat, int n) const {
-        if (n == 1)
-            return mat[0][0];
-
-        T det = 0;
-        std::vector<std::vector<T>> temp(n, std::vector<T>(n));
-        int sign = 1;
-
-        for (int f = 0; f < n; f++) {
-            getCofactor(mat, temp, 0, f, n);
-            det += sign * mat[0][f] * determinantRecursive(temp, n - 1);
-            sign = -sign;
-        }
-        return det;
-    }
-
-public:
-    /**
-     * @brief Constructs an empty Square Matrix of size NxN.
-     * @param n The dimension (number of rows/columns).
-     * @throws std::invalid_argument if n is not positive.
-     * @note Example: Square_Matrix<double> sq(3); // Creates 3x3 square matrix
-     */
-    Square_Matrix(int n) : Matrix<T>(n, n) {
-        if (n <= 0) throw std::invalid_argument("Size must be positive.\n");
-    }
-
-    /**
-     * @brief Constructs a Square Matrix from a vector of vectors.
-     * Validates that the input is actually square.
-     * @param value Initial data.
-     * @throws std::invalid_argument if rows != columns.
-     * @note Example: Square_Matrix<int> sq({{1, 2}, {3, 4}});
-     */
-    Square_Matrix(std::vector<std::vector<T>> value) : Matrix<T>(value) {
-        if (this->m_row != this->m_col) {
-            throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
-        }
-    }
-
-    /**
-     * @brief Calculates the determinant of the matrix.
-     * @return The determinant value.
-     * @note Example: double det = sq.determinant();
-     */
-    T determinant() const {
-        return determinantRecursive(this->data, this->m_row);
-    }
-
-    /**
-     * @brief Calculates the Adjugate Matrix.
-     * The Adjugate is the transpose of the Cofactor Matrix.
-     * @return A new Square_Matrix representing the adjugate.
-     * @note Example: Square_Matrix adj = sq.adjugate();
-     */
-    Square_Matrix adjugate() const {
-        int n = this->m_row;
-        Square_Matrix adj(n);
-        if (n == 1) {
-            adj.data[0][0] = 1;
-            return adj;
-        }
-
-        int sign = 1;
-        std::vector<std::vector<T>> temp(n, std::vector<T>(n));
-
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                getCofactor(this->data, temp, i, j, n);
-                sign = ((i + j) % 2 == 0) ? 1 : -1;
-                adj.data[j][i] = (sign) * (determinantRecursive(temp, n - 1));
-            }
-        }
-        return adj;
-    }
-
-    /**
-     * @brief Calculates the Inverse Matrix.
-     * Formula: A^-1 = (1 / det(A)) * adj(A).
-     * @return A new Square_Matrix representing the inverse.
-     * @throws std::invalid_argument if the matrix is singular (determinant is 0).
-     * @note Recommended to use with floating point types (float/double).
-     * @note Example: Square_Matrix inv = sq.inverse();
-     */
-    Square_Matrix inverse() const {
-        T det = determinant();
-        if (det == static_cast<T>(0)) {
-            throw std::invalid_argument("Cannot calculate inverse: Determinant is 0.\n");
-        }
-
-        Square_Matrix adj = adjugate();
-        
-        Square_Matrix inv(this->m_row);
-        for (int i = 0; i < this->m_row; i++) {
-            for (int j = 0; j < this->m_col; j++) {
-                inv.data[i][j] = adj.data[i][j] / det;
-            }
-        }
-        return inv;
-    }
-};
+#pragma once
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <limits>
+#include "Matrix.hpp"
+#include "LUFactorization.hpp"
+#include "CholeskyFactorization.hpp"
+#include "MixedPrecision.hpp"
+#include "TriangularSolve.hpp"
+#include "Strassen.hpp"
+#include "ScratchArena.hpp"
+#include "Fraction.hpp"
+#include "Bareiss.hpp"
+
+/**
+ * @class Square_Matrix
+ * @brief A specialized Matrix class for square matrices (NxN).
+ * Inherits from Matrix<T, Alloc> and adds functionality for determinant and inverse calculation.
+ * Floating point matrices compute the determinant, inverse and solve through an O(n^3)
+ * LU factorization. Integral matrices stay exact: the determinant, adjugate, inverse and solve
+ * come from fraction-free (Bareiss) elimination in O(n^3), falling back to multi-modular
+ * arithmetic when 64-bit intermediates overflow, and inverseExact() / solveExact() return
+ * rationals.
+ * Workspace (the factored copy, cofactor minors) comes from the calling thread's ScratchArena,
+ * so only the returned matrices are allocated with Alloc.
+ */
+template <typename T, typename Alloc = AlignedAllocator<T>>
+class Square_Matrix : public Matrix<T, Alloc> {
+private:
+    using ScratchLU = LU_Factorization<T, matrixlib::ArenaAllocator<T>>;
+
+    /**
+     * @brief Helper function to get the cofactor matrix (submatrix excluding row p and col q).
+     * Used internally for determinant and adjugate calculations.
+     * Both matrices are stored densely (row-major, stride equal to their dimension).
+     * @param mat Source matrix (n x n).
+     * @param temp Destination matrix for the cofactor ((n-1) x (n-1)).
+     * @param p Row to exclude.
+     * @param q Column to exclude.
+     * @param n Current dimension.
+     */
+    void getCofactor(const T* mat, T* temp, int p, int q, int n) const {
+        for (int row = 0; row < n; row++) {
+            if (row == p) continue;
+            for (int col = 0; col < n; col++) {
+                if (col != q) {
+                    *temp++ = mat[row * n + col];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Copies the matrix into a dense n x n scratch buffer (stride equal to n).
+     * @param scope Open scope of the calling thread that owns the copy.
+     * @return Row-major copy of the elements without row padding.
+     */
+    T* denseCopy(matrixlib::ScratchScope& scope) const {
+        int n = this->m_row;
+        T* dense = scope.allocate<T>(static_cast<std::size_t>(n) * n);
+        for (int r = 0; r < n; r++) {
+            std::copy(this->rowData(r), this->rowData(r) + n, dense + static_cast<std::size_t>(r) * n);
+        }
+        return dense;
+    }
+
+    /**
+     * @brief Factors a scratch copy of the matrix.
+     * The result lives in the ScratchArena and must not outlive the caller's ScratchScope.
+     */
+    ScratchLU scratchLU() const {
+        return ScratchLU(Matrix<T, matrixlib::ArenaAllocator<T>>(*this));
+    }
+
+    /**
+     * @brief Exact det(A) and det(A) * A^-1 for an integral matrix (numerators left at zero when
+     * A is singular).
+     * @throws std::overflow_error if a result does not fit in 64 bits.
+     */
+    matrixlib::detail::ExactSolution exactInverse() const {
+        const int n = this->m_row;
+        matrixlib::ScratchScope scope;
+        T* identity = scope.allocate<T>(static_cast<std::size_t>(n) * n);
+        std::fill(identity, identity + static_cast<std::size_t>(n) * n, static_cast<T>(0));
+        for (int i = 0; i < n; i++) {
+            identity[static_cast<std::size_t>(i) * n + i] = static_cast<T>(1);
+        }
+        return matrixlib::detail::exactSolve<T>(n, n, this->rowData(0), this->getStride(), identity, n);
+    }
+
+    /**
+     * @brief Converts an exact 64-bit result to T.
+     * @throws std::overflow_error if it does not fit.
+     */
+    static T narrow(long long value) {
+        if (!std::in_range<T>(value)) {
+            throw std::overflow_error("Exact result does not fit in the element type.\n");
+        }
+        return static_cast<T>(value);
+    }
+
+    /**
+     * @brief Writes X = N / det(A) of an exact solution to out (n x k, row stride ldo).
+     * @param fractional Message thrown when an entry of X is not an integer.
+     * @throws std::invalid_argument if an entry of X is not an integer.
+     * @throws std::overflow_error if an entry does not fit in T.
+     */
+    static void integerQuotients(const matrixlib::detail::ExactSolution& exact, int n, int k, T* out, std::ptrdiff_t ldo,
+                                 const char* fractional) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < k; j++) {
+                //In 128 bits, so LLONG_MIN / -1 is an overflow rather than undefined
+                const matrixlib::detail::wide_int numerator = exact.numerators[static_cast<std::size_t>(i) * k + j];
+                if (numerator % exact.det != 0) {
+                    throw std::invalid_argument(fractional);
+                }
+                const matrixlib::detail::wide_int entry = numerator / exact.det;
+                if (entry < std::numeric_limits<long long>::min() || entry > std::numeric_limits<long long>::max()) {
+                    throw std::overflow_error("Exact result does not fit in the element type.\n");
+                }
+                out[i * ldo + j] = narrow(static_cast<long long>(entry));
+            }
+        }
+    }
+
+    /**
+     * @brief Exact solve for integral types: B (n x k, row stride ldb) is overwritten with X.
+     * @throws std::invalid_argument if sizes do not match, A is singular or X is not integral.
+     */
+    void solveIntegerInPlace(int k, T* b, std::ptrdiff_t ldb) const {
+        const int n = this->m_row;
+        const matrixlib::detail::ExactSolution exact =
+            matrixlib::detail::exactSolve<T>(n, k, this->rowData(0), this->getStride(), b, ldb);
+        if (exact.det == 0) {
+            throw std::invalid_argument("Cannot solve: matrix is singular.\n");
+        }
+        integerQuotients(exact, n, k, b, ldb, "Solution is not an integer matrix; use solveExact().\n");
+    }
+
+    /**
+     * @brief Determinant of an m x m minor stored densely (row-major, stride m).
+     */
+    static T minorDeterminant(const T* minor, int m) {
+        if constexpr (std::is_integral_v<T>) {
+            return narrow(matrixlib::detail::exactSolve<T>(m, 0, minor, m, nullptr, 0).det);
+        } else {
+            matrixlib::ScratchScope scope;
+            Matrix<T, matrixlib::ArenaAllocator<T>> copy(m, m);
+            for (int r = 0; r < m; r++) {
+                std::copy(minor + static_cast<std::size_t>(r) * m, minor + static_cast<std::size_t>(r + 1) * m, copy.rowData(r));
+            }
+            return ScratchLU(std::move(copy)).determinant();
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an empty Square Matrix of size NxN.
+     * @param n The dimension (number of rows/columns).
+     * @throws std::invalid_argument if n is not positive.
+     * @note Example: Square_Matrix<double> sq(3); // Creates 3x3 square matrix
+     */
+    Square_Matrix(int n) : Matrix<T, Alloc>(n, n) {
+        if (n <= 0) throw std::invalid_argument("Size must be positive.\n");
+    }
+
+    /**
+     * @brief Constructs a Square Matrix from a vector of vectors.
+     * Validates that the input is actually square.
+     * @param value Initial data.
+     * @throws std::invalid_argument if rows != columns.
+     * @note Example: Square_Matrix<int> sq({{1, 2}, {3, 4}});
+     */
+    Square_Matrix(const std::vector<std::vector<T>>& value) : Matrix<T, Alloc>(value) {
+        if (this->m_row != this->m_col) {
+            throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
+        }
+    }
+
+    /**
+     * @brief Constructs a Square Matrix from a general Matrix.
+     * @param other Source matrix.
+     * @throws std::invalid_argument if rows != columns.
+     * @note Example: Square_Matrix<double> sq(matA * matB);
+     */
+    explicit Square_Matrix(const Matrix<T, Alloc>& other) : Matrix<T, Alloc>(other) {
+        if (this->m_row != this->m_col) {
+            throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
+        }
+    }
+
+    /**
+     * @brief Constructs a Square Matrix by taking over the buffer of a temporary Matrix.
+     * @param other Source matrix, left empty afterwards.
+     * @throws std::invalid_argument if rows != columns.
+     * @note Example: Square_Matrix<double> sq(matA * matB);
+     */
+    explicit Square_Matrix(Matrix<T, Alloc>&& other) : Matrix<T, Alloc>(std::move(other)) {
+        if (this->m_row != this->m_col) {
+            throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
+        }
+    }
+
+    /**
+     * @brief Multiplies by another square matrix with Strassen-Winograd recursion.
+     * Worth it for large matrices (thousands of rows): each level above the cutoff replaces one
+     * of 8 half-size products with additions. Subproducts at or below cutoff use the regular
+     * GEMM kernel, and the result agrees with operator* up to slightly larger rounding errors.
+     * @param other Right operand, same size.
+     * @param cutoff Size at or below which recursion stops.
+     * @return The product.
+     * @throws std::invalid_argument if the sizes differ or cutoff is not positive.
+     * @note Example: Square_Matrix<double> c = a.multiplyStrassen(b, 2048);
+     */
+    Square_Matrix multiplyStrassen(const Square_Matrix& other, int cutoff = matrixlib::strassen_cutoff) const {
+        const int n = this->m_row;
+        if (other.m_row != n) {
+            throw std::invalid_argument("Both matrices must be the same size.\n");
+        }
+        Square_Matrix result(n);
+        matrixlib::strassen<T>(n, this->rowData(0), this->getStride(), other.rowData(0), other.getStride(),
+                               result.rowData(0), result.getStride(), cutoff);
+        return result;
+    }
+
+    /**
+     * @brief Computes the LU factorization with partial pivoting (P * A = L * U).
+     * The returned object can be reused for determinant, inverse and any number of solves.
+     * @return The factorization.
+     * @note Example: LU_Factorization<double> f = sq.lu();
+     */
+    LU_Factorization<T, Alloc> lu() const {
+        return LU_Factorization<T, Alloc>(*this);
+    }
+
+    /**
+     * @brief Calculates the determinant of the matrix.
+     * Integral types get the exact value from Bareiss elimination.
+     * @return The determinant value.
+     * @throws std::overflow_error for integral types if the determinant does not fit in T.
+     * @note Example: double det = sq.determinant();
+     */
+    T determinant() const {
+        MATRIXLIB_INSTRUMENT(Determinant, this->m_row, this->m_col, 0, 2.0 / 3.0 * static_cast<double>(this->m_row) * this->m_row * this->m_row,
+                             2 * static_cast<double>(this->m_row) * this->m_row * sizeof(T));
+        if constexpr (std::is_integral_v<T>) {
+            return narrow(matrixlib::detail::exactSolve<T>(this->m_row, 0, this->rowData(0), this->getStride(), nullptr, 0).det);
+        } else {
+            matrixlib::ScratchScope scope;
+            return scratchLU().determinant();
+        }
+    }
+
+    /**
+     * @brief Solves A * X = B for all columns of B using the LU factorization.
+     * Integral types solve exactly and return X only when every entry is an integer; use
+     * solveExact() for rational solutions.
+     * @param b Right-hand sides (n x k).
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if sizes do not match or the matrix is singular, or for
+     * integral types if X has non-integer entries.
+     * @throws std::overflow_error for integral types if an intermediate does not fit in 64 bits.
+     * @note Example: Matrix<double> x = sq.solve(b);
+     */
+    template <typename BAlloc>
+    Matrix<T, BAlloc> solve(const Matrix<T, BAlloc>& b) const {
+        Matrix<T, BAlloc> x(b);
+        if constexpr (std::is_integral_v<T>) {
+            if (b.getRows() != this->m_row) {
+                throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+            }
+            solveIntegerInPlace(x.getCols(), x.rowData(0), x.getStride());
+        } else {
+            matrixlib::ScratchScope scope;
+            scratchLU().solveInPlace(x);
+        }
+        return x;
+    }
+
+    /**
+     * @brief Solves A * x = b for a single right-hand side vector.
+     * Integral types solve exactly, as for the matrix overload.
+     * @param b Right-hand side of length n.
+     * @return The solution vector.
+     * @throws std::invalid_argument if sizes do not match or the matrix is singular, or for
+     * integral types if x has non-integer entries.
+     * @note Example: std::vector<double> x = sq.solve({1.0, 2.0, 3.0});
+     */
+    std::vector<T> solve(const std::vector<T>& b) const {
+        if constexpr (std::is_integral_v<T>) {
+            if (static_cast<int>(b.size()) != this->m_row) {
+                throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+            }
+            std::vector<T> x(b);
+            solveIntegerInPlace(1, x.data(), 1);
+            return x;
+        } else {
+            matrixlib::ScratchScope scope;
+            return scratchLU().solve(b);
+        }
+    }
+
+    /**
+     * @brief Solves A * X = B with a float LU factorization refined to the accuracy of T.
+     * The O(n^3) factorization runs in single precision, then iterative refinement with residuals
+     * in T recovers full accuracy in a few O(n^2 k) steps. If refinement does not converge (the
+     * matrix is too ill-conditioned for float), the system is solved again with an LU in T.
+     * @param b Right-hand sides (n x k).
+     * @param info Receives the number of refinement steps, convergence and whether the fallback ran.
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if sizes do not match or the matrix is singular.
+     * @note Example: matrixlib::RefinementInfo info; Matrix<double> x = sq.solveMixedPrecision(b, info);
+     */
+    template <typename BAlloc>
+        requires std::is_floating_point_v<T>
+    Matrix<T, BAlloc> solveMixedPrecision(const Matrix<T, BAlloc>& b, matrixlib::RefinementInfo& info) const {
+        Matrix<T, BAlloc> x(b);
+        info = matrixlib::solveRefinedInPlace<float>(*this, x);
+        return x;
+    }
+
+    /**
+     * @brief Solves A * X = B with a float LU factorization refined to the accuracy of T.
+     * @note Example: Matrix<double> x = sq.solveMixedPrecision(b);
+     */
+    template <typename BAlloc>
+        requires std::is_floating_point_v<T>
+    Matrix<T, BAlloc> solveMixedPrecision(const Matrix<T, BAlloc>& b) const {
+        matrixlib::RefinementInfo info;
+        return solveMixedPrecision(b, info);
+    }
+
+    /**
+     * @brief Computes the Cholesky factorization A = L * L^T of a symmetric positive definite matrix.
+     * Only the lower triangle is read. Check isPositiveDefinite() on the result.
+     * @return The factorization.
+     * @note Example: Cholesky_Factorization<double> chol = sq.cholesky();
+     */
+    Cholesky_Factorization<T, Alloc> cholesky() const {
+        return Cholesky_Factorization<T, Alloc>(*this);
+    }
+
+    /**
+     * @brief Solves A * X = B for all columns of B, where A is symmetric positive definite.
+     * Uses the Cholesky factorization: half the work of solve() and no pivoting.
+     * @param b Right-hand sides (n x k).
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if sizes do not match or the matrix is not positive definite.
+     * @note Example: Matrix<double> x = covariance.solvePositiveDefinite(b);
+     */
+    template <typename BAlloc>
+    Matrix<T, BAlloc> solvePositiveDefinite(const Matrix<T, BAlloc>& b) const {
+        Matrix<T, BAlloc> x(b);
+        matrixlib::ScratchScope scope;
+        Cholesky_Factorization<T, matrixlib::ArenaAllocator<T>> factors{Matrix<T, matrixlib::ArenaAllocator<T>>(*this)};
+        factors.solveInPlace(x);
+        return x;
+    }
+
+    /**
+     * @brief Solves A * X = B for all columns of B, where A is triangular.
+     * Forward substitution for a lower triangle, back substitution for an upper one; the other
+     * triangle is not read.
+     * @param b Right-hand sides (n x k).
+     * @param uplo Triangle of the matrix that holds A.
+     * @param unit_diagonal Treat the diagonal as all ones without reading it.
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if sizes do not match or the diagonal contains a zero.
+     * @note Example: Matrix<double> x = l.solveTriangular(b, matrixlib::Triangle::Lower);
+     */
+    template <typename BAlloc>
+    Matrix<T, BAlloc> solveTriangular(const Matrix<T, BAlloc>& b, matrixlib::Triangle uplo,
+                                      bool unit_diagonal = false) const {
+        const int n = this->m_row;
+        if (b.getRows() != n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        if (!unit_diagonal) {
+            for (int i = 0; i < n; i++) {
+                if ((*this)(i, i) == static_cast<T>(0)) {
+                    throw std::invalid_argument("Cannot solve: matrix is singular.\n");
+                }
+            }
+        }
+        Matrix<T, BAlloc> x(b);
+        matrixlib::trsm<T>(uplo, unit_diagonal, n, x.getCols(), this->rowData(0), this->getStride(), 1,
+                           x.rowData(0), x.getStride());
+        return x;
+    }
+
+    /**
+     * @brief Calculates the Adjugate Matrix.
+     * The Adjugate is the transpose of the Cofactor Matrix. Invertible matrices compute it as
+     * det(A) * A^-1 (exactly, for integral types); singular ones fall back to cofactors.
+     * @return A new Square_Matrix representing the adjugate.
+     * @throws std::overflow_error for integral types if an entry does not fit in 64 bits.
+     * @note Example: Square_Matrix adj = sq.adjugate();
+     */
+    Square_Matrix adjugate() const {
+        int n = this->m_row;
+        Square_Matrix adj(n);
+        matrixlib::ScratchScope scope;
+        if constexpr (!std::is_integral_v<T>) {
+            //adj(A) = det(A) * A^-1 whenever A is invertible
+            ScratchLU factors = scratchLU();
+            if (!factors.isSingular()) {
+                for (int i = 0; i < n; i++) {
+                    adj(i, i) = static_cast<T>(1);
+                }
+                factors.solveInPlace(adj);
+                adj.multiplyByConstant(factors.determinant());
+                return adj;
+            }
+        } else {
+            const matrixlib::detail::ExactSolution exact = exactInverse();
+            if (exact.det != 0) {
+                for (int i = 0; i < n; i++) {
+                    for (int j = 0; j < n; j++) {
+                        adj(i, j) = narrow(exact.numerators[static_cast<std::size_t>(i) * n + j]);
+                    }
+                }
+                return adj;
+            }
+        }
+        if (n == 1) {
+            adj(0, 0) = 1;
+            return adj;
+        }
+
+        int sign = 1;
+        const T* mat = denseCopy(scope);
+        T* temp = scope.allocate<T>(static_cast<std::size_t>(n - 1) * (n - 1));
+
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                getCofactor(mat, temp, i, j, n);
+                sign = ((i + j) % 2 == 0) ? 1 : -1;
+                adj(j, i) = (sign) * (minorDeterminant(temp, n - 1));
+            }
+        }
+        return adj;
+    }
+
+    /**
+     * @brief Calculates the Inverse Matrix.
+     * Floating point types solve A * X = I with the LU factorization.
+     * Integral types compute det(A) and adj(A) exactly and return adj(A) / det(A) only when every
+     * entry divides evenly (e.g. unimodular matrices); use inverseExact() for rational inverses.
+     * @return A new Square_Matrix representing the inverse.
+     * @throws std::invalid_argument if the matrix is singular (determinant is 0), or for integral
+     * types if the inverse has non-integer entries.
+     * @throws std::overflow_error for integral types if an intermediate does not fit in 64 bits.
+     * @note Example: Square_Matrix inv = sq.inverse();
+     */
+    Square_Matrix inverse() const {
+        MATRIXLIB_INSTRUMENT(Inverse, this->m_row, this->m_col, 0, 2.0 * static_cast<double>(this->m_row) * this->m_row * this->m_row, 3 * static_cast<double>(this->m_row) * this->m_row * sizeof(T));
+        if constexpr (!std::is_integral_v<T>) {
+            Square_Matrix inv(this->m_row);
+            for (int i = 0; i < this->m_row; i++) {
+                inv(i, i) = static_cast<T>(1);
+            }
+            matrixlib::ScratchScope scope;
+            ScratchLU factors = scratchLU();
+            if (factors.isSingular()) {
+                throw std::invalid_argument("Cannot calculate inverse: Determinant is 0.\n");
+            }
+            factors.solveInPlace(inv);
+            return inv;
+        } else {
+            const int n = this->m_row;
+            const matrixlib::detail::ExactSolution exact = exactInverse();
+            if (exact.det == 0) {
+                throw std::invalid_argument("Cannot calculate inverse: Determinant is 0.\n");
+            }
+            Square_Matrix inv(n);
+            integerQuotients(exact, n, n, inv.rowData(0), inv.getStride(), "Inverse is not an integer matrix; use inverseExact().\n");
+            return inv;
+        }
+    }
+
+    /**
+     * @brief Calculates the exact inverse of an integral matrix as fractions in lowest terms.
+     * @return A^-1 with entries adj(A)(i, j) / det(A).
+     * @throws std::invalid_argument if the matrix is singular (determinant is 0).
+     * @throws std::overflow_error if det(A) or an entry of adj(A) does not fit in 64 bits.
+     * @note Example: Square_Matrix<matrixlib::Fraction<long long>> inv = sq.inverseExact();
+     */
+    Square_Matrix<matrixlib::Fraction<long long>> inverseExact() const
+        requires std::is_integral_v<T>
+    {
+        const int n = this->m_row;
+        const matrixlib::detail::ExactSolution exact = exactInverse();
+        if (exact.det == 0) {
+            throw std::invalid_argument("Cannot calculate inverse: Determinant is 0.\n");
+        }
+        Square_Matrix<matrixlib::Fraction<long long>> inv(n);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                inv(i, j) = matrixlib::Fraction<long long>(exact.numerators[static_cast<std::size_t>(i) * n + j], exact.det);
+            }
+        }
+        return inv;
+    }
+
+    /**
+     * @brief Solves A * X = B exactly for an integral matrix, with X as fractions in lowest terms.
+     * @param b Right-hand sides (n x k).
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if sizes do not match or the matrix is singular.
+     * @throws std::overflow_error if det(A) or det(A) * X does not fit in 64 bits.
+     * @note Example: Matrix<matrixlib::Fraction<long long>> x = sq.solveExact(b);
+     */
+    template <typename BAlloc>
+        requires std::is_integral_v<T>
+    Matrix<matrixlib::Fraction<long long>> solveExact(const Matrix<T, BAlloc>& b) const {
+        const int n = this->m_row;
+        const int k = b.getCols();
+        if (b.getRows() != n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        const matrixlib::detail::ExactSolution exact =
+            matrixlib::detail::exactSolve<T>(n, k, this->rowData(0), this->getStride(), b.rowData(0), b.getStride());
+        if (exact.det == 0) {
+            throw std::invalid_argument("Cannot solve: matrix is singular.\n");
+        }
+        Matrix<matrixlib::Fraction<long long>> x(n, k);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < k; j++) {
+                x(i, j) = matrixlib::Fraction<long long>(exact.numerators[static_cast<std::size_t>(i) * k + j], exact.det);
+            }
+        }
+        return x;
+    }
+};
@@ -0,0 +1,193 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include "Gemm.hpp"
+#include "ScratchArena.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @file Strassen.hpp
+ * @brief Recursive Strassen-Winograd multiplication of square matrices.
+ *
+ * Each level splits the operands into quadrants and forms the product from 7 half-size products
+ * and 15 additions instead of 8 products, so the operation count falls to O(n^2.81). Below the
+ * cutoff the packed GEMM kernel takes over, since it is faster than further splitting there.
+ * Odd dimensions are handled by peeling the last row and column and fixing them up with GEMM.
+ * The 7 products of the top levels run as parallel tasks on the shared pool. All temporaries
+ * come from one buffer sized up front and taken from the calling thread's scratch arena.
+ */
+namespace matrixlib {
+
+/**
+ * @brief Default size at or below which strassen() hands off to gemm().
+ */
+inline constexpr int strassen_cutoff = 1024;
+
+namespace detail {
+
+/**
+ * @brief z = x + sign * y on h x h blocks with their own row strides. z may alias x or y.
+ */
+template <typename T>
+void addBlocks(int h, const T* x, std::ptrdiff_t ldx, const T* y, std::ptrdiff_t ldy, T sign,
+               T* z, std::ptrdiff_t ldz) {
+    parallelRows(h, static_cast<long long>(h) * h, [&](int r0, int r1) {
+        for (int r = r0; r < r1; r++) {
+            const T* xr = x + r * ldx;
+            const T* yr = y + r * ldy;
+            T* zr = z + r * ldz;
+            for (int c = 0; c < h; c++) {
+                zr[c] = xr[c] + sign * yr[c];
+            }
+        }
+    });
+}
+
+/**
+ * @brief Elements of workspace needed by winograd() for an n x n product.
+ * @param parallel_levels Levels whose 7 products run concurrently, each with its own workspace.
+ */
+inline std::size_t winogradWorkspace(int n, int cutoff, int parallel_levels) {
+    if (n <= cutoff) {
+        return 0;
+    }
+    if (n % 2 != 0) {
+        return winogradWorkspace(n - 1, cutoff, parallel_levels);
+    }
+    const int h = n / 2;
+    const std::size_t child = winogradWorkspace(h, cutoff, parallel_levels - 1);
+    return 11 * static_cast<std::size_t>(h) * h + (parallel_levels > 0 ? 7 : 1) * child;
+}
+
+/**
+ * @brief C = A * B for n x n row-major blocks, C not aliasing A or B.
+ * @param work Workspace of at least winogradWorkspace(n, cutoff, parallel_levels) elements.
+ */
+template <typename T>
+void winograd(int n, const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb, T* c, std::ptrdiff_t ldc,
+              int cutoff, int parallel_levels, T* work) {
+    const T one = static_cast<T>(1);
+    if (n <= cutoff) {
+        gemm<T>(n, n, n, one, a, lda, 1, b, ldb, 1, static_cast<T>(0), c, ldc);
+        return;
+    }
+    if (n % 2 != 0) {
+        //Dynamic peeling: recurse on the leading even part, then add the last row and column
+        const int m = n - 1;
+        winograd(m, a, lda, b, ldb, c, ldc, cutoff, parallel_levels, work);
+        //C[0:m, 0:m] += A[0:m, m] * B[m, 0:m]
+        gemm<T>(m, m, 1, one, a + m, lda, 1, b + m * ldb, ldb, 1, one, c, ldc);
+        //C[0:m, m] = A[0:m, :] * B[:, m]
+        gemm<T>(m, 1, n, one, a, lda, 1, b + m, ldb, 1, static_cast<T>(0), c + m, ldc);
+        //C[m, :] = A[m, :] * B
+        gemm<T>(1, n, n, one, a + m * lda, lda, 1, b, ldb, 1, static_cast<T>(0), c + m * ldc, ldc);
+        return;
+    }
+
+    const int h = n / 2;
+    const std::size_t hh = static_cast<std::size_t>(h) * h;
+    const T* a11 = a;
+    const T* a12 = a + h;
+    const T* a21 = a + h * lda;
+    const T* a22 = a21 + h;
+    const T* b11 = b;
+    const T* b12 = b + h;
+    const T* b21 = b + h * ldb;
+    const T* b22 = b21 + h;
+    T* c11 = c;
+    T* c12 = c + h;
+    T* c21 = c + h * ldc;
+    T* c22 = c21 + h;
+
+    T* s1 = work;
+    T* s2 = s1 + hh;
+    T* s3 = s2 + hh;
+    T* s4 = s3 + hh;
+    T* t1 = s4 + hh;
+    T* t2 = t1 + hh;
+    T* t3 = t2 + hh;
+    T* t4 = t3 + hh;
+    T* p2 = t4 + hh;
+    T* p6 = p2 + hh;
+    T* p7 = p6 + hh;
+    T* child_work = p7 + hh;
+
+    addBlocks(h, a21, lda, a22, lda, one, s1, h);  //S1 = A21 + A22
+    addBlocks(h, s1, h, a11, lda, -one, s2, h);    //S2 = S1 - A11
+    addBlocks(h, a11, lda, a21, lda, -one, s3, h); //S3 = A11 - A21
+    addBlocks(h, a12, lda, s2, h, -one, s4, h);    //S4 = A12 - S2
+    addBlocks(h, b12, ldb, b11, ldb, -one, t1, h); //T1 = B12 - B11
+    addBlocks(h, b22, ldb, t1, h, -one, t2, h);    //T2 = B22 - T1
+    addBlocks(h, b22, ldb, b12, ldb, -one, t3, h); //T3 = B22 - B12
+    addBlocks(h, t2, h, b21, ldb, -one, t4, h);    //T4 = T2 - B21
+
+    //P1, P3, P4 and P5 are written straight into the quadrants of C that consume them
+    struct Product {
+        const T* x;
+        std::ptrdiff_t ldx;
+        const T* y;
+        std::ptrdiff_t ldy;
+        T* z;
+        std::ptrdiff_t ldz;
+    };
+    const Product products[7] = {
+        {a11, lda, b11, ldb, c11, ldc}, //P1 = A11 * B11
+        {a12, lda, b21, ldb, p2, h},    //P2 = A12 * B21
+        {s4, h, b22, ldb, c12, ldc},    //P3 = S4 * B22
+        {a22, lda, t4, h, c21, ldc},    //P4 = A22 * T4
+        {s1, h, t1, h, c22, ldc},       //P5 = S1 * T1
+        {s2, h, t2, h, p6, h},          //P6 = S2 * T2
+        {s3, h, t3, h, p7, h},          //P7 = S3 * T3
+    };
+    const std::size_t child_size = winogradWorkspace(h, cutoff, parallel_levels - 1);
+    if (parallel_levels > 0) {
+        ThreadPool::instance().parallelFor(7, [&](int i) {
+            const Product& p = products[i];
+            winograd(h, p.x, p.ldx, p.y, p.ldy, p.z, p.ldz, cutoff, parallel_levels - 1, child_work + i * child_size);
+        });
+    } else {
+        for (const Product& p : products) {
+            winograd(h, p.x, p.ldx, p.y, p.ldy, p.z, p.ldz, cutoff, 0, child_work);
+        }
+    }
+
+    addBlocks(h, p6, h, c11, ldc, one, p6, h);   //U2 = P1 + P6
+    addBlocks(h, p7, h, p6, h, one, p7, h);      //U3 = U2 + P7
+    addBlocks(h, p6, h, c22, ldc, one, p6, h);   //U4 = U2 + P5
+    addBlocks(h, c12, ldc, p6, h, one, c12, ldc); //C12 = U4 + P3
+    addBlocks(h, p7, h, c21, ldc, -one, c21, ldc); //C21 = U3 - P4
+    addBlocks(h, c22, ldc, p7, h, one, c22, ldc); //C22 = U3 + P5
+    addBlocks(h, c11, ldc, p2, h, one, c11, ldc); //C11 = P1 + P2
+}
+
+} // namespace detail
+
+/**
+ * @brief C = A * B for n x n row-major matrices using Strassen-Winograd recursion.
+ * Subproducts of size at most cutoff are computed with gemm(). C must not alias A or B.
+ * Rounding errors grow somewhat faster than with gemm(), by a small factor per recursion level.
+ * @param cutoff Size at or below which recursion stops; must be positive.
+ * @throws std::invalid_argument if cutoff is not positive.
+ * @note Example: strassen(n, A, lda, B, ldb, C, ldc, 512);
+ */
+template <typename T>
+void strassen(int n, const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb, T* c, std::ptrdiff_t ldc,
+              int cutoff = strassen_cutoff) {
+    if (cutoff <= 0) {
+        throw std::invalid_argument("Strassen cutoff must be positive.\n");
+    }
+    if (n <= 0) {
+        return;
+    }
+    //Run the 7 products of a level in parallel until there are enough tasks for every thread
+    int parallel_levels = 0;
+    for (int tasks = 1; tasks < ThreadPool::instance().size(); tasks *= 7) {
+        parallel_levels++;
+    }
+    ScratchScope scope;
+    T* work = scope.allocate<T>(detail::winogradWorkspace(n, cutoff, parallel_levels));
+    detail::winograd(n, a, lda, b, ldb, c, ldc, cutoff, parallel_levels, work);
+}
+
+} // namespace matrixlib
@@ -0,0 +1,335 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "Matrix.hpp"
+#include "SquareMatrix.hpp"
+#include "Reduction.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @class SymmetricMatrix
+ * @brief A symmetric n x n matrix stored packed: only the lower triangle, row by row, in
+ * n * (n + 1) / 2 elements (about half of the dense storage).
+ * Element (i, j) with i >= j lives at i * (i + 1) / 2 + j, so every row of the lower triangle is
+ * contiguous. Products walk the packed rows contiguously and use each off-diagonal element for both
+ * of its positions (the vector product in a single pass over the triangle). Solves and the
+ * determinant use a packed Cholesky factorization (a third of the work of dense LU) and fall
+ * back to a dense LU only when the matrix is not positive definite.
+ * @note Example:
+ * SymmetricMatrix<double> cov(covariance); // reads the lower triangle
+ * Matrix<double> x = cov.solve(b);
+ */
+template <typename T>
+class SymmetricMatrix
+{
+private:
+    int m_n;
+    std::vector<T> m_data;
+
+    static std::size_t rowOffset(int i) { return static_cast<std::size_t>(i) * (i + 1) / 2; }
+
+    T at(int i, int j) const { return i >= j ? m_data[rowOffset(i) + j] : m_data[rowOffset(j) + i]; }
+
+    /**
+     * @brief Overwrites a packed copy of the matrix with its Cholesky factor L (A = L * L^T),
+     * using the same packed layout.
+     * @return false if the matrix is not positive definite.
+     */
+    static bool choleskyPacked(int n, T* l) {
+        for (int i = 0; i < n; i++) {
+            T* row_i = l + rowOffset(i);
+            for (int j = 0; j <= i; j++) {
+                const T* row_j = l + rowOffset(j);
+                const T s = row_i[j] - matrixlib::detail::dotSpan(row_i, row_j, j);
+                if (j < i) {
+                    row_i[j] = s / row_j[j];
+                } else if (s > T{} && std::isfinite(s)) {
+                    row_i[i] = std::sqrt(s);
+                } else {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Solves L * L^T * X = B in place with a packed factor L; B is n x k with row stride ldb.
+     */
+    static void choleskySolvePacked(int n, const T* l, int k, T* b, std::ptrdiff_t ldb) {
+        for (int i = 0; i < n; i++) {
+            const T* row_l = l + rowOffset(i);
+            T* bi = b + i * ldb;
+            for (int p = 0; p < i; p++) {
+                const T lip = row_l[p];
+                const T* bp = b + p * ldb;
+                for (int c = 0; c < k; c++) {
+                    bi[c] -= lip * bp[c];
+                }
+            }
+            for (int c = 0; c < k; c++) {
+                bi[c] /= row_l[i];
+            }
+        }
+        //L^T is walked by rows of L: once x_i is known, it is removed from every earlier row
+        for (int i = n - 1; i >= 0; i--) {
+            const T* row_l = l + rowOffset(i);
+            T* bi = b + i * ldb;
+            for (int c = 0; c < k; c++) {
+                bi[c] /= row_l[i];
+            }
+            for (int p = 0; p < i; p++) {
+                const T lip = row_l[p];
+                T* bp = b + p * ldb;
+                for (int c = 0; c < k; c++) {
+                    bp[c] -= lip * bi[c];
+                }
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an all-zero symmetric matrix of size n x n.
+     * @throws std::invalid_argument if n is not positive.
+     * @note Example: SymmetricMatrix<double> s(1000);
+     */
+    explicit SymmetricMatrix(int n) : m_n(n) {
+        if (n <= 0) {
+            throw std::invalid_argument("Size must be positive.\n");
+        }
+        m_data.assign(rowOffset(n), T{});
+    }
+
+    /**
+     * @brief Packs a dense square matrix. Only its lower triangle is read.
+     * @throws std::invalid_argument if rows != columns.
+     * @note Example: SymmetricMatrix<double> s(dense);
+     */
+    template <typename Alloc>
+    explicit SymmetricMatrix(const Matrix<T, Alloc>& dense) : m_n(dense.getRows()) {
+        if (dense.getRows() != dense.getCols()) {
+            throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
+        }
+        m_data.resize(rowOffset(m_n));
+        for (int i = 0; i < m_n; i++) {
+            std::copy(dense.rowData(i), dense.rowData(i) + i + 1, m_data.data() + rowOffset(i));
+        }
+    }
+
+    int getRows() const { return m_n; }
+    int getCols() const { return m_n; }
+
+    /**
+     * @brief Packed lower triangle, row by row.
+     */
+    const std::vector<T>& data() const { return m_data; }
+
+    /**
+     * @brief Retrieves a single element; (i, j) and (j, i) are the same stored value.
+     * @throws std::invalid_argument if indices are out of bounds.
+     * @note Example: double v = s.getValue(3, 4);
+     */
+    T getValue(int row, int col) const {
+        if (row < 0 || row >= m_n || col < 0 || col >= m_n) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        return at(row, col);
+    }
+
+    /**
+     * @brief Sets element (row, col) and, with it, (col, row).
+     * @throws std::invalid_argument if indices are out of bounds.
+     * @note Example: s.setValue(3, 4, 2.5);
+     */
+    void setValue(int row, int col, T value) {
+        if (row < 0 || row >= m_n || col < 0 || col >= m_n) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        if (row < col) {
+            std::swap(row, col);
+        }
+        m_data[rowOffset(row) + col] = value;
+    }
+
+    /**
+     * @brief Expands to a dense Square_Matrix with both triangles filled.
+     * @note Example: Square_Matrix<double> d = s.toDense();
+     */
+    Square_Matrix<T> toDense() const {
+        Square_Matrix<T> dense(m_n);
+        for (int i = 0; i < m_n; i++) {
+            const T* row = m_data.data() + rowOffset(i);
+            for (int j = 0; j <= i; j++) {
+                dense(i, j) = row[j];
+                dense(j, i) = row[j];
+            }
+        }
+        return dense;
+    }
+
+    /**
+     * @brief Symmetric matrix times dense matrix.
+     * Each thread owns a block of output rows. Packed rows inside the block are scattered into
+     * both output rows an element touches; packed rows below it contribute their contiguous
+     * segment over the block's columns. No column of the triangle is walked with a stride, and no
+     * two threads write the same output row.
+     * @throws std::invalid_argument if b does not have n rows.
+     * @note Example: Matrix<double> c = s.multiply(dense);
+     */
+    template <typename Alloc>
+    Matrix<T, Alloc> multiply(const Matrix<T, Alloc>& b) const {
+        if (b.getRows() != m_n) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        const int k = b.getCols();
+        Matrix<T, Alloc> c(m_n, k);
+        //Output rows of a block stay cache resident while the packed rows below it stream past
+        const int block = std::max(16, static_cast<int>(32768 / (static_cast<std::size_t>(std::max(k, 1)) * sizeof(T))));
+        matrixlib::parallelRows(m_n, static_cast<long long>(m_n) * m_n * k, [&](int row_begin, int row_end) {
+            for (int block_begin = row_begin; block_begin < row_end; block_begin += block) {
+                const int block_end = std::min(row_end, block_begin + block);
+                for (int i = block_begin; i < m_n; i++) {
+                    const T* row = m_data.data() + rowOffset(i);
+                    const T* bi = b.rowData(i);
+                    if (i >= block_end) {
+                        //Row i lies below the block: its elements in the block's columns are (p, i) entries
+                        for (int p = block_begin; p < block_end; p++) {
+                            const T a = row[p];
+                            T* cp = c.rowData(p);
+                            for (int j = 0; j < k; j++) {
+                                cp[j] += a * bi[j];
+                            }
+                        }
+                        continue;
+                    }
+                    T* ci = c.rowData(i);
+                    for (int p = 0; p < block_begin; p++) {
+                        const T a = row[p];
+                        const T* bp = b.rowData(p);
+                        for (int j = 0; j < k; j++) {
+                            ci[j] += a * bp[j];
+                        }
+                    }
+                    //(p, i) with p in the block: one read serves both positions
+                    for (int p = block_begin; p < i; p++) {
+                        const T a = row[p];
+                        const T* bp = b.rowData(p);
+                        T* cp = c.rowData(p);
+                        for (int j = 0; j < k; j++) {
+                            ci[j] += a * bp[j];
+                            cp[j] += a * bi[j];
+                        }
+                    }
+                    const T a = row[i];
+                    for (int j = 0; j < k; j++) {
+                        ci[j] += a * bi[j];
+                    }
+                }
+            }
+        });
+        return c;
+    }
+
+    /**
+     * @brief Symmetric matrix times vector.
+     * @throws std::invalid_argument if x.size() != n.
+     * @note Example: std::vector<double> y = s.multiply(x);
+     */
+    std::vector<T> multiply(const std::vector<T>& x) const {
+        if (static_cast<int>(x.size()) != m_n) {
+            throw std::invalid_argument("Vector length must be equal to the number of columns.\n");
+        }
+        //One pass over the packed triangle: each off-diagonal element feeds both y_i and y_j
+        std::vector<T> y(m_n);
+        for (int i = 0; i < m_n; i++) {
+            const T* row = m_data.data() + rowOffset(i);
+            const T xi = x[i];
+            T sum{};
+            for (int j = 0; j < i; j++) {
+                sum += row[j] * x[j];
+                y[j] += row[j] * xi;
+            }
+            y[i] += sum + row[i] * xi;
+        }
+        return y;
+    }
+
+    /**
+     * @brief Whether the matrix is positive definite (a packed Cholesky factorization succeeds).
+     * @note Example: if (cov.isPositiveDefinite()) { ... }
+     */
+    bool isPositiveDefinite() const
+        requires std::is_floating_point_v<T>
+    {
+        std::vector<T> l(m_data);
+        return choleskyPacked(m_n, l.data());
+    }
+
+    /**
+     * @brief Calculates the determinant: the squared product of the Cholesky diagonal for a
+     * positive definite matrix, a dense LU otherwise.
+     * @note Example: double det = s.determinant();
+     */
+    T determinant() const
+        requires std::is_floating_point_v<T>
+    {
+        std::vector<T> l(m_data);
+        if (!choleskyPacked(m_n, l.data())) {
+            return toDense().determinant();
+        }
+        T det = static_cast<T>(1);
+        for (int i = 0; i < m_n; i++) {
+            det *= l[rowOffset(i) + i];
+        }
+        return det * det;
+    }
+
+    /**
+     * @brief Solves A * X = B for all columns of B.
+     * Uses the packed Cholesky factorization when A is positive definite (covariance and
+     * normal-equation matrices), and a dense LU factorization otherwise.
+     * @param b Right-hand sides (n x k).
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if sizes do not match or the matrix is singular.
+     * @note Example: Matrix<double> x = s.solve(b);
+     */
+    template <typename Alloc>
+        requires std::is_floating_point_v<T>
+    Matrix<T, Alloc> solve(const Matrix<T, Alloc>& b) const {
+        if (b.getRows() != m_n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        std::vector<T> l(m_data);
+        if (!choleskyPacked(m_n, l.data())) {
+            return toDense().solve(b);
+        }
+        Matrix<T, Alloc> x(b);
+        choleskySolvePacked(m_n, l.data(), x.getCols(), x.rowData(0), x.getStride());
+        return x;
+    }
+
+    /**
+     * @brief Solves A * x = b for a single right-hand side vector.
+     * @throws std::invalid_argument if sizes do not match or the matrix is singular.
+     * @note Example: std::vector<double> x = s.solve({1.0, 2.0, 3.0});
+     */
+    std::vector<T> solve(const std::vector<T>& b) const
+        requires std::is_floating_point_v<T>
+    {
+        if (static_cast<int>(b.size()) != m_n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        std::vector<T> l(m_data);
+        if (!choleskyPacked(m_n, l.data())) {
+            return toDense().solve(b);
+        }
+        std::vector<T> x(b);
+        choleskySolvePacked(m_n, l.data(), 1, x.data(), 1);
+        return x;
+    }
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include "Gemm.hpp"
+#include "ScratchArena.hpp"
+#include "ThreadPool.hpp"
+#include "Transpose.hpp"
+#include "TriangularSolve.hpp"
+
+/**
+ * @file Syrk.hpp
+ * @brief Symmetric rank-k update (SYRK): C = alpha * A * A^T + beta * C on one triangle of C.
+ *
+ * The result is symmetric, so only the selected triangle is computed, which is about half the
+ * work of a general product. The triangle is cut into block columns (lower) or block rows
+ * (upper): everything off the diagonal is one GEMM per block, and each diagonal block is formed
+ * in scratch memory and merged into its triangle, so the other triangle of C is never touched.
+ */
+namespace matrixlib {
+
+namespace detail {
+
+inline constexpr int syrk_block = 256;
+
+/**
+ * @brief Copies the from triangle of the n x n matrix at c onto the other triangle.
+ */
+template <typename T>
+void mirrorTriangle(Triangle from, int n, T* c, std::ptrdiff_t ldc) {
+    const int block = syrk_block;
+    const int blocks = (n + block - 1) / block;
+    parallelRows(blocks, static_cast<long long>(n) * n / 2, [&](int block_begin, int block_end) {
+        for (int bi = block_begin; bi < block_end; bi++) {
+            const int r0 = bi * block;
+            const int rows = std::min(block, n - r0);
+            for (int r = r0; r < r0 + rows; r++) {
+                for (int col = r0; col < r; col++) {
+                    if (from == Triangle::Upper) {
+                        c[r * ldc + col] = c[col * ldc + r];
+                    } else {
+                        c[col * ldc + r] = c[r * ldc + col];
+                    }
+                }
+            }
+            //The strip beside the diagonal block is the transpose of the strip below it
+            const int rest = n - r0 - rows;
+            if (rest == 0) {
+                continue;
+            }
+            T* right = c + r0 * ldc + r0 + rows;
+            T* below = c + (r0 + rows) * ldc + r0;
+            if (from == Triangle::Upper) {
+                transposeRecursive(rows, rest, right, ldc, below, ldc);
+            } else {
+                transposeRecursive(rest, rows, below, ldc, right, ldc);
+            }
+        }
+    });
+}
+
+} // namespace detail
+
+/**
+ * @brief Symmetric rank-k update of one triangle: C = alpha * A * A^T + beta * C.
+ * A is n x k with element (i, p) at a[i * rsA + p * csA], so C = alpha * A^T * A + beta * C is
+ * computed by passing A with its strides swapped. Only the uplo triangle of C (diagonal
+ * included) is read and written. When beta is zero C is not read, so it may hold garbage.
+ * C must not alias A.
+ * @param uplo Triangle of C that is updated.
+ * @note Example: syrk(Triangle::Lower, n, k, -1.0, L21, ld, 1, 1.0, A22, ld);
+ */
+template <typename T>
+void syrk(Triangle uplo, int n, int k, T alpha, const T* a, std::ptrdiff_t rsA, std::ptrdiff_t csA,
+          T beta, T* c, std::ptrdiff_t ldc) {
+    if (n <= 0) {
+        return;
+    }
+    const int block = detail::syrk_block;
+    ScratchScope scope;
+    T* diag = scope.allocate<T>(static_cast<std::size_t>(block) * block);
+    for (int b0 = 0; b0 < n; b0 += block) {
+        const int bw = std::min(block, n - b0);
+        const int rest = n - b0 - bw;
+        const T* a_block = a + b0 * rsA;
+        const T* a_rest = a + (b0 + bw) * rsA;
+
+        //Diagonal block into scratch, then merged into the referenced triangle only
+        gemm<T>(bw, bw, k, alpha, a_block, rsA, csA, a_block, csA, rsA, static_cast<T>(0), diag, bw);
+        for (int i = 0; i < bw; i++) {
+            T* c_row = c + (b0 + i) * ldc + b0;
+            const T* d_row = diag + i * bw;
+            const int j_begin = (uplo == Triangle::Lower) ? 0 : i;
+            const int j_end = (uplo == Triangle::Lower) ? i + 1 : bw;
+            for (int j = j_begin; j < j_end; j++) {
+                c_row[j] = (beta == static_cast<T>(0)) ? d_row[j] : beta * c_row[j] + d_row[j];
+            }
+        }
+        if (rest == 0) {
+            continue;
+        }
+        if (uplo == Triangle::Lower) {
+            //C[b0+bw:n, b0:b0+bw] = alpha * A[b0+bw:n, :] * A[b0:b0+bw, :]^T + beta * C
+            gemm<T>(rest, bw, k, alpha, a_rest, rsA, csA, a_block, csA, rsA,
+                    beta, c + (b0 + bw) * ldc + b0, ldc);
+        } else {
+            //C[b0:b0+bw, b0+bw:n] = alpha * A[b0:b0+bw, :] * A[b0+bw:n, :]^T + beta * C
+            gemm<T>(bw, rest, k, alpha, a_block, rsA, csA, a_rest, csA, rsA,
+                    beta, c + b0 * ldc + b0 + bw, ldc);
+        }
+    }
+}
+
+} // namespace matrixlib
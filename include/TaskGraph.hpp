@@ -0,0 +1,670 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Matrix.hpp"
+#include "LUFactorization.hpp"
+#include "ScratchArena.hpp"
+#include "ThreadPool.hpp"
+#include "Transpose.hpp"
+
+/**
+ * @class TaskGraph
+ * @brief Records a DAG of matrix operations and evaluates it asynchronously on the shared ThreadPool.
+ * Recording (input(), multiply(), add(), ...) only builds the graph and checks shapes. When the
+ * graph is launched it is first rewritten:
+ * - a product whose only consumer is an addition or subtraction is fused into it as one GEMM
+ *   accumulating into the other operand (C = beta * D + alpha * A * B);
+ * - chains of additions, subtractions and scalings whose intermediates have no other consumer
+ *   collapse into one node evaluated row by row, so every intermediate row stays in L1 instead of
+ *   being written to and read back from memory;
+ * - nodes that no requested output depends on are dropped.
+ * Every node then runs on the pool as soon as its inputs are ready, so independent branches run
+ * concurrently. The buffer of an intermediate is recycled once its last consumer has finished:
+ * a consumer that is its only reader writes its result into it in place, otherwise it goes to a
+ * free list that later nodes of the same shape draw from.
+ * Results are delivered through futures obtained with output(). An exception thrown by a node
+ * (a singular matrix, an allocation failure) is passed on to every node depending on it and
+ * rethrown by the futures that lead to it; unrelated outputs are still computed.
+ * @note Input matrices are referenced, not copied: they must stay alive and unchanged until the
+ * graph has finished. A graph is evaluated once.
+ * @note Example:
+ * TaskGraph<double> g;
+ * auto a = g.input(ma), b = g.input(mb), c = g.input(mc);
+ * std::future<Matrix<double>> r = g.output(g.multiply(g.inverse(g.add(g.multiply(a, b), c)), b));
+ * g.run();
+ * Matrix<double> result = r.get();
+ */
+template <typename T>
+class TaskGraph
+{
+public:
+    /**
+     * @brief Handle to the result of a recorded operation.
+     */
+    class Value {
+    private:
+        friend class TaskGraph;
+        int m_id = -1;
+        explicit Value(int id) : m_id(id) {}
+
+    public:
+        Value() = default;
+    };
+
+private:
+    enum class Kind {
+        Input,
+        Multiply,
+        Add,
+        Subtract,
+        Scale,
+        Transpose,
+        Inverse,
+        Solve,
+        MultiplyAccumulate, //beta * inputs[2] + alpha * inputs[0] * inputs[1], created by fusion
+        ElementWise         //Fused chain of Add, Subtract and Scale, created by fusion
+    };
+
+    /**
+     * @brief One step of a fused element-wise program, evaluated on a stack of rows.
+     * Input pushes row r of leaves[leaf]; Add and Subtract combine the two top rows; Scale
+     * multiplies the top row by scalar.
+     */
+    struct Instruction {
+        Kind op;
+        int leaf;
+        T scalar;
+    };
+
+    struct Node {
+        Kind kind = Kind::Input;
+        int rows = 0;
+        int cols = 0;
+        std::vector<int> inputs;
+        T scalar = static_cast<T>(1);
+        const Matrix<T>* external = nullptr;
+        bool is_output = false;
+
+        //Set when the graph is compiled
+        bool fused_away = false;    //Evaluated inside its only consumer
+        bool live = false;          //Some output depends on it
+        T alpha = static_cast<T>(1);
+        T beta = static_cast<T>(1);
+        std::vector<Instruction> program;
+        std::vector<int> leaves;
+        int stack_depth = 0;
+        std::vector<int> deps;      //Distinct nodes read while executing
+        std::vector<int> consumers; //Distinct live nodes reading this one
+        int steal = -1;             //Dependency whose buffer receives the result
+
+        //Runtime state
+        std::atomic<int> pending{0};
+        std::atomic<int> users_left{0};
+        Matrix<T> value{0, 0};
+        std::exception_ptr error;
+        std::promise<Matrix<T>> promise;
+    };
+
+    std::vector<std::unique_ptr<Node>> m_nodes;
+    std::mutex m_free_mutex;
+    std::vector<Matrix<T>> m_free;
+    std::atomic<int> m_remaining{0};
+    std::promise<void> m_done;
+    std::future<void> m_finished;
+    bool m_started = false;
+
+    Node& node(Value v) {
+        if (v.m_id < 0 || v.m_id >= static_cast<int>(m_nodes.size())) {
+            throw std::invalid_argument("Value does not belong to this task graph.\n");
+        }
+        return *m_nodes[v.m_id];
+    }
+
+    Value addNode(Kind kind, int rows, int cols, std::vector<int> inputs, T scalar = static_cast<T>(1)) {
+        if (m_started) {
+            throw std::logic_error("Cannot record into a task graph that has been launched.\n");
+        }
+        auto n = std::make_unique<Node>();
+        n->kind = kind;
+        n->rows = rows;
+        n->cols = cols;
+        n->inputs = std::move(inputs);
+        n->scalar = scalar;
+        m_nodes.push_back(std::move(n));
+        return Value(static_cast<int>(m_nodes.size()) - 1);
+    }
+
+    const Matrix<T>& matrixOf(int id) const {
+        const Node& n = *m_nodes[id];
+        return n.kind == Kind::Input ? *n.external : n.value;
+    }
+
+    static bool isElementWise(Kind kind) {
+        return kind == Kind::Add || kind == Kind::Subtract || kind == Kind::Scale;
+    }
+
+    /**
+     * @brief Whether id is an intermediate that only consumer reads, so consumer may take its buffer.
+     */
+    bool isPrivateTo(int id, int consumer) const {
+        const Node& n = *m_nodes[id];
+        return n.kind != Kind::Input && !n.is_output && n.consumers.size() == 1 && n.consumers[0] == consumer;
+    }
+
+    /**
+     * @brief Appends the program of node id to target, inlining element-wise inputs used only there.
+     * @return Stack depth reached by the appended instructions.
+     */
+    int emitProgram(int id, Node& target, const std::vector<int>& uses, int depth) {
+        const Node& n = *m_nodes[id];
+        int deepest = depth;
+        int top = depth;
+        for (int input : n.inputs) {
+            Node& in = *m_nodes[input];
+            if (isElementWise(in.kind) && uses[input] == 1 && !in.is_output) {
+                in.fused_away = true;
+                deepest = std::max(deepest, emitProgram(input, target, uses, top));
+            } else {
+                target.leaves.push_back(input);
+                target.program.push_back({Kind::Input, static_cast<int>(target.leaves.size()) - 1, T{}});
+                deepest = std::max(deepest, top + 1);
+            }
+            top++;
+        }
+        target.program.push_back({n.kind, -1, n.scalar});
+        return deepest;
+    }
+
+    /**
+     * @brief Fuses nodes, drops dead ones and links the remaining nodes to each other.
+     */
+    void compile() {
+        const int count = static_cast<int>(m_nodes.size());
+        std::vector<int> uses(count, 0);
+        for (const auto& n : m_nodes) {
+            for (int input : n->inputs) {
+                uses[input]++;
+            }
+        }
+
+        //A * B + D, D + A * B, A * B - D and D - A * B become one accumulating GEMM
+        for (int id = 0; id < count; id++) {
+            Node& n = *m_nodes[id];
+            if (n.kind != Kind::Add && n.kind != Kind::Subtract) {
+                continue;
+            }
+            for (int side = 0; side < 2; side++) {
+                const int product_id = n.inputs[side];
+                Node& product = *m_nodes[product_id];
+                if (product.kind != Kind::Multiply || uses[product_id] != 1 || product.is_output) {
+                    continue;
+                }
+                const bool subtract = n.kind == Kind::Subtract;
+                product.fused_away = true;
+                n.alpha = (subtract && side == 1) ? static_cast<T>(-1) : static_cast<T>(1);
+                n.beta = (subtract && side == 0) ? static_cast<T>(-1) : static_cast<T>(1);
+                n.kind = Kind::MultiplyAccumulate;
+                n.inputs = {product.inputs[0], product.inputs[1], n.inputs[1 - side]};
+                break;
+            }
+        }
+        //Inputs always precede their consumers, so walking backwards reaches each chain at its end
+        for (int id = count - 1; id >= 0; id--) {
+            Node& n = *m_nodes[id];
+            if (!isElementWise(n.kind) || n.fused_away) {
+                continue;
+            }
+            n.stack_depth = emitProgram(id, n, uses, 0);
+            n.kind = Kind::ElementWise;
+        }
+
+        for (int id = 0; id < count; id++) {
+            Node& n = *m_nodes[id];
+            n.deps = n.kind == Kind::ElementWise ? n.leaves : n.inputs;
+            std::sort(n.deps.begin(), n.deps.end());
+            n.deps.erase(std::unique(n.deps.begin(), n.deps.end()), n.deps.end());
+        }
+        for (int id = count - 1; id >= 0; id--) {
+            Node& n = *m_nodes[id];
+            n.live = n.live || (n.is_output && !n.fused_away);
+            if (!n.live) {
+                continue;
+            }
+            for (int dep : n.deps) {
+                m_nodes[dep]->live = true;
+                m_nodes[dep]->consumers.push_back(id);
+            }
+        }
+
+        for (int id = 0; id < count; id++) {
+            Node& n = *m_nodes[id];
+            if (!n.live || n.kind == Kind::Input) {
+                continue;
+            }
+            if (n.kind == Kind::MultiplyAccumulate) {
+                const int addend = n.inputs[2];
+                if (addend != n.inputs[0] && addend != n.inputs[1] && isPrivateTo(addend, id)) {
+                    n.steal = addend;
+                }
+            } else if (n.kind == Kind::ElementWise) {
+                for (int leaf : n.deps) {
+                    if (isPrivateTo(leaf, id)) {
+                        n.steal = leaf;
+                        break;
+                    }
+                }
+            } else if (n.kind == Kind::Transpose) {
+                if (n.rows == n.cols && isPrivateTo(n.inputs[0], id)) {
+                    n.steal = n.inputs[0];
+                }
+            } else if (n.kind == Kind::Solve) {
+                if (n.inputs[1] != n.inputs[0] && isPrivateTo(n.inputs[1], id)) {
+                    n.steal = n.inputs[1];
+                }
+            }
+            int unfinished = 0;
+            for (int dep : n.deps) {
+                unfinished += m_nodes[dep]->kind != Kind::Input;
+            }
+            n.pending.store(unfinished, std::memory_order_relaxed);
+            n.users_left.store(static_cast<int>(n.consumers.size()), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Takes a released buffer of the given shape, or allocates a new one.
+     */
+    Matrix<T> acquire(int rows, int cols) {
+        {
+            std::lock_guard<std::mutex> lock(m_free_mutex);
+            for (std::size_t i = 0; i < m_free.size(); i++) {
+                if (m_free[i].getRows() == rows && m_free[i].getCols() == cols) {
+                    Matrix<T> buffer = std::move(m_free[i]);
+                    m_free[i] = std::move(m_free.back());
+                    m_free.pop_back();
+                    return buffer;
+                }
+            }
+        }
+        return Matrix<T>(rows, cols);
+    }
+
+    /**
+     * @brief Called once nothing reads the node any more: delivers or recycles its value.
+     */
+    void release(Node& n) {
+        if (n.is_output) {
+            if (n.error) {
+                n.promise.set_exception(n.error);
+            } else {
+                n.promise.set_value(std::move(n.value));
+            }
+        } else if (n.value.getRows() > 0 && n.value.getCols() > 0) {
+            std::lock_guard<std::mutex> lock(m_free_mutex);
+            m_free.push_back(std::move(n.value));
+        }
+    }
+
+    /**
+     * @brief Computes the value of a node whose dependencies have all finished.
+     */
+    void compute(Node& n) {
+        if (n.steal >= 0) {
+            n.value = std::move(m_nodes[n.steal]->value);
+        } else {
+            n.value = acquire(n.rows, n.cols);
+        }
+        Matrix<T>& out = n.value;
+
+        switch (n.kind) {
+        case Kind::Multiply:
+            out.multiplyAdd(static_cast<T>(1), matrixOf(n.inputs[0]), matrixlib::Op::NoTrans,
+                            matrixOf(n.inputs[1]), matrixlib::Op::NoTrans, static_cast<T>(0));
+            break;
+        case Kind::MultiplyAccumulate:
+            if (n.steal < 0) {
+                const Matrix<T>& addend = matrixOf(n.inputs[2]);
+                for (int r = 0; r < n.rows; r++) {
+                    std::copy(addend.rowData(r), addend.rowData(r) + n.cols, out.rowData(r));
+                }
+            }
+            out.multiplyAdd(n.alpha, matrixOf(n.inputs[0]), matrixlib::Op::NoTrans,
+                            matrixOf(n.inputs[1]), matrixlib::Op::NoTrans, n.beta);
+            break;
+        case Kind::ElementWise:
+            evaluateProgram(n);
+            break;
+        case Kind::Transpose: {
+            if (n.steal >= 0) {
+                matrixlib::transposeInPlace(n.rows, out.rowData(0), out.getStride());
+            } else {
+                const Matrix<T>& src = matrixOf(n.inputs[0]);
+                matrixlib::transpose(src.getRows(), src.getCols(), src.rowData(0), src.getStride(),
+                                     out.rowData(0), out.getStride());
+            }
+            break;
+        }
+        case Kind::Inverse: {
+            matrixlib::ScratchScope scope;
+            LU_Factorization<T, matrixlib::ArenaAllocator<T>> lu{Matrix<T, matrixlib::ArenaAllocator<T>>(matrixOf(n.inputs[0]))};
+            if (lu.isSingular()) {
+                throw std::invalid_argument("Cannot calculate inverse: Determinant is 0.\n");
+            }
+            for (int r = 0; r < n.rows; r++) {
+                std::fill(out.rowData(r), out.rowData(r) + n.cols, static_cast<T>(0));
+                out(r, r) = static_cast<T>(1);
+            }
+            lu.solveInPlace(out);
+            break;
+        }
+        case Kind::Solve: {
+            if (n.steal < 0) {
+                const Matrix<T>& b = matrixOf(n.inputs[1]);
+                for (int r = 0; r < n.rows; r++) {
+                    std::copy(b.rowData(r), b.rowData(r) + n.cols, out.rowData(r));
+                }
+            }
+            matrixlib::ScratchScope scope;
+            LU_Factorization<T, matrixlib::ArenaAllocator<T>> lu{Matrix<T, matrixlib::ArenaAllocator<T>>(matrixOf(n.inputs[0]))};
+            lu.solveInPlace(out);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    /**
+     * @brief Runs a fused element-wise program one row at a time.
+     * Stack slot i of a row lives at temps + i * cols; the last instruction writes the output row.
+     */
+    void evaluateProgram(Node& n) {
+        const int cols = n.cols;
+        const int depth = n.stack_depth;
+        const std::size_t last = n.program.size() - 1;
+        Matrix<T>& out = n.value;
+        //A leaf whose buffer was taken over is read back from the output: row r is only written
+        //by the last instruction, after every read of row r
+        std::vector<const Matrix<T>*> sources(n.leaves.size());
+        for (std::size_t i = 0; i < sources.size(); i++) {
+            sources[i] = (n.leaves[i] == n.steal) ? &out : &matrixOf(n.leaves[i]);
+        }
+        const long long work = static_cast<long long>(n.rows) * cols * static_cast<long long>(n.program.size());
+        matrixlib::parallelRows(n.rows, work, [&](int r0, int r1) {
+            matrixlib::ScratchScope scope;
+            T* temps = scope.allocate<T>(static_cast<std::size_t>(depth) * cols);
+            const T** stack = scope.allocate<const T*>(static_cast<std::size_t>(depth));
+            for (int r = r0; r < r1; r++) {
+                int top = 0;
+                for (std::size_t i = 0; i <= last; i++) {
+                    const Instruction& ins = n.program[i];
+                    if (ins.op == Kind::Input) {
+                        stack[top++] = sources[ins.leaf]->rowData(r);
+                        continue;
+                    }
+                    const int slot = (ins.op == Kind::Scale) ? top - 1 : top - 2;
+                    T* dst = (i == last) ? out.rowData(r) : temps + static_cast<std::size_t>(slot) * cols;
+                    const T* x = stack[slot];
+                    if (ins.op == Kind::Scale) {
+                        for (int c = 0; c < cols; c++) {
+                            dst[c] = x[c] * ins.scalar;
+                        }
+                    } else {
+                        const T* y = stack[top - 1];
+                        if (ins.op == Kind::Add) {
+                            for (int c = 0; c < cols; c++) {
+                                dst[c] = x[c] + y[c];
+                            }
+                        } else {
+                            for (int c = 0; c < cols; c++) {
+                                dst[c] = x[c] - y[c];
+                            }
+                        }
+                        top--;
+                    }
+                    stack[slot] = dst;
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Runs node id and then, on the same thread, one consumer it made ready.
+     */
+    void execute(int id) {
+        matrixlib::ThreadPool& pool = matrixlib::ThreadPool::instance();
+        while (id >= 0) {
+            Node& n = *m_nodes[id];
+            for (int dep : n.deps) {
+                if (!n.error && m_nodes[dep]->error) {
+                    n.error = m_nodes[dep]->error;
+                }
+            }
+            if (!n.error) {
+                try {
+                    compute(n);
+                } catch (...) {
+                    n.error = std::current_exception();
+                }
+            }
+
+            int next = -1;
+            for (int consumer : n.consumers) {
+                if (m_nodes[consumer]->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    if (next < 0) {
+                        next = consumer;
+                    } else {
+                        pool.post([this, consumer] { execute(consumer); });
+                    }
+                }
+            }
+            for (int dep : n.deps) {
+                Node& d = *m_nodes[dep];
+                if (d.kind != Kind::Input && d.users_left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    release(d);
+                }
+            }
+            if (n.consumers.empty()) {
+                release(n);
+            }
+            if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                m_done.set_value();
+            }
+            id = next;
+        }
+    }
+
+public:
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    /**
+     * @brief Waits for a launched graph to finish before releasing it.
+     */
+    ~TaskGraph() {
+        if (m_finished.valid()) {
+            m_finished.wait();
+        }
+    }
+
+    /**
+     * @brief Adds an existing matrix to the graph. It is read in place, not copied.
+     * @note Example: auto a = g.input(ma);
+     */
+    Value input(const Matrix<T>& m) {
+        Value v = addNode(Kind::Input, m.getRows(), m.getCols(), {});
+        m_nodes[v.m_id]->external = &m;
+        return v;
+    }
+
+    /**
+     * @brief Records a * b.
+     * @throws std::invalid_argument if the columns of a do not match the rows of b.
+     */
+    Value multiply(Value a, Value b) {
+        const Node& na = node(a);
+        const Node& nb = node(b);
+        if (na.cols != nb.rows) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        return addNode(Kind::Multiply, na.rows, nb.cols, {a.m_id, b.m_id});
+    }
+
+    /**
+     * @brief Records a + b.
+     * @throws std::invalid_argument if the sizes differ.
+     */
+    Value add(Value a, Value b) {
+        const Node& na = node(a);
+        const Node& nb = node(b);
+        if (na.rows != nb.rows || na.cols != nb.cols) {
+            throw std::invalid_argument("Both matrices must be the same size.\n");
+        }
+        return addNode(Kind::Add, na.rows, na.cols, {a.m_id, b.m_id});
+    }
+
+    /**
+     * @brief Records a - b.
+     * @throws std::invalid_argument if the sizes differ.
+     */
+    Value subtract(Value a, Value b) {
+        const Node& na = node(a);
+        const Node& nb = node(b);
+        if (na.rows != nb.rows || na.cols != nb.cols) {
+            throw std::invalid_argument("Both matrices must be the same size.\n");
+        }
+        return addNode(Kind::Subtract, na.rows, na.cols, {a.m_id, b.m_id});
+    }
+
+    /**
+     * @brief Records a * constant.
+     */
+    Value scale(Value a, T constant) {
+        const Node& na = node(a);
+        return addNode(Kind::Scale, na.rows, na.cols, {a.m_id}, constant);
+    }
+
+    /**
+     * @brief Records the transpose of a.
+     */
+    Value transpose(Value a) {
+        const Node& na = node(a);
+        return addNode(Kind::Transpose, na.cols, na.rows, {a.m_id});
+    }
+
+    /**
+     * @brief Records the inverse of a, computed with an LU factorization.
+     * @throws std::invalid_argument if a is not square. A singular matrix is reported through the
+     * futures depending on it.
+     */
+    Value inverse(Value a) {
+        const Node& na = node(a);
+        if (na.rows != na.cols) {
+            throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
+        }
+        return addNode(Kind::Inverse, na.rows, na.cols, {a.m_id});
+    }
+
+    /**
+     * @brief Records the solution X of a * X = b.
+     * @throws std::invalid_argument if a is not square or b has the wrong number of rows.
+     */
+    Value solve(Value a, Value b) {
+        const Node& na = node(a);
+        const Node& nb = node(b);
+        if (na.rows != na.cols) {
+            throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
+        }
+        if (nb.rows != na.rows) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        return addNode(Kind::Solve, nb.rows, nb.cols, {a.m_id, b.m_id});
+    }
+
+    /**
+     * @brief Requests the value of v once the graph has run. Only requested values are computed.
+     * @return A future receiving the matrix, or the exception that prevented computing it.
+     * @throws std::invalid_argument if v was already requested.
+     * @note Example: std::future<Matrix<double>> f = g.output(v);
+     */
+    std::future<Matrix<T>> output(Value v) {
+        Node& n = node(v);
+        if (m_started) {
+            throw std::logic_error("Cannot record into a task graph that has been launched.\n");
+        }
+        if (n.is_output) {
+            throw std::invalid_argument("Value has already been requested as an output.\n");
+        }
+        n.is_output = true;
+        return n.promise.get_future();
+    }
+
+    /**
+     * @brief Starts evaluating the graph on the shared pool and returns immediately.
+     * @throws std::logic_error if the graph was already launched.
+     */
+    void launch() {
+        if (m_started) {
+            throw std::logic_error("Task graph has already been launched.\n");
+        }
+        m_started = true;
+        compile();
+        m_finished = m_done.get_future();
+
+        std::vector<int> ready;
+        int scheduled = 0;
+        for (int id = 0; id < static_cast<int>(m_nodes.size()); id++) {
+            Node& n = *m_nodes[id];
+            if (!n.live) {
+                continue;
+            }
+            if (n.kind == Kind::Input) {
+                if (n.is_output) {
+                    n.promise.set_value(*n.external);
+                }
+                continue;
+            }
+            scheduled++;
+            if (n.pending.load(std::memory_order_relaxed) == 0) {
+                ready.push_back(id);
+            }
+        }
+        if (scheduled == 0) {
+            m_done.set_value();
+            return;
+        }
+        m_remaining.store(scheduled, std::memory_order_relaxed);
+        matrixlib::ThreadPool& pool = matrixlib::ThreadPool::instance();
+        for (int id : ready) {
+            pool.post([this, id] { execute(id); });
+        }
+    }
+
+    /**
+     * @brief Waits for a launched graph, running pool tasks on this thread meanwhile.
+     */
+    void wait() {
+        if (m_finished.valid()) {
+            matrixlib::ThreadPool::instance().helpWhileWaiting(m_finished);
+            m_finished.get();
+        }
+    }
+
+    /**
+     * @brief Launches the graph and waits for it to finish.
+     * @note Example: g.run(); Matrix<double> r = f.get();
+     */
+    void run() {
+        launch();
+        wait();
+    }
+};
@@ -0,0 +1,200 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "MatrixExpression.hpp"
+#include "ThreadPool.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+/**
+ * @file TextFormat.hpp
+ * @brief Buffered text export of matrices and the matching delimited-text parser helpers.
+ *
+ * Numbers are formatted with std::to_chars into per-block strings instead of going through
+ * iostream manipulators element by element. Large matrices are cut into row blocks that are
+ * formatted in parallel on the shared pool and then handed to the sink strictly in row order.
+ */
+namespace matrixlib {
+
+/**
+ * @brief Text layouts supported by Matrix::exportText().
+ */
+enum class TextFormat {
+    CSV,    //Comma separated, one row per line
+    TSV,    //Tab separated, one row per line
+    Aligned //Right-aligned columns of width 10, as printed by printMatrix()
+};
+
+namespace detail {
+
+inline constexpr int aligned_width = 10;
+
+/**
+ * @brief Appends one element, in fixed notation with the given precision for floating point types.
+ */
+template <typename T>
+void appendNumber(std::string& out, const T& value, int precision) {
+    if constexpr (std::is_floating_point_v<T>) {
+        char local[128];
+        auto [end, ec] = std::to_chars(local, local + sizeof(local), value, std::chars_format::fixed, precision);
+        if (ec == std::errc{}) {
+            out.append(local, end);
+            return;
+        }
+        std::string wide(400 + static_cast<std::size_t>(precision), '\0');
+        auto [wide_end, wide_ec] = std::to_chars(wide.data(), wide.data() + wide.size(), value,
+                                                 std::chars_format::fixed, precision);
+        out.append(wide.data(), wide_end);
+    } else if constexpr (std::is_integral_v<T>) {
+        char local[48];
+        auto [end, ec] = std::to_chars(local, local + sizeof(local), value);
+        out.append(local, end);
+    } else {
+        //Element types without to_chars support fall back to their stream operator
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(precision) << value;
+        out += stream.str();
+    }
+}
+
+/**
+ * @brief Formats rows [row_begin, row_end) of an expression into out.
+ */
+template <typename E>
+void formatRows(const E& expr, int row_begin, int row_end, TextFormat format, int precision, std::string& out) {
+    const int cols = expr.getCols();
+    const char separator = (format == TextFormat::TSV) ? '\t' : ',';
+    for (int r = row_begin; r < row_end; r++) {
+        for (int c = 0; c < cols; c++) {
+            if (format == TextFormat::Aligned) {
+                const std::size_t start = out.size();
+                appendNumber(out, expr.coeff(r, c), precision);
+                const std::size_t length = out.size() - start;
+                if (length < static_cast<std::size_t>(aligned_width)) {
+                    out.insert(start, aligned_width - length, ' ');
+                }
+                out += ' ';
+            } else {
+                if (c > 0) {
+                    out += separator;
+                }
+                appendNumber(out, expr.coeff(r, c), precision);
+            }
+        }
+        out += '\n';
+    }
+}
+
+/**
+ * @brief Formats an expression and passes the text to sink(const char*, std::size_t) in row order.
+ * Row blocks of roughly 64K elements are formatted in parallel, a batch at a time, so memory use
+ * stays bounded by the batch while the sink still sees rows strictly in order.
+ */
+template <typename E, typename Sink>
+void formatText(const E& expr, TextFormat format, int precision, const Sink& sink) {
+    const int rows = expr.getRows();
+    const int cols = std::max(1, expr.getCols());
+    constexpr int block_elements = 1 << 16;
+    const int block_rows = std::max(1, block_elements / cols);
+    const int blocks = (rows + block_rows - 1) / block_rows;
+
+    ThreadPool& pool = ThreadPool::instance();
+    const int batch = (blocks > 1 && pool.size() > 1) ? pool.size() * 2 : 1;
+    std::vector<std::string> buffers(std::min(batch, std::max(1, blocks)));
+    for (int first = 0; first < blocks; first += batch) {
+        const int count = std::min(batch, blocks - first);
+        pool.parallelFor(count, [&](int i) {
+            const int b = first + i;
+            std::string& out = buffers[i];
+            out.clear();
+            formatRows(expr, b * block_rows, std::min(rows, (b + 1) * block_rows), format, precision, out);
+        });
+        for (int i = 0; i < count; i++) {
+            sink(buffers[i].data(), buffers[i].size());
+        }
+    }
+}
+
+/**
+ * @brief Writes all bytes to a file descriptor, retrying on partial writes.
+ * @throws std::runtime_error if the write fails.
+ */
+inline void writeToDescriptor(int fd, const char* text, std::size_t length) {
+#if defined(__unix__) || defined(__APPLE__)
+    while (length > 0) {
+        const ssize_t written = ::write(fd, text, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Cannot write to file descriptor.\n");
+        }
+        text += written;
+        length -= static_cast<std::size_t>(written);
+    }
+#else
+    (void)fd;
+    (void)text;
+    (void)length;
+    throw std::runtime_error("Writing to file descriptors is not supported on this platform.\n");
+#endif
+}
+
+/**
+ * @brief Parses one number from [first, last), skipping surrounding spaces and a leading '+'.
+ * @throws std::invalid_argument if the field is not a number.
+ */
+template <typename T>
+T parseNumber(const char* first, const char* last) {
+    while (first < last && (*first == ' ' || *first == '\t' || *first == '\r')) first++;
+    while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) last--;
+    if (first < last && *first == '+') first++;
+    T value{};
+    auto [end, ec] = std::from_chars(first, last, value);
+    if (ec != std::errc{} || end != last || first == last) {
+        throw std::invalid_argument("Cannot parse value '" + std::string(first, last) + "'.\n");
+    }
+    return value;
+}
+
+/**
+ * @brief Splits text into lines, dropping blank (empty or whitespace-only) lines. Returns [begin, end) offsets of every line.
+ */
+inline std::vector<std::pair<std::size_t, std::size_t>> splitLines(std::string_view text) {
+    std::vector<std::pair<std::size_t, std::size_t>> lines;
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+        std::size_t end = text.find('\n', begin);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::size_t trimmed = end;
+        if (trimmed > begin && text[trimmed - 1] == '\r') {
+            trimmed--;
+        }
+        //Lines of only spaces and tabs count as blank too
+        const std::string_view line = text.substr(begin, trimmed - begin);
+        if (line.find_first_not_of(" \t") != std::string_view::npos) {
+            lines.emplace_back(begin, trimmed);
+        }
+        begin = end + 1;
+    }
+    return lines;
+}
+
+} // namespace detail
+} // namespace matrixlib
@@ -0,0 +1,619 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <future>
+#include <chrono>
+#include <memory>
+#include <exception>
+#include <cstdlib>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * @file ThreadPool.hpp
+ * @brief Library-owned work-stealing thread pool shared by all Matrix kernels.
+ *
+ * Every worker owns a deque: it pushes and pops work at the back (LIFO, cache-warm) while idle
+ * workers steal from the front of other deques (the oldest, largest pieces of work). Parallel loops
+ * are split recursively in halves, so uneven tiles are rebalanced by stealing instead of by a static
+ * partition. Threads that are not pool workers (e.g. the caller of operator*) inject work through a
+ * shared queue and help execute tasks while they wait, which also makes nested parallel loops safe.
+ */
+namespace matrixlib {
+
+/**
+ * @brief Strategy for pinning pool workers to CPUs.
+ */
+enum class Affinity {
+    None,     //Let the OS scheduler place threads
+    Compact,  //Fill the CPUs of one NUMA node before moving on to the next
+    Spread    //Round-robin workers across NUMA nodes
+};
+
+class ThreadPool
+{
+private:
+    /**
+     * @brief Move-only void() callable stored in place.
+     * Unlike std::function, scheduling a task never allocates: every task the pool creates
+     * (a range split, a submitted job) fits in the inline storage, which is checked at compile time.
+     */
+    class Task {
+    private:
+        static constexpr std::size_t capacity = 48;
+        alignas(std::max_align_t) unsigned char m_storage[capacity];
+        void (*m_invoke)(void*) = nullptr;
+        void (*m_relocate)(void* from, void* to) = nullptr; //Move-constructs into to, then destroys from
+        void (*m_destroy)(void*) = nullptr;
+
+        void moveFrom(Task& other) noexcept {
+            if (other.m_invoke) {
+                other.m_relocate(other.m_storage, m_storage);
+                m_invoke = std::exchange(other.m_invoke, nullptr);
+                m_relocate = other.m_relocate;
+                m_destroy = other.m_destroy;
+            }
+        }
+
+    public:
+        Task() = default;
+
+        template <typename F>
+            requires (!std::is_same_v<std::decay_t<F>, Task>)
+        Task(F&& fn) {
+            using Fn = std::decay_t<F>;
+            static_assert(sizeof(Fn) <= capacity && alignof(Fn) <= alignof(std::max_align_t),
+                          "Pool task does not fit in the inline task storage.");
+            static_assert(std::is_nothrow_move_constructible_v<Fn>, "Pool tasks must be nothrow movable.");
+            ::new (static_cast<void*>(m_storage)) Fn(std::forward<F>(fn));
+            m_invoke = [](void* p) { (*static_cast<Fn*>(p))(); };
+            m_relocate = [](void* from, void* to) {
+                ::new (to) Fn(std::move(*static_cast<Fn*>(from)));
+                static_cast<Fn*>(from)->~Fn();
+            };
+            m_destroy = [](void* p) { static_cast<Fn*>(p)->~Fn(); };
+        }
+
+        Task(Task&& other) noexcept { moveFrom(other); }
+
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                reset();
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task() { reset(); }
+
+        void reset() noexcept {
+            if (m_invoke) {
+                m_destroy(m_storage);
+                m_invoke = nullptr;
+            }
+        }
+
+        void operator()() { m_invoke(m_storage); }
+    };
+
+    /**
+     * @brief Double-ended ring buffer of tasks that keeps its capacity.
+     * std::deque frees and reallocates its chunks as the ends move back and forth, which puts the
+     * global allocator on the path of every parallel loop; this queue only allocates when it grows.
+     */
+    class TaskQueue {
+    private:
+        std::vector<Task> m_slots;
+        std::size_t m_head = 0;
+        std::size_t m_size = 0;
+
+        std::size_t slot(std::size_t i) const { return (m_head + i) & (m_slots.size() - 1); }
+
+        void grow() {
+            std::vector<Task> slots(std::max<std::size_t>(64, m_slots.size() * 2));
+            for (std::size_t i = 0; i < m_size; i++) {
+                slots[i] = std::move(m_slots[slot(i)]);
+            }
+            m_slots.swap(slots);
+            m_head = 0;
+        }
+
+    public:
+        bool empty() const { return m_size == 0; }
+
+        void push_back(Task&& task) {
+            if (m_size == m_slots.size()) {
+                grow();
+            }
+            m_slots[slot(m_size)] = std::move(task);
+            m_size++;
+        }
+
+        Task pop_back() {
+            m_size--;
+            return std::move(m_slots[slot(m_size)]);
+        }
+
+        Task pop_front() {
+            Task task = std::move(m_slots[m_head]);
+            m_head = slot(1);
+            m_size--;
+            return task;
+        }
+    };
+
+    /**
+     * @brief Completion counter shared by the tasks of one parallel loop.
+     */
+    struct TaskGroup {
+        std::atomic<int> pending{0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        TaskQueue tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::mutex m_inject_mutex;
+    TaskQueue m_inject;
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_sleep_cv;
+    std::atomic<int> m_queued{0};
+    std::atomic<bool> m_stop{false};
+    Affinity m_affinity = Affinity::None;
+
+    /** Index of the worker running on this thread, -1 for foreign threads. */
+    static int& workerIndex() {
+        thread_local int index = -1;
+        return index;
+    }
+
+    /** Pool the current thread belongs to, nullptr for foreign threads. */
+    static const ThreadPool*& workerPool() {
+        thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    static std::unique_ptr<ThreadPool>& globalSlot() {
+        static std::unique_ptr<ThreadPool> pool;
+        return pool;
+    }
+
+    /** The pool in globalSlot(), published for lock-free reads by instance(). */
+    static std::atomic<ThreadPool*>& globalPool() {
+        static std::atomic<ThreadPool*> pool{nullptr};
+        return pool;
+    }
+
+    static std::mutex& globalMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /**
+     * @brief Parses a Linux cpulist string such as "0-3,8,10-11".
+     */
+    static std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpus;
+        std::size_t pos = 0;
+        while (pos < list.size()) {
+            std::size_t end = list.find(',', pos);
+            if (end == std::string::npos) end = list.size();
+            std::string item = list.substr(pos, end - pos);
+            std::size_t dash = item.find('-');
+            try {
+                if (dash == std::string::npos) {
+                    cpus.push_back(std::stoi(item));
+                } else {
+                    for (int c = std::stoi(item.substr(0, dash)); c <= std::stoi(item.substr(dash + 1)); c++) {
+                        cpus.push_back(c);
+                    }
+                }
+            } catch (const std::exception&) {
+                //Ignore malformed entries (e.g. trailing newline)
+            }
+            pos = end + 1;
+        }
+        return cpus;
+    }
+
+    /**
+     * @brief Orders the CPUs this process may run on according to the affinity strategy.
+     * NUMA nodes are discovered from /sys/devices/system/node; without it all CPUs form one node.
+     */
+    std::vector<int> cpuOrder() const {
+        std::vector<int> order;
+#if defined(__linux__)
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            return order;
+        }
+        std::vector<std::vector<int>> nodes;
+        for (int node = 0; node < 1024; node++) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!file) break;
+            std::string list;
+            std::getline(file, list);
+            std::vector<int> cpus;
+            for (int cpu : parseCpuList(list)) {
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+            }
+            if (!cpus.empty()) nodes.push_back(cpus);
+        }
+        if (nodes.empty()) {
+            nodes.emplace_back();
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &allowed)) nodes.back().push_back(cpu);
+            }
+        }
+        if (m_affinity == Affinity::Compact) {
+            for (const auto& node : nodes) order.insert(order.end(), node.begin(), node.end());
+        } else {
+            for (std::size_t i = 0; order.size() < CPU_SETSIZE; i++) {
+                bool any = false;
+                for (const auto& node : nodes) {
+                    if (i < node.size()) {
+                        order.push_back(node[i]);
+                        any = true;
+                    }
+                }
+                if (!any) break;
+            }
+        }
+#endif
+        return order;
+    }
+
+    void pinCurrentThread(int cpu) const {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+
+    void push(Task task) {
+        int self = workerIndex();
+        if (workerPool() == this && self >= 0) {
+            std::lock_guard<std::mutex> lock(m_workers[self]->mutex);
+            m_workers[self]->tasks.push_back(std::move(task));
+        } else {
+            std::lock_guard<std::mutex> lock(m_inject_mutex);
+            m_inject.push_back(std::move(task));
+        }
+        m_queued.fetch_add(1, std::memory_order_release);
+        {
+            //Pairs with the predicate check in workerLoop so a wakeup cannot be lost
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        }
+        m_sleep_cv.notify_one();
+    }
+
+    /**
+     * @brief Takes one task: own deque (back), then the injection queue, then steals (front).
+     */
+    bool tryPop(Task& task) {
+        int self = (workerPool() == this) ? workerIndex() : -1;
+        if (self >= 0) {
+            std::lock_guard<std::mutex> lock(m_workers[self]->mutex);
+            if (!m_workers[self]->tasks.empty()) {
+                task = m_workers[self]->tasks.pop_back();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_inject_mutex);
+            if (!m_inject.empty()) {
+                task = m_inject.pop_front();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        const int count = static_cast<int>(m_workers.size());
+        const int start = self >= 0 ? self + 1 : 0;
+        for (int i = 0; i < count; i++) {
+            Worker& victim = *m_workers[(start + i) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.pop_front();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int index, int cpu) {
+        workerIndex() = index;
+        workerPool() = this;
+        if (cpu >= 0) {
+            pinCurrentThread(cpu);
+        }
+        Task task;
+        while (true) {
+            if (tryPop(task)) {
+                task();
+                task.reset();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_sleep_cv.wait(lock, [this] {
+                return m_stop.load() || m_queued.load(std::memory_order_acquire) > 0;
+            });
+            if (m_stop.load() && m_queued.load() == 0) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Blocks until every task of the group has finished, executing queued work meanwhile.
+     * @throws The first exception raised by a task of the group.
+     */
+    void wait(TaskGroup& group) {
+        Task task;
+        while (group.pending.load(std::memory_order_acquire) > 0) {
+            if (tryPop(task)) {
+                task();
+                task.reset();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        if (group.error) {
+            std::rethrow_exception(group.error);
+        }
+    }
+
+    /**
+     * @brief Runs fn over [begin, end), repeatedly handing the upper half to the pool.
+     */
+    template <typename F>
+    void splitRange(TaskGroup& group, int begin, int end, int grain, const F& fn) {
+        while (end - begin > grain) {
+            int mid = begin + (end - begin) / 2;
+            group.pending.fetch_add(1, std::memory_order_relaxed);
+            push([this, &group, mid, end, grain, &fn] {
+                runGuarded(group, [&] { splitRange(group, mid, end, grain, fn); });
+                group.pending.fetch_sub(1, std::memory_order_release);
+            });
+            end = mid;
+        }
+        for (int i = begin; i < end; i++) {
+            fn(i);
+        }
+    }
+
+    template <typename F>
+    static void runGuarded(TaskGroup& group, F&& body) {
+        try {
+            body();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(group.error_mutex);
+            if (!group.error) group.error = std::current_exception();
+        }
+    }
+
+public:
+    /**
+     * @brief Creates a pool.
+     * @param threads Total concurrency, counting the calling thread (threads - 1 workers are spawned).
+     * @param affinity CPU pinning strategy for the workers.
+     * @throws std::invalid_argument if threads is not positive.
+     * @note Example: ThreadPool pool(8, Affinity::Compact);
+     */
+    explicit ThreadPool(int threads = defaultThreadCount(), Affinity affinity = Affinity::None) : m_affinity(affinity) {
+        if (threads <= 0) {
+            throw std::invalid_argument("Thread count must be positive.\n");
+        }
+        std::vector<int> cpus = (affinity == Affinity::None) ? std::vector<int>{} : cpuOrder();
+        for (int i = 0; i < threads - 1; i++) {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+        for (int i = 0; i < threads - 1; i++) {
+            int cpu = cpus.empty() ? -1 : cpus[(i + 1) % cpus.size()];
+            m_threads.emplace_back(&ThreadPool::workerLoop, this, i, cpu);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_stop.store(true);
+        }
+        m_sleep_cv.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Default concurrency: MATRIXLIB_NUM_THREADS if set, otherwise the hardware thread count.
+     */
+    static int defaultThreadCount() {
+        if (const char* env = std::getenv("MATRIXLIB_NUM_THREADS")) {
+            int n = std::atoi(env);
+            if (n > 0) return n;
+        }
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * @brief Returns the pool used by all Matrix operations, creating it on first use.
+     * Every operation calls this, so after creation it is a single atomic load; the mutex is
+     * only taken to create or replace the pool.
+     * @note Example: matrixlib::ThreadPool::instance().size();
+     */
+    static ThreadPool& instance() {
+        if (ThreadPool* pool = globalPool().load(std::memory_order_acquire)) {
+            return *pool;
+        }
+        std::lock_guard<std::mutex> lock(globalMutex());
+        auto& slot = globalSlot();
+        if (!slot) {
+            slot = std::make_unique<ThreadPool>();
+            globalPool().store(slot.get(), std::memory_order_release);
+        }
+        return *slot;
+    }
+
+    /**
+     * @brief Replaces the shared pool with a new thread count and pinning strategy.
+     * Must not be called while Matrix operations are running on other threads.
+     * @note Example: matrixlib::ThreadPool::configure(16, matrixlib::Affinity::Spread);
+     */
+    static void configure(int threads, Affinity affinity = Affinity::None) {
+        auto replacement = std::make_unique<ThreadPool>(threads, affinity);
+        std::lock_guard<std::mutex> lock(globalMutex());
+        globalPool().store(replacement.get(), std::memory_order_release);
+        globalSlot().swap(replacement); //The old pool is joined when replacement goes out of scope
+    }
+
+    /**
+     * @brief Total concurrency of the pool (workers plus the calling thread).
+     */
+    int size() const { return static_cast<int>(m_threads.size()) + 1; }
+
+    /**
+     * @brief Calls fn(i) for every i in [0, count), distributing the indices over the pool.
+     * @param count Number of iterations.
+     * @param fn Callable taking the iteration index.
+     * @param grain Iterations below which a range is no longer split.
+     * @throws The first exception thrown by fn, after all iterations have stopped.
+     * @note Example: pool.parallelFor(rows, [&](int r) { process(r); });
+     */
+    template <typename F>
+    void parallelFor(int count, const F& fn, int grain = 1) {
+        if (count <= 0) return;
+        grain = std::max(1, grain);
+        if (m_threads.empty() || count <= grain) {
+            for (int i = 0; i < count; i++) fn(i);
+            return;
+        }
+        TaskGroup group;
+        runGuarded(group, [&] { splitRange(group, 0, count, grain, fn); });
+        wait(group);
+    }
+
+    /**
+     * @brief Splits a rows x cols index space into tiles and calls fn(r0, r1, c0, c1) for each tile.
+     * Tiles are scheduled through the work-stealing deques, so uneven tiles balance automatically.
+     * @note Example: pool.parallelFor2D(m, n, 64, 64, [&](int r0, int r1, int c0, int c1) { ... });
+     */
+    template <typename F>
+    void parallelFor2D(int rows, int cols, int tile_rows, int tile_cols, const F& fn) {
+        if (rows <= 0 || cols <= 0) return;
+        tile_rows = std::max(1, tile_rows);
+        tile_cols = std::max(1, tile_cols);
+        const int tiles_r = (rows + tile_rows - 1) / tile_rows;
+        const int tiles_c = (cols + tile_cols - 1) / tile_cols;
+        parallelFor(tiles_r * tiles_c, [&](int t) {
+            const int r0 = (t / tiles_c) * tile_rows;
+            const int c0 = (t % tiles_c) * tile_cols;
+            fn(r0, std::min(rows, r0 + tile_rows), c0, std::min(cols, c0 + tile_cols));
+        });
+    }
+
+    /**
+     * @brief Schedules a callable on the pool and returns a future for its result.
+     * @note Example: auto f = pool.submit([&] { return a * b; });
+     */
+    template <typename F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<F>> {
+        using R = std::invoke_result_t<F>;
+        auto job = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> result = job->get_future();
+        if (m_threads.empty()) {
+            (*job)();
+        } else {
+            push([job] { (*job)(); });
+        }
+        return result;
+    }
+
+    /**
+     * @brief Schedules a callable on the pool without a future; nothing is allocated.
+     * The callable is stored in the task itself, so it must be small (a few pointers) and
+     * nothrow movable, and it must not throw: there is nobody to receive the exception.
+     * With no worker threads it runs immediately on the calling thread.
+     * @note Example: pool.post([this, id] { runNode(id); });
+     */
+    template <typename F>
+    void post(F&& fn) {
+        if (m_threads.empty()) {
+            fn();
+        } else {
+            push(Task(std::forward<F>(fn)));
+        }
+    }
+
+    /**
+     * @brief Waits for a future while running queued pool tasks on this thread.
+     * Use instead of future::wait() from inside pool tasks to avoid starving the pool.
+     */
+    template <typename R>
+    void helpWhileWaiting(const std::future<R>& future) {
+        Task task;
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (tryPop(task)) {
+                task();
+                task.reset();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+/**
+ * @brief Runs fn(r0, r1) over row blocks in parallel when the work is large enough to pay off.
+ * @param rows Number of rows.
+ * @param work Estimated number of element operations in total.
+ * @param fn Callable taking a half-open row range.
+ */
+template <typename F>
+void parallelRows(int rows, long long work, const F& fn) {
+    constexpr long long min_parallel_work = 1 << 16;
+    ThreadPool& pool = ThreadPool::instance();
+    if (rows <= 1 || work < min_parallel_work || pool.size() == 1) {
+        fn(0, rows);
+        return;
+    }
+    const long long per_row = std::max(1LL, work / rows);
+    const int block = static_cast<int>(std::max(1LL, std::min<long long>(rows, min_parallel_work / 4 / per_row + 1)));
+    const int blocks = (rows + block - 1) / block;
+    pool.parallelFor(blocks, [&](int b) {
+        fn(b * block, std::min(rows, (b + 1) * block));
+    });
+}
+
+} // namespace matrixlib
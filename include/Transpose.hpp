@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include "ThreadPool.hpp"
+
+/**
+ * @file Transpose.hpp
+ * @brief Cache-oblivious physical transposition, out of place and in place.
+ *
+ * The index space is halved along its longer side until a block fits in a few cache lines, so
+ * both the source rows and the destination rows of every leaf stay cached whatever the cache
+ * sizes are. Large matrices are first cut into independent tiles that run on the shared pool,
+ * and each tile is transposed recursively.
+ */
+namespace matrixlib {
+
+namespace detail {
+
+inline constexpr int transpose_leaf = 16;
+inline constexpr int transpose_tile = 256;
+
+/**
+ * @brief dst(c, r) = src(r, c) for a rows x cols block.
+ */
+template <typename T>
+void transposeRecursive(int rows, int cols, const T* src, std::ptrdiff_t lds, T* dst, std::ptrdiff_t ldd) {
+    if (rows <= transpose_leaf && cols <= transpose_leaf) {
+        for (int r = 0; r < rows; r++) {
+            const T* src_row = src + r * lds;
+            for (int c = 0; c < cols; c++) {
+                dst[c * ldd + r] = src_row[c];
+            }
+        }
+    } else if (rows >= cols) {
+        const int half = rows / 2;
+        transposeRecursive(half, cols, src, lds, dst, ldd);
+        transposeRecursive(rows - half, cols, src + half * lds, lds, dst + half, ldd);
+    } else {
+        const int half = cols / 2;
+        transposeRecursive(rows, half, src, lds, dst, ldd);
+        transposeRecursive(rows, cols - half, src + half, lds, dst + half * ldd, ldd);
+    }
+}
+
+/**
+ * @brief Swaps the rows x cols block at a with the transpose of the cols x rows block at b.
+ */
+template <typename T>
+void swapTransposedRecursive(int rows, int cols, T* a, T* b, std::ptrdiff_t ld) {
+    if (rows <= transpose_leaf && cols <= transpose_leaf) {
+        for (int r = 0; r < rows; r++) {
+            T* a_row = a + r * ld;
+            for (int c = 0; c < cols; c++) {
+                std::swap(a_row[c], b[c * ld + r]);
+            }
+        }
+    } else if (rows >= cols) {
+        const int half = rows / 2;
+        swapTransposedRecursive(half, cols, a, b, ld);
+        swapTransposedRecursive(rows - half, cols, a + half * ld, b + half, ld);
+    } else {
+        const int half = cols / 2;
+        swapTransposedRecursive(rows, half, a, b, ld);
+        swapTransposedRecursive(rows, cols - half, a + half, b + half * ld, ld);
+    }
+}
+
+/**
+ * @brief Transposes the n x n block at a in place.
+ */
+template <typename T>
+void transposeInPlaceRecursive(int n, T* a, std::ptrdiff_t ld) {
+    if (n <= transpose_leaf) {
+        for (int r = 0; r < n; r++) {
+            for (int c = r + 1; c < n; c++) {
+                std::swap(a[r * ld + c], a[c * ld + r]);
+            }
+        }
+        return;
+    }
+    const int half = n / 2;
+    transposeInPlaceRecursive(half, a, ld);
+    transposeInPlaceRecursive(n - half, a + half * ld + half, ld);
+    swapTransposedRecursive(half, n - half, a + half, a + half * ld, ld);
+}
+
+} // namespace detail
+
+/**
+ * @brief Writes the transpose of a rows x cols row-major matrix into dst (cols x rows).
+ * @param lds Row stride of src.
+ * @param ldd Row stride of dst.
+ * @note Example: transpose(m, n, A, lda, At, ldat);
+ */
+template <typename T>
+void transpose(int rows, int cols, const T* src, std::ptrdiff_t lds, T* dst, std::ptrdiff_t ldd) {
+    const int tile = detail::transpose_tile;
+    const long long elements = static_cast<long long>(rows) * cols;
+    if (elements < (1 << 16) || ThreadPool::instance().size() == 1) {
+        detail::transposeRecursive(rows, cols, src, lds, dst, ldd);
+        return;
+    }
+    ThreadPool::instance().parallelFor2D(rows, cols, tile, tile, [&](int r0, int r1, int c0, int c1) {
+        detail::transposeRecursive(r1 - r0, c1 - c0, src + r0 * lds + c0, lds, dst + c0 * ldd + r0, ldd);
+    });
+}
+
+/**
+ * @brief Transposes an n x n row-major matrix in place, without extra memory.
+ * @param ld Row stride.
+ * @note Example: transposeInPlace(n, A, lda);
+ */
+template <typename T>
+void transposeInPlace(int n, T* a, std::ptrdiff_t ld) {
+    const int tile = detail::transpose_tile;
+    const int tiles = (n + tile - 1) / tile;
+    if (static_cast<long long>(n) * n < (1 << 16) || tiles == 1 || ThreadPool::instance().size() == 1) {
+        detail::transposeInPlaceRecursive(n, a, ld);
+        return;
+    }
+    //One task per tile pair (ti <= tj) of the upper triangle of tiles
+    ThreadPool::instance().parallelFor(tiles * (tiles + 1) / 2, [&](int pair) {
+        int ti = 0;
+        int remaining = pair;
+        while (remaining >= tiles - ti) {
+            remaining -= tiles - ti;
+            ti++;
+        }
+        const int tj = ti + remaining;
+        const int r0 = ti * tile;
+        const int c0 = tj * tile;
+        const int rows = std::min(n, r0 + tile) - r0;
+        const int cols = std::min(n, c0 + tile) - c0;
+        if (ti == tj) {
+            detail::transposeInPlaceRecursive(rows, a + r0 * ld + r0, ld);
+        } else {
+            detail::swapTransposedRecursive(rows, cols, a + r0 * ld + c0, a + c0 * ld + r0, ld);
+        }
+    });
+}
+
+} // namespace matrixlib
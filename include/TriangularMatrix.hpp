@@ -0,0 +1,256 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "Matrix.hpp"
+#include "SquareMatrix.hpp"
+#include "TriangularSolve.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @class TriangularMatrix
+ * @brief A lower or upper triangular n x n matrix stored packed: only the triangle, row by row,
+ * in n * (n + 1) / 2 elements.
+ * Every stored row is contiguous: row i holds columns 0..i (Lower) or i..n-1 (Upper). Products
+ * only touch the triangle, solves are a single substitution in O(n^2 k), and the determinant is
+ * the product of the diagonal.
+ * @note Example:
+ * TriangularMatrix<double> l(dense, matrixlib::Triangle::Lower);
+ * Matrix<double> x = l.solve(b);
+ */
+template <typename T>
+class TriangularMatrix
+{
+private:
+    int m_n;
+    matrixlib::Triangle m_uplo;
+    std::vector<T> m_data;
+
+    /**
+     * @brief Index of element (i, first stored column of row i) in m_data.
+     */
+    std::size_t rowOffset(int i) const {
+        const std::size_t row = static_cast<std::size_t>(i);
+        //Upper rows hold n, n - 1, ... elements
+        return (m_uplo == matrixlib::Triangle::Lower) ? row * (row + 1) / 2 : row * (2 * static_cast<std::size_t>(m_n) - row + 1) / 2;
+    }
+
+    int firstCol(int i) const { return (m_uplo == matrixlib::Triangle::Lower) ? 0 : i; }
+    int lastCol(int i) const { return (m_uplo == matrixlib::Triangle::Lower) ? i : m_n - 1; }
+
+    /**
+     * @brief Pointer to element (i, 0) as if the row were stored in full; valid for the stored
+     * columns firstCol(i)..lastCol(i) only.
+     */
+    const T* row(int i) const { return m_data.data() + rowOffset(i) - firstCol(i); }
+    T* row(int i) { return m_data.data() + rowOffset(i) - firstCol(i); }
+
+    bool stored(int r, int c) const { return c >= firstCol(r) && c <= lastCol(r); }
+
+    /**
+     * @brief Substitution on B (n x k, row stride ldb), overwritten with the solution.
+     * @throws std::invalid_argument if the diagonal contains a zero.
+     */
+    void solveInPlace(int k, T* b, std::ptrdiff_t ldb) const {
+        for (int i = 0; i < m_n; i++) {
+            if (row(i)[i] == T{}) {
+                throw std::invalid_argument("Cannot solve: matrix is singular.\n");
+            }
+        }
+        const bool lower = m_uplo == matrixlib::Triangle::Lower;
+        for (int step = 0; step < m_n; step++) {
+            const int i = lower ? step : m_n - 1 - step;
+            const T* ai = row(i);
+            T* bi = b + i * ldb;
+            const int p_begin = lower ? 0 : i + 1;
+            const int p_end = lower ? i : m_n;
+            for (int p = p_begin; p < p_end; p++) {
+                const T aip = ai[p];
+                const T* bp = b + p * ldb;
+                for (int c = 0; c < k; c++) {
+                    bi[c] -= aip * bp[c];
+                }
+            }
+            for (int c = 0; c < k; c++) {
+                bi[c] /= ai[i];
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an all-zero triangular matrix of size n x n.
+     * @throws std::invalid_argument if n is not positive.
+     * @note Example: TriangularMatrix<double> u(1000, matrixlib::Triangle::Upper);
+     */
+    TriangularMatrix(int n, matrixlib::Triangle uplo) : m_n(n), m_uplo(uplo) {
+        if (n <= 0) {
+            throw std::invalid_argument("Size must be positive.\n");
+        }
+        m_data.assign(static_cast<std::size_t>(n) * (n + 1) / 2, T{});
+    }
+
+    /**
+     * @brief Packs the selected triangle of a dense square matrix; the other one is not read.
+     * @throws std::invalid_argument if rows != columns.
+     * @note Example: TriangularMatrix<double> l(dense, matrixlib::Triangle::Lower);
+     */
+    template <typename Alloc>
+    TriangularMatrix(const Matrix<T, Alloc>& dense, matrixlib::Triangle uplo) : m_n(dense.getRows()), m_uplo(uplo) {
+        if (dense.getRows() != dense.getCols()) {
+            throw std::invalid_argument("Square Matrix must have equal rows and columns.\n");
+        }
+        m_data.resize(static_cast<std::size_t>(m_n) * (m_n + 1) / 2);
+        for (int i = 0; i < m_n; i++) {
+            std::copy(dense.rowData(i) + firstCol(i), dense.rowData(i) + lastCol(i) + 1, row(i) + firstCol(i));
+        }
+    }
+
+    int getRows() const { return m_n; }
+    int getCols() const { return m_n; }
+    matrixlib::Triangle triangle() const { return m_uplo; }
+
+    /**
+     * @brief Packed triangle, row by row.
+     */
+    const std::vector<T>& data() const { return m_data; }
+
+    /**
+     * @brief Retrieves a single element (zero outside the triangle).
+     * @throws std::invalid_argument if indices are out of bounds.
+     * @note Example: double v = l.getValue(4, 3);
+     */
+    T getValue(int r, int c) const {
+        if (r < 0 || r >= m_n || c < 0 || c >= m_n) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        return stored(r, c) ? row(r)[c] : T{};
+    }
+
+    /**
+     * @brief Sets an element of the stored triangle.
+     * @throws std::invalid_argument if indices are out of bounds or outside the triangle.
+     * @note Example: l.setValue(4, 3, 2.5);
+     */
+    void setValue(int r, int c, T value) {
+        if (r < 0 || r >= m_n || c < 0 || c >= m_n) {
+            throw std::invalid_argument("Index out of bounds.\n");
+        }
+        if (!stored(r, c)) {
+            throw std::invalid_argument("Element is outside the stored triangle.\n");
+        }
+        row(r)[c] = value;
+    }
+
+    /**
+     * @brief Expands to a dense Square_Matrix with zeros outside the triangle.
+     * @note Example: Square_Matrix<double> d = l.toDense();
+     */
+    Square_Matrix<T> toDense() const {
+        Square_Matrix<T> dense(m_n);
+        for (int i = 0; i < m_n; i++) {
+            std::copy(row(i) + firstCol(i), row(i) + lastCol(i) + 1, dense.rowData(i) + firstCol(i));
+        }
+        return dense;
+    }
+
+    /**
+     * @brief Triangular matrix times dense matrix; each output row combines only the rows of b
+     * that meet the stored part of the matching row. Rows run in parallel.
+     * @throws std::invalid_argument if b does not have n rows.
+     * @note Example: Matrix<double> c = l.multiply(dense);
+     */
+    template <typename Alloc>
+    Matrix<T, Alloc> multiply(const Matrix<T, Alloc>& b) const {
+        if (b.getRows() != m_n) {
+            throw std::invalid_argument("Right matrix's row number must be equal to left matrix's columns number.\n");
+        }
+        const int k = b.getCols();
+        Matrix<T, Alloc> c(m_n, k);
+        matrixlib::parallelRows(m_n, static_cast<long long>(m_n) * m_n * k / 2, [&](int row_begin, int row_end) {
+            for (int i = row_begin; i < row_end; i++) {
+                T* ci = c.rowData(i);
+                const T* ai = row(i);
+                for (int p = firstCol(i); p <= lastCol(i); p++) {
+                    const T a = ai[p];
+                    const T* bp = b.rowData(p);
+                    for (int j = 0; j < k; j++) {
+                        ci[j] += a * bp[j];
+                    }
+                }
+            }
+        });
+        return c;
+    }
+
+    /**
+     * @brief Triangular matrix times vector.
+     * @throws std::invalid_argument if x.size() != n.
+     * @note Example: std::vector<double> y = l.multiply(x);
+     */
+    std::vector<T> multiply(const std::vector<T>& x) const {
+        if (static_cast<int>(x.size()) != m_n) {
+            throw std::invalid_argument("Vector length must be equal to the number of columns.\n");
+        }
+        std::vector<T> y(m_n);
+        for (int i = 0; i < m_n; i++) {
+            const T* ai = row(i);
+            T sum{};
+            for (int p = firstCol(i); p <= lastCol(i); p++) {
+                sum += ai[p] * x[p];
+            }
+            y[i] = sum;
+        }
+        return y;
+    }
+
+    /**
+     * @brief Calculates the determinant: the product of the diagonal.
+     * @note Example: double det = l.determinant();
+     */
+    T determinant() const {
+        T det = static_cast<T>(1);
+        for (int i = 0; i < m_n; i++) {
+            det *= row(i)[i];
+        }
+        return det;
+    }
+
+    /**
+     * @brief Solves A * X = B for all columns of B by forward (Lower) or back (Upper) substitution
+     * over the packed rows.
+     * @param b Right-hand sides (n x k).
+     * @return The solution X (n x k).
+     * @throws std::invalid_argument if sizes do not match or the diagonal contains a zero.
+     * @note Example: Matrix<double> x = l.solve(b);
+     */
+    template <typename Alloc>
+        requires std::is_floating_point_v<T>
+    Matrix<T, Alloc> solve(const Matrix<T, Alloc>& b) const {
+        if (b.getRows() != m_n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        Matrix<T, Alloc> x(b);
+        solveInPlace(x.getCols(), x.rowData(0), x.getStride());
+        return x;
+    }
+
+    /**
+     * @brief Solves A * x = b for a single right-hand side vector.
+     * @throws std::invalid_argument if sizes do not match or the diagonal contains a zero.
+     * @note Example: std::vector<double> x = l.solve({1.0, 2.0, 3.0});
+     */
+    std::vector<T> solve(const std::vector<T>& b) const
+        requires std::is_floating_point_v<T>
+    {
+        if (static_cast<int>(b.size()) != m_n) {
+            throw std::invalid_argument("Right-hand side must have as many rows as the matrix.\n");
+        }
+        std::vector<T> x(b);
+        solveInPlace(1, x.data(), 1);
+        return x;
+    }
+
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include "Gemm.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @file TriangularSolve.hpp
+ * @brief Blocked triangular solve with many right-hand sides (TRSM).
+ *
+ * The triangle is processed in diagonal blocks. Each block is solved by substitution, which is
+ * cheap, and its contribution to the remaining rows is removed with one GEMM, which carries
+ * nearly all of the O(n^2 k) work. Substitution inside a block runs over contiguous rows of B,
+ * split into column ranges on the pool when there are many right-hand sides.
+ */
+namespace matrixlib {
+
+/**
+ * @brief Which triangle of a matrix holds the data.
+ */
+enum class Triangle {
+    Lower,
+    Upper
+};
+
+namespace detail {
+
+inline constexpr int trsm_block = 64;
+
+/**
+ * @brief Substitution on the diagonal block [i0, i1) for columns [c0, c1) of B.
+ */
+template <typename T>
+void trsmDiagonalBlock(Triangle uplo, bool unit_diagonal, int i0, int i1, int c0, int c1,
+                       const T* a, std::ptrdiff_t rsA, std::ptrdiff_t csA, T* b, std::ptrdiff_t ldb) {
+    const int step = (uplo == Triangle::Lower) ? 1 : -1;
+    const int first = (uplo == Triangle::Lower) ? i0 : i1 - 1;
+    for (int i = first; i >= i0 && i < i1; i += step) {
+        T* bi = b + i * ldb;
+        const int p_begin = (uplo == Triangle::Lower) ? i0 : i + 1;
+        const int p_end = (uplo == Triangle::Lower) ? i : i1;
+        for (int p = p_begin; p < p_end; p++) {
+            const T aip = a[i * rsA + p * csA];
+            const T* bp = b + p * ldb;
+            for (int c = c0; c < c1; c++) {
+                bi[c] -= aip * bp[c];
+            }
+        }
+        if (!unit_diagonal) {
+            const T diag = a[i * rsA + i * csA];
+            for (int c = c0; c < c1; c++) {
+                bi[c] /= diag;
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Solves A * X = B in place, where A is an n x n triangular matrix and B is n x k.
+ * Element (i, j) of A lives at a[i * rsA + j * csA], so the transpose of a stored triangle is
+ * solved by swapping its strides (the transpose of a lower triangle is an upper triangle).
+ * Only the selected triangle of A is read. B is row-major with row stride ldb and is
+ * overwritten with X. A zero on a non-unit diagonal produces infinities, it is not reported.
+ * @param uplo Triangle of A that is referenced.
+ * @param unit_diagonal Treat the diagonal of A as all ones without reading it.
+ * @note Example: trsm(Triangle::Lower, false, n, k, L, ldl, 1, B, ldb);
+ */
+template <typename T>
+void trsm(Triangle uplo, bool unit_diagonal, int n, int k,
+          const T* a, std::ptrdiff_t rsA, std::ptrdiff_t csA, T* b, std::ptrdiff_t ldb) {
+    if (n <= 0 || k <= 0) {
+        return;
+    }
+    const int nb = detail::trsm_block;
+    const int blocks = (n + nb - 1) / nb;
+    for (int step = 0; step < blocks; step++) {
+        //Lower triangles are walked top-down, upper triangles bottom-up
+        const int block = (uplo == Triangle::Lower) ? step : blocks - 1 - step;
+        const int i0 = block * nb;
+        const int i1 = std::min(n, i0 + nb);
+        const long long work = static_cast<long long>(i1 - i0) * (i1 - i0) * k;
+        parallelRows(k, work, [&](int c0, int c1) {
+            detail::trsmDiagonalBlock(uplo, unit_diagonal, i0, i1, c0, c1, a, rsA, csA, b, ldb);
+        });
+
+        if (uplo == Triangle::Lower && i1 < n) {
+            //B[i1:n] -= A[i1:n, i0:i1] * X[i0:i1]
+            gemm<T>(n - i1, k, i1 - i0, static_cast<T>(-1),
+                    a + i1 * rsA + i0 * csA, rsA, csA,
+                    b + i0 * ldb, ldb, 1,
+                    static_cast<T>(1), b + i1 * ldb, ldb);
+        } else if (uplo == Triangle::Upper && i0 > 0) {
+            //B[0:i0] -= A[0:i0, i0:i1] * X[i0:i1]
+            gemm<T>(i0, k, i1 - i0, static_cast<T>(-1),
+                    a + i0 * csA, rsA, csA,
+                    b + i0 * ldb, ldb, 1,
+                    static_cast<T>(1), b, ldb);
+        }
+    }
+}
+
+} // namespace matrixlib